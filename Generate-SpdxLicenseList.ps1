@@ -38,10 +38,11 @@ function Transform-JsonFile {
     $fileContent = @(
         "// Data downloaded from $Uri",
         "// Generated by Generate-SpdxLicenseList.ps1")
-    $json.$OuterName |
-        Sort-Object -Property $Id -Culture '' |
-        ForEach-Object {
-        $fileContent += "`"$($_.$Id)`","
+    # vcpkg binary searches these lists, so they must be sorted ordinally, ignoring ASCII case
+    $ids = [string[]]($json.$OuterName | ForEach-Object { $_.$Id })
+    [Array]::Sort($ids, [StringComparer]::OrdinalIgnoreCase)
+    $ids | ForEach-Object {
+        $fileContent += "`"$_`","
     }
 
     ($fileContent -join "`n") + "`n" `
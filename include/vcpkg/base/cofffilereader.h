@@ -4,6 +4,7 @@
 
 #include <stdint.h>
 
+#include <string>
 #include <vector>
 
 namespace vcpkg
@@ -40,7 +41,8 @@ namespace vcpkg
 
     MachineType to_machine_type(const uint16_t value);
 
-    MachineType read_dll_machine_type(const ReadFilePointer& fs);
+    // `image` and `archive` are the whole contents of a PE image or a COFF archive, usually a mapping of the file.
+    MachineType read_dll_machine_type(StringView image);
 
-    std::vector<MachineType> read_lib_machine_types(const ReadFilePointer& fs);
+    std::vector<MachineType> read_lib_machine_types(StringView archive);
 }
@@ -10,8 +10,10 @@
 #include <stdio.h>
 #include <string.h>
 
+#include <functional>
 #include <memory>
 #include <system_error>
+#include <utility>
 
 #if defined(_WIN32)
 #define VCPKG_PREFERRED_SEPARATOR "\\"
@@ -202,6 +204,35 @@ namespace vcpkg
         int put(int c) const noexcept { return ::fputc(c, m_fs); }
     };
 
+    // A read-only mapping of the whole contents of a file into memory.
+    struct MappedFile
+    {
+        MappedFile() = default;
+        explicit MappedFile(const Path& file_path, std::error_code& ec) noexcept;
+
+        MappedFile(const MappedFile&) = delete;
+        MappedFile(MappedFile&& other) noexcept
+            : m_data(std::exchange(other.m_data, nullptr)), m_size(std::exchange(other.m_size, 0))
+        {
+        }
+
+        MappedFile& operator=(const MappedFile&) = delete;
+        MappedFile& operator=(MappedFile&& other) noexcept
+        {
+            std::swap(m_data, other.m_data);
+            std::swap(m_size, other.m_size);
+            return *this;
+        }
+
+        StringView contents() const noexcept { return {m_data, m_size}; }
+
+        ~MappedFile();
+
+    private:
+        const char* m_data = nullptr;
+        size_t m_size = 0;
+    };
+
     struct IExclusiveFileLock
     {
         virtual ~IExclusiveFileLock() = default;
@@ -244,6 +275,17 @@ namespace vcpkg
         virtual std::vector<Path> get_regular_files_non_recursive(const Path& dir, std::error_code& ec) const = 0;
         std::vector<Path> get_regular_files_non_recursive(const Path& dir, LineInfo li) const;
 
+        // Calls `visitor` with every entry below `dir` and its type after following symlinks, or FileType::symlink
+        // for a dangling one. Symlinks are never descended into. Subdirectories may be read concurrently, so entries
+        // arrive in no particular order, except that a directory comes before its contents; `visitor` is never called
+        // concurrently. Entries visited before an error are not taken back.
+        virtual void visit_recursive(const Path& dir,
+                                     const std::function<void(const Path&, FileType)>& visitor,
+                                     std::error_code& ec) const = 0;
+        void visit_recursive(const Path& dir,
+                             const std::function<void(const Path&, FileType)>& visitor,
+                             LineInfo li) const;
+
         virtual void write_lines(const Path& file_path, const std::vector<std::string>& lines, std::error_code& ec) = 0;
         void write_lines(const Path& file_path, const std::vector<std::string>& lines, LineInfo li);
 
@@ -324,6 +366,10 @@ namespace vcpkg
         virtual FileType symlink_status(const Path& target, std::error_code& ec) const = 0;
         FileType symlink_status(const Path& target, LineInfo li) const noexcept;
 
+        // the modification time of target, in nanoseconds since an unspecified, platform specific epoch
+        virtual int64_t last_write_time(const Path& target, std::error_code& ec) const = 0;
+        int64_t last_write_time(const Path& target, LineInfo li) const noexcept;
+
         virtual Path absolute(const Path& target, std::error_code& ec) const = 0;
         Path absolute(const Path& target, LineInfo li) const;
 
@@ -364,6 +410,9 @@ namespace vcpkg
 
         virtual WriteFilePointer open_for_write(const Path& file_path, std::error_code& ec) = 0;
         WriteFilePointer open_for_write(const Path& file_path, LineInfo li);
+
+        virtual MappedFile map_for_read(const Path& file_path, std::error_code& ec) const = 0;
+        MappedFile map_for_read(const Path& file_path, LineInfo li) const;
     };
 
     Filesystem& get_real_filesystem();
@@ -2,10 +2,10 @@
 
 #include <vcpkg/base/checks.h>
 #include <vcpkg/base/lineinfo.h>
+#include <vcpkg/base/span.h>
 #include <vcpkg/base/system.print.h>
 
 #include <string>
-#include <unordered_map>
 #include <vector>
 
 namespace vcpkg::Graphs
@@ -22,12 +22,15 @@ namespace vcpkg::Graphs
         FULLY_EXPLORED
     };
 
-    template<class V, class U>
+    // Vertices are identified by indices the provider hands out; they need not be contiguous, but should be small
+    // since the graph keeps a table indexed by them.
+    template<class U>
     struct AdjacencyProvider
     {
-        virtual std::vector<V> adjacency_list(const U& vertex) const = 0;
-        virtual std::string to_string(const V& vertex) const = 0;
-        virtual U load_vertex_data(const V& vertex) const = 0;
+        // Appends the indices of the neighbours of `vertex` to `out`.
+        virtual void append_adjacency_list(size_t vertex, std::vector<size_t>& out) const = 0;
+        virtual std::string to_string(size_t vertex) const = 0;
+        virtual U load_vertex_data(size_t vertex) const = 0;
     };
 
     struct Randomizer
@@ -53,61 +56,130 @@ namespace vcpkg::Graphs
                 }
             }
         }
+    }
 
-        template<class V, class U>
-        void topological_sort_internal(const V& vertex,
-                                       const AdjacencyProvider<V, U>& f,
-                                       std::unordered_map<V, ExplorationStatus>& exploration_status,
-                                       std::vector<U>& sorted,
-                                       Randomizer* randomizer)
+    // The part of a graph reachable from a set of starting vertices, discovered through an AdjacencyProvider and stored
+    // with dense vertex ids: every adjacency list is packed into one edge array (compressed sparse row), so that
+    // walking it touches no hash tables and allocates nothing per vertex. Vertex data is not loaded here.
+    struct CompactGraph
+    {
+        template<class Range, class U>
+        CompactGraph(const Range& starting_vertices, const AdjacencyProvider<U>& f)
         {
-            ExplorationStatus& status = exploration_status[vertex];
-            switch (status)
-            {
-                case ExplorationStatus::FULLY_EXPLORED: return;
-                case ExplorationStatus::PARTIALLY_EXPLORED:
+            // the dense id + 1 of each provider index, or 0 if it hasn't been reached yet
+            std::vector<size_t> ids;
+            auto id_of = [&](size_t vertex) {
+                if (vertex >= ids.size())
                 {
-                    print2("Cycle detected within graph at ", f.to_string(vertex), ":\n");
-                    for (auto&& node : exploration_status)
-                    {
-                        if (node.second == ExplorationStatus::PARTIALLY_EXPLORED)
-                        {
-                            print2("    ", f.to_string(node.first), '\n');
-                        }
-                    }
-                    Checks::exit_fail(VCPKG_LINE_INFO);
+                    ids.resize(vertex + 1);
                 }
-                case ExplorationStatus::NOT_EXPLORED:
+
+                auto& id = ids[vertex];
+                if (id == 0)
                 {
-                    status = ExplorationStatus::PARTIALLY_EXPLORED;
-                    U vertex_data = f.load_vertex_data(vertex);
-                    auto neighbours = f.adjacency_list(vertex_data);
-                    details::shuffle(neighbours, randomizer);
-                    for (const V& neighbour : neighbours)
-                        topological_sort_internal(neighbour, f, exploration_status, sorted, randomizer);
-
-                    sorted.push_back(std::move(vertex_data));
-                    status = ExplorationStatus::FULLY_EXPLORED;
-                    return;
+                    vertices.push_back(vertex);
+                    id = vertices.size();
                 }
-                default: Checks::unreachable(VCPKG_LINE_INFO);
+
+                return id - 1;
+            };
+
+            for (auto&& vertex : starting_vertices)
+            {
+                starts.push_back(id_of(vertex));
+            }
+
+            // ids are handed out in discovery order, so each vertex's edges are appended in id order
+            edge_offsets.push_back(0);
+            for (size_t id = 0; id < vertices.size(); ++id)
+            {
+                const auto first_edge = edges.size();
+                f.append_adjacency_list(vertices[id], edges);
+                for (auto edge = first_edge; edge < edges.size(); ++edge)
+                {
+                    edges[edge] = id_of(edges[edge]);
+                }
+
+                edge_offsets.push_back(edges.size());
             }
         }
-    }
 
-    template<class Range, class V, class U>
-    std::vector<U> topological_sort(Range starting_vertices, const AdjacencyProvider<V, U>& f, Randomizer* randomizer)
+        size_t size() const { return vertices.size(); }
+
+        // the provider's index of each vertex
+        std::vector<size_t> vertices;
+        // the neighbours of vertex i are edges[edge_offsets[i]] .. edges[edge_offsets[i + 1]]
+        std::vector<size_t> edge_offsets;
+        std::vector<size_t> edges;
+        // the ids of the starting vertices, in the order they were given
+        std::vector<size_t> starts;
+    };
+
+    // Sorts the graph so that every vertex comes after its neighbours, loading the data of each vertex as it is placed.
+    template<class U>
+    std::vector<U> topological_sort(CompactGraph&& graph, const AdjacencyProvider<U>& f, Randomizer* randomizer)
     {
+        struct Frame
+        {
+            size_t vertex;
+            size_t next_edge;
+        };
+
         std::vector<U> sorted;
-        std::unordered_map<V, ExplorationStatus> exploration_status;
+        sorted.reserve(graph.size());
+        std::vector<ExplorationStatus> exploration_status(graph.size(), ExplorationStatus::NOT_EXPLORED);
+        std::vector<Frame> stack;
 
-        details::shuffle(starting_vertices, randomizer);
+        auto explore = [&](size_t vertex) {
+            exploration_status[vertex] = ExplorationStatus::PARTIALLY_EXPLORED;
+            Span<size_t> neighbours(graph.edges.data() + graph.edge_offsets[vertex],
+                                    graph.edges.data() + graph.edge_offsets[vertex + 1]);
+            details::shuffle(neighbours, randomizer);
+            stack.push_back({vertex, graph.edge_offsets[vertex]});
+        };
 
-        for (auto&& vertex : starting_vertices)
+        details::shuffle(graph.starts, randomizer);
+        for (auto start : graph.starts)
         {
-            details::topological_sort_internal(vertex, f, exploration_status, sorted, randomizer);
+            if (exploration_status[start] != ExplorationStatus::NOT_EXPLORED) continue;
+
+            explore(start);
+            while (!stack.empty())
+            {
+                auto& top = stack.back();
+                if (top.next_edge == graph.edge_offsets[top.vertex + 1])
+                {
+                    sorted.push_back(f.load_vertex_data(graph.vertices[top.vertex]));
+                    exploration_status[top.vertex] = ExplorationStatus::FULLY_EXPLORED;
+                    stack.pop_back();
+                    continue;
+                }
+
+                const auto neighbour = graph.edges[top.next_edge++];
+                switch (exploration_status[neighbour])
+                {
+                    case ExplorationStatus::FULLY_EXPLORED: break;
+                    case ExplorationStatus::PARTIALLY_EXPLORED:
+                    {
+                        print2("Cycle detected within graph at ", f.to_string(graph.vertices[neighbour]), ":\n");
+                        for (auto&& frame : stack)
+                        {
+                            print2("    ", f.to_string(graph.vertices[frame.vertex]), '\n');
+                        }
+                        Checks::exit_fail(VCPKG_LINE_INFO);
+                    }
+                    case ExplorationStatus::NOT_EXPLORED: explore(neighbour); break;
+                    default: Checks::unreachable(VCPKG_LINE_INFO);
+                }
+            }
         }
 
         return sorted;
     }
+
+    template<class Range, class U>
+    std::vector<U> topological_sort(const Range& starting_vertices, const AdjacencyProvider<U>& f, Randomizer* randomizer)
+    {
+        return topological_sort(CompactGraph(starting_vertices, f), f, randomizer);
+    }
 }
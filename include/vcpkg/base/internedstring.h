@@ -0,0 +1,59 @@
+#pragma once
+
+#include <vcpkg/base/stringview.h>
+
+#include <stddef.h>
+
+#include <string>
+
+namespace vcpkg
+{
+    struct InternedStringInstance
+    {
+        explicit InternedStringInstance(std::string&& s);
+
+        const std::string value;
+        const size_t hash;
+    };
+
+    // A handle to a string kept in a process-wide table that is never freed. Equal strings always get the same
+    // handle, so copying, comparing for equality, and hashing never touch the characters.
+    struct InternedString
+    {
+        constexpr InternedString() noexcept : m_instance(&EMPTY_INSTANCE) { }
+
+        // Safe to call from any thread.
+        static InternedString intern(StringView sv);
+
+        const std::string& str() const noexcept { return m_instance->value; }
+        size_t hash_code() const noexcept { return m_instance->hash; }
+        bool empty() const noexcept { return m_instance->value.empty(); }
+
+        operator StringView() const noexcept { return m_instance->value; }
+
+        bool operator==(InternedString other) const noexcept { return m_instance == other.m_instance; }
+        bool operator!=(InternedString other) const noexcept { return m_instance != other.m_instance; }
+
+        // Lexicographic, so that ordered containers keep the same order as they would with the strings themselves.
+        bool operator<(InternedString other) const noexcept
+        {
+            return m_instance != other.m_instance && m_instance->value < other.m_instance->value;
+        }
+
+    private:
+        static const InternedStringInstance EMPTY_INSTANCE;
+
+        constexpr InternedString(const InternedStringInstance* instance) noexcept : m_instance(instance) { }
+
+        const InternedStringInstance* m_instance;
+    };
+}
+
+namespace std
+{
+    template<>
+    struct hash<vcpkg::InternedString>
+    {
+        size_t operator()(vcpkg::InternedString s) const noexcept { return s.hash_code(); }
+    };
+}
@@ -9,6 +9,7 @@
 #include <vcpkg/base/stringliteral.h>
 
 #include <string>
+#include <utility>
 
 namespace vcpkg::msg
 {
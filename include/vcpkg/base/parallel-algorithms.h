@@ -0,0 +1,114 @@
+#pragma once
+
+#include <vcpkg/base/system.h>
+
+#include <algorithm>
+#include <atomic>
+#include <future>
+#include <vector>
+
+namespace vcpkg
+{
+    namespace details
+    {
+        inline size_t& parallel_region_depth()
+        {
+            static thread_local size_t depth = 0;
+            return depth;
+        }
+
+        struct ParallelRegion
+        {
+            ParallelRegion() { ++parallel_region_depth(); }
+            ParallelRegion(const ParallelRegion&) = delete;
+            ParallelRegion& operator=(const ParallelRegion&) = delete;
+            ~ParallelRegion() { --parallel_region_depth(); }
+        };
+    }
+
+    // Whether the calling thread is running work for execute_in_parallel. Code that would start its own threads can
+    // check this to avoid multiplying the number of threads in use.
+    inline bool in_parallel_region() { return details::parallel_region_depth() != 0; }
+
+    // Runs `work` on up to min(get_concurrency(), work_count) threads, including the calling thread, and waits for
+    // all of them to return. `work` is expected to pull items from a shared work counter until it is exhausted.
+    // Inside a parallel region, `work` runs only on the calling thread, so that nested calls don't multiply the number
+    // of threads in use.
+    template<class F>
+    void execute_in_parallel(size_t work_count, F&& work)
+    {
+        if (in_parallel_region())
+        {
+            work();
+            return;
+        }
+
+        const auto num_threads =
+            std::max(static_cast<size_t>(1), std::min(static_cast<size_t>(get_concurrency()), work_count));
+
+        std::vector<std::future<void>> workers;
+        workers.reserve(num_threads - 1);
+        for (size_t x = 0; x < num_threads - 1; ++x)
+        {
+            workers.emplace_back(std::async(std::launch::async | std::launch::deferred, [&work]() {
+                details::ParallelRegion region;
+                work();
+            }));
+        }
+
+        details::ParallelRegion region;
+        work();
+        for (auto&& w : workers)
+        {
+            w.get();
+        }
+    }
+
+    // Invokes `cb` on each of the `work_count` elements starting at `begin`, in parallel and in no particular order.
+    template<class RanIt, class F>
+    void parallel_for_each_n(RanIt begin, size_t work_count, F&& cb)
+    {
+        if (work_count == 0)
+        {
+            return;
+        }
+
+        if (work_count == 1)
+        {
+            cb(*begin);
+            return;
+        }
+
+        std::atomic<size_t> work_item{0};
+        execute_in_parallel(work_count, [&]() {
+            for (size_t item = work_item.fetch_add(1); item < work_count; item = work_item.fetch_add(1))
+            {
+                cb(*(begin + item));
+            }
+        });
+    }
+
+    // Stores `cb(*(begin + i))` to `*(out_begin + i)` for each of the `work_count` elements, in parallel.
+    template<class RanIt, class OutIt, class F>
+    void parallel_transform(RanIt begin, size_t work_count, OutIt out_begin, F&& cb)
+    {
+        if (work_count == 0)
+        {
+            return;
+        }
+
+        if (work_count == 1)
+        {
+            *out_begin = cb(*begin);
+            return;
+        }
+
+        std::atomic<size_t> work_item{0};
+        execute_in_parallel(work_count, [&]() {
+            for (size_t item = work_item.fetch_add(1); item < work_count; item = work_item.fetch_add(1))
+            {
+                *(out_begin + item) = cb(*(begin + item));
+            }
+        });
+    }
+}
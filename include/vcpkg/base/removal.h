@@ -0,0 +1,22 @@
+#pragma once
+
+#include <vcpkg/base/files.h>
+#include <vcpkg/base/lineinfo.h>
+
+#include <system_error>
+
+namespace vcpkg::Removal
+{
+    // Removes `base` recursively like Filesystem::remove_all, removing its subtrees on several threads.
+    void remove_all_parallel(Filesystem& fs, const Path& base, std::error_code& ec, Path& failure_point);
+
+    // Renames `target` aside to a tombstone next to it, so that the path can be reused as soon as this returns, and
+    // removes the tombstone on a background thread. When the rename fails, `target` is removed in place instead.
+    // The first removal in a directory also removes the tombstones there left by processes that are no longer running.
+    void remove_all_in_background(Filesystem& fs, const Path& target, std::error_code& ec, Path& failure_point);
+    void remove_all_in_background(Filesystem& fs, const Path& target, LineInfo li);
+
+    // Waits for every background removal to finish, and warns about the tombstones that could not be removed.
+    // Called before exiting, so that nothing is left behind.
+    void join();
+}
@@ -24,6 +24,9 @@ namespace vcpkg
 
     long get_process_id();
 
+    // Whether a process with the given id is currently running. Errs on the side of reporting that it is.
+    bool is_process_running(long pid);
+
     enum class CPUArchitecture
     {
         X86,
@@ -0,0 +1,39 @@
+#pragma once
+
+#include <vcpkg/base/files.h>
+#include <vcpkg/base/stringliteral.h>
+#include <vcpkg/base/stringview.h>
+
+#include <stdint.h>
+
+#include <string>
+
+namespace vcpkg::Tracing
+{
+    // Starts recording spans, to be written to `trace_file` by `finish()`. Until this is called, TraceSpan does
+    // nothing beyond checking a flag.
+    void start(const Path& trace_file);
+    bool is_enabled() noexcept;
+
+    // Writes every span recorded so far to the trace file passed to `start()`, if any.
+    void finish(Filesystem& fs);
+
+    // Returns the recorded spans in the Chrome trace event format, as loaded by chrome://tracing and Perfetto.
+    std::string serialize_trace();
+
+    // A named interval of work on the calling thread. Spans nest by lifetime: a span opened while another one is
+    // alive on the same thread is shown as its child.
+    struct TraceSpan
+    {
+        TraceSpan(StringLiteral category, StringView name);
+        TraceSpan(const TraceSpan&) = delete;
+        TraceSpan& operator=(const TraceSpan&) = delete;
+        ~TraceSpan();
+
+    private:
+        StringLiteral m_category;
+        std::string m_name;
+        uint64_t m_start_us;
+        bool m_enabled;
+    };
+}
@@ -13,6 +13,7 @@ namespace vcpkg
     {
         BinaryParagraph();
         explicit BinaryParagraph(Parse::Paragraph fields);
+        explicit BinaryParagraph(View<Parse::ParagraphFieldView> fields);
         BinaryParagraph(const SourceParagraph& spgh,
                         Triplet triplet,
                         Optional<bin2sth::CompileTriplet>&& compile_triplet,
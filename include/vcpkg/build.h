@@ -4,9 +4,11 @@
 #include <vcpkg/fwd/dependencies.h>
 #include <vcpkg/fwd/portfileprovider.h>
 
+#include <vcpkg/base/chrono.h>
 #include <vcpkg/base/cstringview.h>
 #include <vcpkg/base/files.h>
 #include <vcpkg/base/optional.h>
+#include <vcpkg/base/span.h>
 #include <vcpkg/base/system.process.h>
 
 #include <vcpkg/commands.integrate.h>
@@ -266,6 +268,17 @@ namespace vcpkg::Build
                                       const IBuildLogsRecorder& build_logs_recorder,
                                       const StatusParagraphs& status_db);
 
+    /// Builds `variants`, the compile triplet variants of one port, concurrently. The sources are downloaded once
+    /// before the variants are built, and each variant gets its own buildtree. Returns the results in the same order
+    /// as `variants`, and stores the time spent building each variant to `timings`.
+    std::vector<ExtendedBuildResult> build_package_variants(const VcpkgCmdArguments& args,
+                                                            const VcpkgPaths& paths,
+                                                            View<const Dependencies::InstallPlanAction*> variants,
+                                                            BinaryCache& binary_cache,
+                                                            const IBuildLogsRecorder& build_logs_recorder,
+                                                            const StatusParagraphs& status_db,
+                                                            std::vector<ElapsedTime>& timings);
+
     enum class BuildPolicy
     {
         EMPTY_PACKAGE,
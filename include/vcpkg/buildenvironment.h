@@ -12,4 +12,9 @@ namespace vcpkg
     Command make_cmake_cmd(const VcpkgPaths& paths,
                            const Path& cmake_script,
                            std::vector<CMakeVariable>&& pass_variables);
+
+    Command make_cmake_cmd(const VcpkgPaths& paths,
+                           const Path& cmake_script,
+                           std::vector<CMakeVariable>&& pass_variables,
+                           const Path& buildtrees_dir);
 }
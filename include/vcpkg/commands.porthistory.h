@@ -1,9 +1,69 @@
 #pragma once
 
+#include <vcpkg/base/files.h>
+#include <vcpkg/base/optional.h>
+#include <vcpkg/base/stringview.h>
+
 #include <vcpkg/commands.interface.h>
+#include <vcpkg/versions.h>
+
+#include <string>
+#include <vector>
 
 namespace vcpkg::Commands::PortHistory
 {
+    struct CommitTree
+    {
+        std::string commit_id;
+        std::string commit_date;
+        // object id of ports/<port_name> in this commit; empty if the port was deleted or is unknown
+        std::string git_tree;
+        // whether this commit deleted ports/<port_name>
+        bool deleted;
+    };
+
+    struct HistoryVersion
+    {
+        std::string port_name;
+        std::string git_tree;
+        std::string commit_id;
+        std::string commit_date;
+        // the version as printed, "<version>#<port-version>"
+        std::string version_string;
+        std::string version;
+        int port_version;
+        VersionScheme scheme;
+    };
+
+    HistoryVersion make_history_version(const std::string& port_name,
+                                        const std::string& git_tree,
+                                        const std::string& commit_id,
+                                        const std::string& commit_date,
+                                        const std::string& version,
+                                        int port_version,
+                                        VersionScheme scheme);
+
+    // The history cache records, per port, the deduplicated history up to `head`. Since a commit's history never
+    // changes, a later query only needs to walk `head..HEAD` and prepend the result.
+    struct PortHistoryCache
+    {
+        std::string head;
+        std::vector<HistoryVersion> versions;
+    };
+
+    // nullopt if the cache file is missing or malformed
+    Optional<PortHistoryCache> try_load_port_history_cache(const Filesystem& fs,
+                                                           const Path& cache_path,
+                                                           const std::string& port_name);
+    void store_port_history_cache(Filesystem& fs, const Path& cache_path, const PortHistoryCache& cache);
+
+    // The table printed by `vcpkg x-history` without --x-json.
+    std::string format_port_history(const std::vector<HistoryVersion>& versions);
+
+    // Parses the output of `git log --format="@%H %cd" -t --raw --no-abbrev -- ports/<port_name>/.`. Commits whose
+    // diff does not record the port's tree, such as merge commits, are returned with an empty `git_tree`.
+    std::vector<CommitTree> parse_port_log(StringView log_output, StringView port_name);
+
     void perform_and_exit(const VcpkgCmdArguments& args, const VcpkgPaths& paths);
 
     struct PortHistoryCommand : PathsCommand
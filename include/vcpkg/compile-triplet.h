@@ -2,12 +2,33 @@
 
 #include <vcpkg/triplet.h>
 
+#include <memory>
+#include <string>
+
 namespace vcpkg::bin2sth
 {
     constexpr StringLiteral DEFAULT_COMPILER_TAG = "default";
     constexpr StringLiteral DEFAULT_OPTIMIZATION_TAG = "";
     constexpr StringLiteral DEFAULT_OBFUSCATION_TAG = "NONE";
 
+    struct CompileTripletInstance
+    {
+        CompileTripletInstance(std::string&& compiler_tag,
+                               std::string&& optimization_tag,
+                               std::string&& obfuscation_tag,
+                               Triplet triplet);
+
+        const std::string compiler_tag;
+        const std::string optimization_tag;
+        const std::string obfuscation_tag;
+        const Triplet triplet;
+
+        const std::string canonical_name;
+        const size_t hash;
+    };
+
+    // A handle to an immutable, interned combination of tags and triplet. Equal combinations share one instance, which
+    // also holds the canonical name and hash, so copying and comparing a CompileTriplet never builds a string.
     struct CompileTriplet
     {
     public:
@@ -21,26 +42,38 @@ namespace vcpkg::bin2sth
                        std::unique_ptr<std::string> const& obfuscation_tag,
                        Triplet triplet);
 
+        // Looks up combinations that have been seen before by name, without splitting it.
         static Optional<CompileTriplet> from_canonical_name(std::string const& canonical_name, Triplet triplet);
 
         void with_triplet(Triplet new_triplet);
 
+        const std::string& compiler_tag() const { return m_instance->compiler_tag; }
+        const std::string& optimization_tag() const { return m_instance->optimization_tag; }
+        const std::string& obfuscation_tag() const { return m_instance->obfuscation_tag; }
+        Triplet triplet() const { return m_instance->triplet; }
+
         std::string to_string() const;
         void to_string(std::string&) const;
-        std::string canonical_name() const;
+        const std::string& canonical_name() const { return m_instance->canonical_name; }
+
+        size_t hash_code() const { return m_instance->hash; }
 
-        size_t hash_code() const;
+        bool operator<(const CompileTriplet& other) const
+        {
+            return m_instance != other.m_instance && canonical_name() < other.canonical_name();
+        }
 
-        bool operator<(const CompileTriplet& other) const { return canonical_name() < other.canonical_name(); }
+        friend bool operator==(const CompileTriplet& left, const CompileTriplet& right)
+        {
+            return left.m_instance == right.m_instance;
+        }
 
-        std::string compiler_tag;
-        std::string optimization_tag;
-        std::string obfuscation_tag;
+    private:
+        explicit CompileTriplet(const CompileTripletInstance* instance) : m_instance(instance) { }
 
-        Triplet triplet;
+        const CompileTripletInstance* m_instance;
     };
 
-    bool operator==(const CompileTriplet& left, const CompileTriplet& right);
     inline bool operator!=(const CompileTriplet& left, const CompileTriplet& right) { return !(left == right); }
 
     Optional<bin2sth::CompileTriplet> default_compile_triplet(VcpkgCmdArguments const& args, Triplet default_triplet);
@@ -0,0 +1,80 @@
+#pragma once
+
+#include <vcpkg/base/expected.h>
+#include <vcpkg/base/files.h>
+#include <vcpkg/base/optional.h>
+#include <vcpkg/base/stringview.h>
+
+#include <vcpkg/registries.h>
+#include <vcpkg/versions.h>
+
+#include <stdint.h>
+
+#include <map>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace vcpkg
+{
+    // The builtin registry's versions database and default baseline, compiled into one binary file that is read
+    // through a memory mapping. Looking a port up is a binary search over a sorted index of fixed-width records;
+    // nothing is parsed. The header records a key for the contents of the files it was compiled from, so a stale
+    // database is recognized without looking at those files.
+    //
+    // Layout; all integers are little-endian uint32 unless noted, and all strings live in the string table:
+    //   header:   magic "vcpkgvdb", format version, port count, entry count, string table size,
+    //             source key offset, source key size
+    //   ports:    sorted by name; name offset, name size, first entry, entry count,
+    //             baseline version offset, baseline version size, baseline port-version (int32, -1 if none)
+    //   entries:  version offset, version size, port-version (int32), scheme (uint8), 3 bytes of padding,
+    //             git tree SHA (20 bytes)
+    //   strings
+    struct CompiledVersionDb
+    {
+        struct PortVersions
+        {
+            std::string port_name;
+            // as read from versions/<x>-/<port>.json, in order
+            std::vector<VersionDbEntry> entries;
+        };
+
+        // Serializes the database. The result only depends on the arguments, so compiling the same JSON files always
+        // produces the same bytes. Fails if a git tree is not a SHA-1 in hex.
+        static ExpectedS<std::string> compile(std::vector<PortVersions> ports,
+                                              const std::map<std::string, Version, std::less<>>& baseline,
+                                              StringView source_key);
+
+        // Returns nullopt if the contents are not a database this vcpkg can read. Only the header is checked here;
+        // each record is checked when it is looked up.
+        static Optional<CompiledVersionDb> from_mapping(MappedFile&& file);
+
+        // identifies the contents of the files the database was compiled from
+        StringView source_key() const { return m_source_key; }
+
+        // nullopt if the port has no versions
+        Optional<std::vector<VersionDbEntry>> get_port_versions(StringView port_name) const;
+        Optional<Version> get_baseline_version(StringView port_name) const;
+        std::map<std::string, Version, std::less<>> get_baseline() const;
+
+    private:
+        explicit CompiledVersionDb(MappedFile&& file) : m_file(std::move(file)) { }
+
+        const char* find_port(StringView port_name) const;
+        StringView string_at(const char* offset_and_size) const;
+
+        MappedFile m_file;
+        uint32_t m_port_count = 0;
+        uint32_t m_entry_count = 0;
+        const char* m_ports = nullptr;
+        const char* m_entries = nullptr;
+        StringView m_strings;
+        StringView m_source_key;
+    };
+
+    // Maps the compiled database at `db_path` if it exists, is valid, and was compiled from files whose key is
+    // `source_key`; otherwise the JSON files must be read.
+    Optional<CompiledVersionDb> try_load_compiled_versions_db(const Filesystem& fs,
+                                                              const Path& db_path,
+                                                              StringView source_key);
+}
@@ -12,15 +12,30 @@ namespace vcpkg
         std::string version;
         Path c_full_path;
         Path cxx_full_path;
+        // SHA256 over the contents of both compiler binaries, taken when the compiler was registered; empty for
+        // compilers registered before fingerprints were recorded.
+        std::string fingerprint;
 
         static CompilerInfo load(const Filesystem& filesystem, const Path& path);
         static void dump(Filesystem& filesystem, const Path& path, const CompilerInfo& instance);
 
+        static std::string compute_fingerprint(const Filesystem& filesystem, const Path& c_path, const Path& cxx_path);
+
         size_t hash_code() const;
         std::string nickname() const { return std::string(name).append("-").append(version); }
     };
 }
 
+namespace vcpkg::CompilerIndex
+{
+    // The registered compilers are kept in a single index file, keyed by nickname.
+    std::map<std::string, CompilerInfo> load(const Filesystem& filesystem, const Path& index_path);
+    void dump(Filesystem& filesystem, const Path& index_path, const std::map<std::string, CompilerInfo>& compilers);
+    // Fingerprints the compiler and writes it to the index, replacing an entry registered without a fingerprint.
+    // Returns false, leaving the index unchanged, if the nickname is already registered with a fingerprint.
+    bool add(Filesystem& filesystem, const Path& index_path, CompilerInfo compiler_info);
+}
+
 namespace std
 {
     template<>
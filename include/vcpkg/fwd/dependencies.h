@@ -4,4 +4,5 @@ namespace vcpkg::Dependencies
 {
     struct InstallPlanAction;
     struct ActionPlan;
+    struct RemovePlanAction;
 }
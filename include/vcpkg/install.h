@@ -75,15 +75,32 @@ namespace vcpkg::Install
 
     void install_package_and_write_listfile(Filesystem& fs, const Path& source_dir, const InstallDir& destination_dir);
 
+    enum class InstallFileMode
+    {
+        Copy,
+        // Shares the contents of regular files with the source through hard links where the filesystem allows it,
+        // and copies them otherwise.
+        HardLink,
+    };
+
+    // Regular files are placed in parallel, after the directories and symlinks.
     void install_files_and_write_listfile(Filesystem& fs,
                                           const Path& source_dir,
                                           const std::vector<Path>& files,
-                                          const InstallDir& destination_dir);
+                                          const InstallDir& destination_dir,
+                                          InstallFileMode mode = InstallFileMode::Copy);
 
     InstallResult install_package(const VcpkgPaths& paths,
                                   const BinaryControlFile& binary_paragraph,
                                   StatusParagraphs* status_db);
 
+    // Groups the install actions into batches that are performed one after the other. Each batch is either a single
+    // action, or the compile triplet variants of one port, which don't depend on each other and can be built together.
+    // Plans without such variants keep their order; otherwise actions are ordered by their depth in the dependency
+    // graph, so that the variants of a port, which have the same depth, end up in the same batch.
+    std::vector<std::vector<Dependencies::InstallPlanAction*>> batch_install_actions(
+        std::vector<Dependencies::InstallPlanAction>& actions);
+
     InstallSummary perform(const VcpkgCmdArguments& args,
                            Dependencies::ActionPlan& action_plan,
                            const KeepGoing keep_going,
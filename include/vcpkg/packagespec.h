@@ -1,6 +1,7 @@
 #pragma once
 
 #include <vcpkg/base/expected.h>
+#include <vcpkg/base/internedstring.h>
 #include <vcpkg/base/json.h>
 #include <vcpkg/base/optional.h>
 #include <vcpkg/base/view.h>
@@ -27,16 +28,21 @@ namespace vcpkg
     {
         PackageSpec() = default;
         // PackageSpec(std::string name, Triplet triplet) : m_name(std::move(name)), m_triplet(triplet) { }
-        PackageSpec(std::string name, Triplet triplet, Optional<bin2sth::CompileTriplet> compile_triplet = nullopt)
-            : m_name(std::move(name)), m_triplet(triplet), m_compile_triplet(std::move(compile_triplet))
+        PackageSpec(StringView name,
+                    Triplet triplet,
+                    const Optional<bin2sth::CompileTriplet>& compile_triplet = nullopt)
+            : m_name(InternedString::intern(name))
+            , m_triplet(triplet)
+            , m_compile_triplet(compile_triplet)
         {
         }
 
-        const std::string& name() const;
+        const std::string& name() const { return m_name.str(); }
+        InternedString interned_name() const { return m_name; }
 
-        Triplet triplet() const;
+        Triplet triplet() const { return m_triplet; }
 
-        Optional<bin2sth::CompileTriplet> const& compile_triplet() const;
+        Optional<bin2sth::CompileTriplet> const& compile_triplet() const { return m_compile_triplet; }
 
         std::string qualifier() const;
         std::string dir() const;
@@ -44,24 +50,31 @@ namespace vcpkg
         std::string to_string() const;
         void to_string(std::string& s) const;
 
+        size_t hash_code() const;
+
         bool operator<(const PackageSpec& other) const
         {
-            if (name() != other.name()) return name() < other.name();
+            if (m_name != other.m_name) return m_name < other.m_name;
             if (triplet() != other.triplet()) return triplet() < other.triplet();
-            if (compile_triplet() == other.compile_triplet()) return false;
+            if (m_compile_triplet == other.m_compile_triplet) return false;
             if (!compile_triplet().has_value()) return true;
             if (!other.compile_triplet().has_value()) return false;
             return compile_triplet().value_or_exit(VCPKG_LINE_INFO) <
                    other.compile_triplet().value_or_exit(VCPKG_LINE_INFO);
         }
 
+        friend bool operator==(const PackageSpec& left, const PackageSpec& right)
+        {
+            return left.m_name == right.m_name && left.m_triplet == right.m_triplet &&
+                   left.m_compile_triplet == right.m_compile_triplet;
+        }
+
     private:
-        std::string m_name;
+        InternedString m_name;
         Triplet m_triplet;
         Optional<bin2sth::CompileTriplet> m_compile_triplet;
     };
 
-    bool operator==(const PackageSpec& left, const PackageSpec& right);
     inline bool operator!=(const PackageSpec& left, const PackageSpec& right) { return !(left == right); }
 
     ///
@@ -72,37 +85,43 @@ namespace vcpkg
     ///
     struct FeatureSpec
     {
-        FeatureSpec(const PackageSpec& spec, const std::string& feature) : m_spec(spec), m_feature(feature) { }
+        FeatureSpec(const PackageSpec& spec, StringView feature)
+            : m_spec(spec), m_feature(InternedString::intern(feature))
+        {
+        }
 
         const std::string& port() const { return m_spec.name(); }
-        const std::string& feature() const { return m_feature; }
+        const std::string& feature() const { return m_feature.str(); }
         Triplet triplet() const { return m_spec.triplet(); }
         const Optional<bin2sth::CompileTriplet>& compile_triplet() const { return m_spec.compile_triplet(); }
 
         const PackageSpec& spec() const { return m_spec; }
+        InternedString interned_feature() const { return m_feature; }
 
         std::string to_string() const;
         void to_string(std::string& out) const;
 
         bool operator<(const FeatureSpec& other) const
         {
-            if (port() < other.port()) return true;
-            if (port() > other.port()) return false;
-            if (feature() < other.feature()) return true;
-            if (feature() > other.feature()) return false;
-            return triplet() < other.triplet();
+            if (m_spec.interned_name() != other.m_spec.interned_name())
+            {
+                return m_spec.interned_name() < other.m_spec.interned_name();
+            }
+
+            if (m_feature != other.m_feature) return m_feature < other.m_feature;
+            return m_spec < other.m_spec;
         }
 
         bool operator==(const FeatureSpec& other) const
         {
-            return triplet() == other.triplet() && port() == other.port() && feature() == other.feature();
+            return m_spec == other.m_spec && m_feature == other.m_feature;
         }
 
         bool operator!=(const FeatureSpec& other) const { return !(*this == other); }
 
     private:
         PackageSpec m_spec;
-        std::string m_feature;
+        InternedString m_feature;
     };
 
     /// In an internal feature set, "default" represents default features and missing "core" has no semantic
@@ -223,21 +242,7 @@ namespace std
     template<>
     struct hash<vcpkg::PackageSpec>
     {
-        size_t operator()(const vcpkg::PackageSpec& value) const
-        {
-            size_t hash = 17;
-            hash = hash * 31 + std::hash<std::string>()(value.name());
-            hash = hash * 31 + std::hash<vcpkg::Triplet>()(value.triplet());
-
-            auto const compile_triplet_opt = value.compile_triplet();
-            auto const hash_compile_triplet =
-                compile_triplet_opt.has_value()
-                    ? std::hash<vcpkg::bin2sth::CompileTriplet>()(compile_triplet_opt.value_or_exit(VCPKG_LINE_INFO))
-                    : 0;
-
-            hash = hash * 31 + hash_compile_triplet;
-            return hash;
-        }
+        size_t operator()(const vcpkg::PackageSpec& value) const { return value.hash_code(); }
     };
 
     template<>
@@ -246,7 +251,7 @@ namespace std
         size_t operator()(const vcpkg::FeatureSpec& value) const
         {
             size_t hash = std::hash<vcpkg::PackageSpec>()(value.spec());
-            hash = hash * 31 + std::hash<std::string>()(value.feature());
+            hash = hash * 31 + value.interned_feature().hash_code();
             return hash;
         }
     };
@@ -1,6 +1,8 @@
 #pragma once
 
 #include <vcpkg/base/expected.h>
+#include <vcpkg/base/span.h>
+#include <vcpkg/base/stringview.h>
 
 #include <vcpkg/packagespec.h>
 #include <vcpkg/textrowcol.h>
@@ -35,6 +37,19 @@ namespace vcpkg::Parse
 
     using Paragraph = std::unordered_map<std::string, std::pair<std::string, TextRowCol>>;
 
+    // A field of a paragraph, as views into the text it was read from
+    struct ParagraphFieldView
+    {
+        StringView name;
+        // the value as it appears in the text; continuation lines keep their line breaks and indentation
+        StringView raw_value;
+
+        // the value as it would be stored in a Paragraph, with line breaks normalized to '\n'
+        std::string value() const;
+    };
+
+    std::vector<ParagraphFieldView> to_field_views(const Paragraph& fields);
+
     struct ParagraphParser
     {
         ParagraphParser(Paragraph&& fields) : fields(std::move(fields)) { }
@@ -56,6 +71,29 @@ namespace vcpkg::Parse
         std::map<std::string, std::string> expected_types;
     };
 
+    // Like ParagraphParser, but reads the fields from views instead of taking ownership of them
+    struct ParagraphViewParser
+    {
+        explicit ParagraphViewParser(View<ParagraphFieldView> fields) : fields(fields), used(fields.size()) { }
+
+        std::string required_field(StringView fieldname);
+        void required_field(StringView fieldname, std::string& out);
+
+        std::string optional_field(StringView fieldname);
+
+        void add_type_error(const std::string& fieldname, const char* type) { expected_types[fieldname] = type; }
+
+        std::unique_ptr<ParseControlErrorInfo> error_info(StringView name) const;
+
+    private:
+        const ParagraphFieldView* find_field(StringView fieldname);
+
+        View<ParagraphFieldView> fields;
+        std::vector<bool> used;
+        std::vector<std::string> missing_fields;
+        std::map<std::string, std::string> expected_types;
+    };
+
     ExpectedS<std::vector<std::string>> parse_default_features_list(const std::string& str,
                                                                     StringView origin = "<unknown>",
                                                                     TextRowCol textrowcol = {});
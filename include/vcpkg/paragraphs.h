@@ -3,6 +3,7 @@
 #include <vcpkg/fwd/registries.h>
 
 #include <vcpkg/base/expected.h>
+#include <vcpkg/base/optional.h>
 
 #include <vcpkg/binaryparagraph.h>
 
@@ -24,6 +25,32 @@ namespace vcpkg::Paragraphs
 
     ExpectedS<std::vector<Paragraph>> parse_paragraphs(StringView str, StringView origin);
 
+    // Splits the text of a CONTROL file or status database into paragraphs, one at a time, as views into the text.
+    // Unlike parse_paragraphs, nothing is copied, and the row and column of a problem are only worked out on error.
+    struct ParagraphTokenizer
+    {
+        ParagraphTokenizer(StringView text, StringView origin);
+        ParagraphTokenizer(const ParagraphTokenizer&) = delete;
+        ParagraphTokenizer& operator=(const ParagraphTokenizer&) = delete;
+
+        // Replaces `fields` with the fields of the next paragraph. Returns false at the end of the text, or if the
+        // text is malformed, in which case error() says why; paragraphs before the problem are still returned.
+        bool next(std::vector<Parse::ParagraphFieldView>& fields);
+
+        const std::string* error() const { return m_error.empty() ? nullptr : &m_error; }
+
+    private:
+        bool set_error();
+
+        StringView m_text;
+        StringView m_origin;
+        const char* m_it;
+        std::string m_error;
+        // only used for text that is not plain UTF-8
+        Optional<std::vector<Paragraph>> m_decoded_paragraphs;
+        size_t m_next_decoded_paragraph = 0;
+    };
+
     bool is_port_directory(const Filesystem& fs, const Path& maybe_directory);
 
     Parse::ParseExpected<SourceControlFile> try_load_port(const Filesystem& fs, const Path& port_directory);
@@ -31,6 +58,12 @@ namespace vcpkg::Paragraphs
                                                                StringView origin,
                                                                bool is_manifest);
 
+    // Like try_load_port, but reads only the name and version of the port.
+    Parse::ParseExpected<PortIdentity> try_load_port_identity(const Filesystem& fs, const Path& port_directory);
+    Parse::ParseExpected<PortIdentity> try_load_port_identity_text(const std::string& text,
+                                                                   StringView origin,
+                                                                   bool is_manifest);
+
     ExpectedS<BinaryControlFile> try_load_cached_package(const Filesystem& fs,
                                                          const Path& package_dir,
                                                          const PackageSpec& spec);
@@ -56,9 +89,14 @@ namespace vcpkg::Paragraphs
         const std::string& operator()(const SourceControlFile& scf) const { return scf.core_paragraph->name; }
     } get_name_of_control_file;
 
+    // the directories of the baseline versions of all the ports in the registries, one per port name
+    std::vector<Path> get_all_registry_port_directories(const RegistrySet& registries);
     LoadResults try_load_all_registry_ports(const Filesystem& fs, const RegistrySet& registries);
+    void load_results_print_error(const LoadResults& results);
 
     std::vector<SourceControlFileAndLocation> load_all_registry_ports(const Filesystem& fs,
                                                                       const RegistrySet& registries);
+    // the directories directly inside an overlay ports directory, sorted
+    std::vector<Path> get_overlay_port_directories(const Filesystem& fs, const Path& directory);
     std::vector<SourceControlFileAndLocation> load_overlay_ports(const Filesystem& fs, const Path& dir);
 }
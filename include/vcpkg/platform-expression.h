@@ -3,14 +3,37 @@
 #include <vcpkg/base/expected.h>
 #include <vcpkg/base/stringview.h>
 
+#include <stdint.h>
+
+#include <functional>
+#include <map>
+#include <memory>
 #include <string>
 #include <unordered_map>
+#include <vector>
 
 namespace vcpkg::PlatformExpression
 {
     // map of cmake variables and their values.
     using Context = std::unordered_map<std::string, std::string>;
 
+    // A Context lowered to the truth value of every built-in identifier, with the overrides from
+    // VCPKG_DEP_INFO_OVERRIDE_VARS already applied. Lower a context once when evaluating many expressions against it.
+    struct EvaluationContext
+    {
+        static EvaluationContext from_cmake_vars(const Context& context);
+
+    private:
+        friend struct Expr;
+
+        EvaluationContext() : m_identifiers(0), m_has_native(false) { }
+
+        uint32_t m_identifiers;
+        bool m_has_native;
+        // overrides of identifiers that are not built in
+        std::map<std::string, bool, std::less<>> m_custom_identifiers;
+    };
+
     namespace detail
     {
         struct ExprImpl;
@@ -36,6 +59,7 @@ namespace vcpkg::PlatformExpression
         ~Expr();
 
         bool evaluate(const Context& context) const;
+        bool evaluate(const EvaluationContext& context) const;
         bool is_empty() const { return !static_cast<bool>(underlying_); }
 
         // returns:
@@ -65,6 +89,10 @@ namespace vcpkg::PlatformExpression
 
     private:
         std::unique_ptr<detail::ExprImpl> underlying_;
+
+        // `underlying_` compiled to postfix instructions, each an opcode in the low 8 bits and its operand above
+        std::vector<uint32_t> program_;
+        std::vector<std::string> custom_identifiers_;
     };
 
     // Note: for backwards compatibility, in CONTROL files,
@@ -16,6 +16,8 @@ namespace vcpkg::PortFileProvider
         virtual ~PortFileProvider() = default;
         virtual ExpectedS<const SourceControlFileAndLocation&> get_control_file(const std::string& src_name) const = 0;
         virtual std::vector<const SourceControlFileAndLocation*> load_all_control_files() const = 0;
+        // Returns the version get_control_file would load, without necessarily loading the whole port.
+        virtual ExpectedS<Version> get_port_version(const std::string& src_name) const;
     };
 
     struct MapPortFileProvider : PortFileProvider
@@ -43,6 +45,8 @@ namespace vcpkg::PortFileProvider
     struct IBaselineProvider
     {
         virtual Optional<Version> get_baseline_version(StringView port_name) const = 0;
+        // loads the baselines get_baseline_version will need for `port_names` ahead of time
+        virtual void prefetch_baseline_versions(View<std::string> port_names) const { (void)port_names; }
         virtual ~IBaselineProvider() = default;
     };
 
@@ -50,6 +54,7 @@ namespace vcpkg::PortFileProvider
     {
         virtual ~IOverlayProvider() = default;
         virtual Optional<const SourceControlFileAndLocation&> get_control_file(StringView port_name) const = 0;
+        virtual Optional<Version> get_port_version(StringView port_name) const = 0;
         virtual void load_all_control_files(std::map<std::string, const SourceControlFileAndLocation*>& out) const = 0;
     };
 
@@ -58,6 +63,7 @@ namespace vcpkg::PortFileProvider
         explicit PathsPortFileProvider(const vcpkg::VcpkgPaths& paths, View<std::string> overlay_ports);
         ExpectedS<const SourceControlFileAndLocation&> get_control_file(const std::string& src_name) const override;
         std::vector<const SourceControlFileAndLocation*> load_all_control_files() const override;
+        ExpectedS<Version> get_port_version(const std::string& src_name) const override;
 
     private:
         std::unique_ptr<IBaselineProvider> m_baseline;
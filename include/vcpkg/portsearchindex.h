@@ -0,0 +1,96 @@
+#pragma once
+
+#include <vcpkg/fwd/vcpkgpaths.h>
+
+#include <vcpkg/base/files.h>
+#include <vcpkg/base/optional.h>
+#include <vcpkg/base/stringview.h>
+#include <vcpkg/base/view.h>
+
+#include <stdint.h>
+
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace vcpkg
+{
+    struct SourceControlFile;
+
+    struct IndexedFeature
+    {
+        std::string name;
+        std::vector<std::string> description;
+    };
+
+    // The searchable text of a port, extracted from its manifest.
+    struct IndexedPort
+    {
+        std::string name;
+        std::string version;
+        int port_version = 0;
+        std::vector<std::string> description;
+        std::vector<IndexedFeature> features;
+
+        // the port directory, and the name and modification time of the manifest the text was extracted from
+        Path location;
+        std::string manifest;
+        int64_t manifest_time = 0;
+
+        static IndexedPort from_source_control_file(const SourceControlFile& scf);
+    };
+
+    // Ordered from the best match to the worst.
+    enum class SearchMatch
+    {
+        ExactName,
+        NamePrefix,
+        Name,
+        Description,
+        Feature,
+    };
+
+    struct SearchResult
+    {
+        const IndexedPort* port;
+        SearchMatch match;
+        // the features to list under the port: all of them when the port itself matched
+        std::vector<const IndexedFeature*> features;
+    };
+
+    // A persisted index of the names and descriptions of ports and their features. Searching it runs a case-insensitive
+    // substring match only over the ports that contain every trigram of the query, and loads no manifests.
+    struct PortSearchIndex
+    {
+        // A missing, unreadable or outdated index file results in an empty index.
+        static PortSearchIndex load(const Filesystem& fs, const Path& index_path);
+        void save(Filesystem& fs, const Path& index_path, std::error_code& ec) const;
+
+        // Brings the index in line with the given port directories, re-reading only the manifests which changed since
+        // they were indexed. When several directories contain ports with the same name, the first one wins.
+        // Returns whether the index changed.
+        bool refresh(const Filesystem& fs, View<Path> port_directories);
+
+        // the visible ports, sorted by name
+        std::vector<const IndexedPort*> ports() const;
+
+        // the visible ports matching the query, ordered by how well they matched, then by name
+        std::vector<SearchResult> search(StringView query) const;
+
+    private:
+        void build();
+
+        // every indexed port, in the order of the directories they were found in, including ports hidden by an
+        // earlier one with the same name so that they don't have to be re-read on every refresh
+        std::vector<IndexedPort> m_ports;
+        // indices of the first port of each name, sorted by name
+        std::vector<uint32_t> m_visible;
+        // trigram of lowercase text -> indices of the visible ports containing it, ascending
+        std::unordered_map<uint32_t, std::vector<uint32_t>> m_trigrams;
+    };
+
+    // nullopt when there is no buildtrees directory to keep the index in, such as in a read-only bundle
+    Optional<Path> port_search_index_path(const VcpkgPaths& paths);
+    // the directories of all the ports visible from the overlays and registries, overlays first
+    std::vector<Path> get_searchable_port_directories(const VcpkgPaths& paths, View<std::string> overlay_ports);
+}
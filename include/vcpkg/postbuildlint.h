@@ -5,6 +5,10 @@
 
 #include <vcpkg/base/files.h>
 
+#include <set>
+#include <string>
+#include <vector>
+
 namespace vcpkg
 {
     struct PackageSpec;
@@ -12,6 +16,34 @@ namespace vcpkg
 
 namespace vcpkg::PostBuildLint
 {
+    // The contents of a package directory, enumerated once and shared by all checks. Looking up the files of a
+    // directory ignores whether the path uses forward or back slashes, and on Windows also ASCII case.
+    struct PackageFileIndex
+    {
+        PackageFileIndex(const Filesystem& fs, const Path& package_dir);
+
+        // Returns the regular files anywhere below `dir`.
+        std::vector<Path> regular_files_under(const Path& dir) const;
+
+        // Returns the regular files directly inside `dir`.
+        std::vector<Path> regular_files_in(const Path& dir) const;
+
+        // Only directories without any indexed child are checked on disk, since they may still contain symlinks or
+        // other non-regular files.
+        std::vector<Path> empty_directories(const Filesystem& fs) const;
+
+        std::vector<Path> directories;
+        // sorted by their normalized key
+        std::vector<Path> regular_files;
+
+    private:
+        std::vector<Path> files_under(const Path& dir, bool direct_children_only) const;
+
+        // the key of each of regular_files, in the same order
+        std::vector<std::string> regular_file_keys;
+        std::set<std::string, std::less<>> non_empty_directories;
+    };
+
     size_t perform_all_checks(const PackageSpec& spec,
                               const VcpkgPaths& paths,
                               const Build::PreBuildInfo& pre_build_info,
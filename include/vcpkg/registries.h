@@ -43,7 +43,10 @@ namespace vcpkg
             void ensure_up_to_date(const VcpkgPaths& paths) const;
         };
 
-        Entry get_or_fetch(const VcpkgPaths& paths, StringView repo, StringView reference);
+        // adds the entry for `repo` and `reference`, or returns the existing one if it was added first
+        Entry insert(StringView repo, StringView reference, std::string&& commit_id);
+        // returns the entry for `repo` and `reference` if there is one, without fetching it
+        Optional<Entry> find(StringView repo, StringView reference);
 
         LockDataType lockdata;
         bool modified = false;
@@ -71,6 +74,9 @@ namespace vcpkg
 
         virtual Optional<Version> get_baseline_version(StringView port_name) const = 0;
 
+        // loads the baseline that get_baseline_version uses, if it isn't loaded yet; may be called concurrently
+        virtual void prefetch_baseline() const { }
+
         virtual Optional<Path> get_path_to_baseline_version(StringView port_name) const;
 
         virtual ~RegistryImplementation() = default;
@@ -112,6 +118,10 @@ namespace vcpkg
         const RegistryImplementation* registry_for_port(StringView port_name) const;
         Optional<Version> baseline_for_port(StringView port_name) const;
 
+        // Loads the baselines of the registries of `port_names` concurrently, so that baseline_for_port doesn't wait
+        // on each registry's fetch in turn.
+        void prefetch_baselines(View<std::string> port_names) const;
+
         View<Registry> registries() const { return registries_; }
 
         const RegistryImplementation* default_registry() const { return default_registry_.get(); }
@@ -143,6 +153,12 @@ namespace vcpkg
 
     ExpectedS<std::map<std::string, Version, std::less<>>> get_builtin_baseline(const VcpkgPaths& paths);
 
+    // Compiles the versions files and the default baseline in `registry_versions` into a CompiledVersionDb, recording
+    // `source_key` as the key of their contents.
+    ExpectedS<std::string> compile_versions_db(const Filesystem& fs,
+                                               const Path& registry_versions,
+                                               StringView source_key);
+
     bool is_git_commit_sha(StringView sv);
 
     struct VersionDbEntry
@@ -1,11 +1,25 @@
 #pragma once
 
+#include <vcpkg/base/fwd/files.h>
+
 #include <vcpkg/fwd/dependencies.h>
+#include <vcpkg/fwd/installedpaths.h>
+#include <vcpkg/fwd/packagespec.h>
 #include <vcpkg/fwd/vcpkgcmdarguments.h>
 #include <vcpkg/fwd/vcpkgpaths.h>
 
+#include <vcpkg/base/chrono.h>
+#include <vcpkg/base/view.h>
+
 #include <vcpkg/commands.interface.h>
 
+#include <vector>
+
+namespace vcpkg
+{
+    struct StatusParagraphs;
+}
+
 namespace vcpkg::Remove
 {
     enum class Purge : bool
@@ -14,6 +28,20 @@ namespace vcpkg::Remove
         YES
     };
 
+    // Removes the installed files of every package in `specs` concurrently. Each status change of all of them is
+    // recorded as a single status database update. Returns the time spent removing the files of each package.
+    std::vector<ElapsedTime> remove_installed_packages(Filesystem& fs,
+                                                       const InstalledPaths& installed,
+                                                       View<PackageSpec> specs,
+                                                       StatusParagraphs* status_db);
+
+    // Removes the files of every package in `actions` concurrently and records all of their status changes in
+    // a single status database update. Returns the time spent on each action.
+    std::vector<ElapsedTime> perform_remove_plan(const VcpkgPaths& paths,
+                                                 View<Dependencies::RemovePlanAction> actions,
+                                                 const Purge purge,
+                                                 StatusParagraphs* status_db);
+
     void perform_remove_plan_action(const VcpkgPaths& paths,
                                     const Dependencies::RemovePlanAction& action,
                                     const Purge purge,
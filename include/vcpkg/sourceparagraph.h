@@ -132,6 +132,24 @@ namespace vcpkg
         friend bool operator!=(const SourceControlFile& lhs, const SourceControlFile& rhs) { return !(lhs == rhs); }
     };
 
+    /// <summary>
+    /// The name and version of a port, read without building or validating the rest of its manifest or CONTROL file:
+    /// dependencies, features, supports expressions and the license are skipped. For callers that only need to know
+    /// which version of which port a directory holds.
+    /// </summary>
+    struct PortIdentity
+    {
+        static Parse::ParseExpected<PortIdentity> parse_manifest_object(StringView origin, const Json::Object& object);
+
+        static Parse::ParseExpected<PortIdentity> parse_control_file(
+            StringView origin, std::vector<Parse::Paragraph>&& control_paragraphs);
+
+        std::string name;
+        SchemedVersion schemed_version;
+
+        Version to_version() const { return schemed_version.version; }
+    };
+
     Json::Object serialize_manifest(const SourceControlFile& scf);
     Json::Object serialize_debug_manifest(const SourceControlFile& scf);
 
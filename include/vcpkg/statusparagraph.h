@@ -35,6 +35,7 @@ namespace vcpkg
     {
         StatusParagraph() noexcept;
         explicit StatusParagraph(Parse::Paragraph&& fields);
+        explicit StatusParagraph(View<Parse::ParagraphFieldView> fields);
 
         bool is_installed() const { return want == Want::INSTALL && state == InstallState::INSTALLED; }
 
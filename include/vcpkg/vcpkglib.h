@@ -5,6 +5,7 @@
 #include <vcpkg/fwd/installedpaths.h>
 
 #include <vcpkg/base/sortedvector.h>
+#include <vcpkg/base/view.h>
 
 #include <vcpkg/statusparagraphs.h>
 
@@ -13,6 +14,8 @@ namespace vcpkg
     StatusParagraphs database_load_check(Filesystem& fs, const InstalledPaths& installed);
 
     void write_update(Filesystem& fs, const InstalledPaths& installed, const StatusParagraph& p);
+    // Writes all of `pghs` as a single update, so that they are applied to the status database together.
+    void write_update(Filesystem& fs, const InstalledPaths& installed, View<StatusParagraph> pghs);
 
     struct StatusParagraphAndAssociatedFiles
     {
@@ -59,6 +59,7 @@ namespace vcpkg
     }
 
     struct BinaryParagraph;
+    struct CompiledVersionDb;
     struct Environment;
     struct PackageSpec;
     struct Triplet;
@@ -80,8 +81,12 @@ namespace vcpkg
         ~VcpkgPaths();
 
         Path package_dir(const PackageSpec& spec) const;
+        // The BUILDTREES_DIR passed to the port scripts; each compile triplet variant gets its own so that variants
+        // of one port can be built side by side.
+        Path buildtrees_root(const PackageSpec& spec) const;
         Path build_dir(const PackageSpec& spec) const;
-        Path build_dir(const std::string& package_name) const;
+        // The build directories of a port for the default layout and for every compile triplet variant built so far.
+        std::vector<Path> build_dirs(const std::string& package_name) const;
         Path build_info_file_path(const PackageSpec& spec) const;
 
         bool is_valid_triplet(Triplet t) const;
@@ -107,8 +112,13 @@ namespace vcpkg
 
         Path baselines_output() const;
         Path versions_output() const;
+        Path compiled_versions_db() const;
+
+        // The compiled builtin versions database, if it is at least as new as builtin_registry_versions.
+        const CompiledVersionDb* get_compiled_versions_db() const;
 
         Path vcpkg_bin2sth_compiler_config_dir;
+        Path vcpkg_bin2sth_compiler_index;
 
         const Path original_cwd;
         const Path root;
@@ -141,6 +151,8 @@ namespace vcpkg
         std::string get_current_git_sha_baseline_message() const;
         ExpectedS<Path> git_checkout_port(StringView port_name, StringView git_tree, const Path& dot_git_dir) const;
         ExpectedS<std::string> git_show(const std::string& treeish, const Path& dot_git_dir) const;
+        // The git tree id of builtin_registry_versions, if it has no uncommitted or untracked changes.
+        ExpectedS<std::string> git_builtin_registry_versions_tree() const;
 
         const DownloadManager& get_download_manager() const;
 
@@ -0,0 +1,678 @@
+#include <vcpkg/base/checks.h>
+#include <vcpkg/base/chrono.h>
+#include <vcpkg/base/files.h>
+#include <vcpkg/base/hash.h>
+#include <vcpkg/base/json.h>
+#include <vcpkg/base/strings.h>
+#include <vcpkg/base/stringview.h>
+#include <vcpkg/base/system.print.h>
+
+#include <vcpkg/cmakevars.h>
+#include <vcpkg/dependencies.h>
+#include <vcpkg/paragraphs.h>
+#include <vcpkg/platform-expression.h>
+#include <vcpkg/portfileprovider.h>
+#include <vcpkg/sourceparagraph.h>
+#include <vcpkg/statusparagraphs.h>
+
+#include <string.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <functional>
+#include <map>
+#include <memory>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+using namespace vcpkg;
+
+namespace
+{
+    struct BenchArgs
+    {
+        BenchArgs(int argc, char** argv)
+        {
+            char** it = argv + 1; // skip the name of the program
+            char** last = argv + argc;
+
+            for (; it != last; ++it)
+            {
+                auto arg = StringView(*it, strlen(*it));
+                if (arg == "/?")
+                {
+                    print_help_and_exit();
+                }
+
+                auto pr = split_arg(arg);
+                auto key = pr.first;
+                auto value = pr.second;
+                if (key == "h" || key == "help")
+                {
+                    print_help_and_exit();
+                }
+
+                if (key == "filter")
+                {
+                    filter = value.to_string();
+                }
+                else if (key == "output")
+                {
+                    output = value.to_string();
+                }
+                else if (key == "fixtures")
+                {
+                    fixtures = value.to_string();
+                }
+                else if (key == "min-iterations")
+                {
+                    min_iterations = parse_count(key, value);
+                }
+                else if (key == "min-time-ms")
+                {
+                    min_time_ms = parse_count(key, value);
+                }
+                else if (key == "scale")
+                {
+                    scale = parse_count(key, value);
+                }
+                else if (key == "keep-fixtures")
+                {
+                    keep_fixtures = true;
+                }
+                else
+                {
+                    print2("Unknown option: ", key, "\n\n");
+                    print_help_and_exit(true);
+                }
+            }
+
+            if (scale < 2)
+            {
+                print2(Color::error, "--scale must be at least 2\n\n");
+                print_help_and_exit(true);
+            }
+        }
+
+        // returns {arg, ""} when there isn't an `=`
+        // skips preceding `-`s
+        std::pair<StringView, StringView> split_arg(StringView arg)
+        {
+            auto first = std::find_if(arg.begin(), arg.end(), [](char c) { return c != '-'; });
+            auto division = std::find(first, arg.end(), '=');
+            if (division == arg.end())
+            {
+                return {StringView(first, arg.end()), StringView(arg.end(), arg.end())};
+            }
+            else
+            {
+                return {StringView(first, division), StringView(division + 1, arg.end())};
+            }
+        }
+
+        size_t parse_count(StringView key, StringView value)
+        {
+            auto maybe_count = Strings::strto<int>(value.to_string());
+            if (auto count = maybe_count.get())
+            {
+                if (*count >= 0)
+                {
+                    return static_cast<size_t>(*count);
+                }
+            }
+
+            print2(Color::error, "Invalid value for --", key, ": ", value, "\n\n");
+            print_help_and_exit(true);
+        }
+
+        [[noreturn]] void print_help_and_exit(bool invalid = false)
+        {
+            constexpr auto help =
+                R"(
+Usage: vcpkg-bench <options>
+
+Generates synthetic fixtures and times vcpkg's hot paths against them.
+
+Options:
+  --filter=...              Only run benchmarks whose name contains this text
+  --output=...              Write the results as JSON to this file
+  --fixtures=...            Directory in which to create vcpkg-bench-fixtures/; default .
+  --keep-fixtures           Don't delete vcpkg-bench-fixtures/ afterwards
+  --scale=...               Number of generated ports; default 1000
+  --min-iterations=...      Minimum number of timed runs of each benchmark; default 5
+  --min-time-ms=...         Minimum total time spent timing each benchmark; default 500
+)";
+
+            auto color = invalid ? Color::error : Color::success;
+
+            print2(color, help);
+            if (invalid)
+            {
+                Checks::exit_fail(VCPKG_LINE_INFO);
+            }
+            else
+            {
+                Checks::exit_success(VCPKG_LINE_INFO);
+            }
+        }
+
+        std::string filter;
+        std::string output;
+        std::string fixtures = ".";
+        size_t scale = 1000;
+        size_t min_iterations = 5;
+        size_t min_time_ms = 500;
+        bool keep_fixtures = false;
+    };
+
+    // Timings of a single benchmark, in nanoseconds.
+    struct BenchResult
+    {
+        std::string name;
+        std::vector<uint64_t> samples;
+
+        uint64_t min() const { return *std::min_element(samples.begin(), samples.end()); }
+        uint64_t max() const { return *std::max_element(samples.begin(), samples.end()); }
+        uint64_t median() const
+        {
+            auto sorted = samples;
+            std::sort(sorted.begin(), sorted.end());
+            return sorted[sorted.size() / 2];
+        }
+        double mean() const
+        {
+            double sum = 0;
+            for (auto sample : samples)
+                sum += static_cast<double>(sample);
+            return sum / static_cast<double>(samples.size());
+        }
+        double stddev() const
+        {
+            const auto m = mean();
+            double sum = 0;
+            for (auto sample : samples)
+            {
+                const auto delta = static_cast<double>(sample) - m;
+                sum += delta * delta;
+            }
+            return std::sqrt(sum / static_cast<double>(samples.size()));
+        }
+    };
+
+    struct BenchHarness
+    {
+        explicit BenchHarness(const BenchArgs& args) : m_args(args) { }
+
+        // Runs `body` once untimed to warm caches, then repeatedly until both the minimum iteration count and the
+        // minimum total time are reached.
+        void run(StringView name, const std::function<void()>& body)
+        {
+            if (!Strings::contains(name, m_args.filter))
+            {
+                return;
+            }
+
+            body();
+
+            BenchResult result;
+            result.name = name.to_string();
+            const auto min_time = std::chrono::milliseconds(m_args.min_time_ms);
+            const auto total = ElapsedTimer::create_started();
+            do
+            {
+                const auto timer = ElapsedTimer::create_started();
+                body();
+                result.samples.push_back(
+                    static_cast<uint64_t>(timer.elapsed().as<std::chrono::nanoseconds>().count()));
+            } while (result.samples.size() < std::max<size_t>(m_args.min_iterations, 1) ||
+                     total.elapsed().as<std::chrono::milliseconds>() < min_time);
+
+            print2(Strings::format("%-44s %8zu iterations  median %12.3f ms  min %12.3f ms\n",
+                                   result.name.c_str(),
+                                   result.samples.size(),
+                                   static_cast<double>(result.median()) / 1e6,
+                                   static_cast<double>(result.min()) / 1e6));
+            m_results.push_back(std::move(result));
+        }
+
+        Json::Object to_json() const
+        {
+            Json::Array benchmarks;
+            for (auto&& result : m_results)
+            {
+                Json::Object obj;
+                obj.insert("name", Json::Value::string(result.name));
+                obj.insert("iterations", Json::Value::integer(static_cast<int64_t>(result.samples.size())));
+                obj.insert("min_ns", Json::Value::integer(static_cast<int64_t>(result.min())));
+                obj.insert("median_ns", Json::Value::integer(static_cast<int64_t>(result.median())));
+                obj.insert("mean_ns", Json::Value::number(result.mean()));
+                obj.insert("max_ns", Json::Value::integer(static_cast<int64_t>(result.max())));
+                obj.insert("stddev_ns", Json::Value::number(result.stddev()));
+                benchmarks.push_back(std::move(obj));
+            }
+
+            Json::Object root;
+            root.insert("scale", Json::Value::integer(static_cast<int64_t>(m_args.scale)));
+            root.insert("benchmarks", std::move(benchmarks));
+            return root;
+        }
+
+    private:
+        const BenchArgs& m_args;
+        std::vector<BenchResult> m_results;
+    };
+
+    std::string port_name(size_t i) { return Strings::format("port-%05zu", i); }
+
+    Version port_version(size_t i) { return Version{Strings::format("1.0.%zu", i), 0}; }
+
+    constexpr StringLiteral PLATFORM_EXPRESSIONS[] = {
+        "windows",
+        "!windows",
+        "linux | osx",
+        "!(windows & arm)",
+        "(x64 | arm64) & !uwp",
+        "windows & !static & (x86 | x64)",
+        "!(uwp | arm | android) & (linux | osx | freebsd)",
+        "(windows & !uwp & !arm) | (linux & !static) | (osx & arm64)",
+    };
+
+    // Port `i` depends on port `i - 1`, making the dependency graph as deep as the number of ports, and on a few
+    // lower ports through platform expressions, features, and version constraints.
+    std::string make_port_manifest(size_t i)
+    {
+        Json::Array dependencies;
+        if (i > 0)
+        {
+            dependencies.push_back(Json::Value::string(port_name(i - 1)));
+        }
+
+        if (i > 2)
+        {
+            Json::Object dep;
+            dep.insert("name", Json::Value::string(port_name(i / 2)));
+            const auto& platform = PLATFORM_EXPRESSIONS[i % std::size(PLATFORM_EXPRESSIONS)];
+            dep.insert("platform", Json::Value::string(platform.to_string()));
+            dependencies.push_back(std::move(dep));
+        }
+
+        if (i > 3)
+        {
+            Json::Object dep;
+            dep.insert("name", Json::Value::string(port_name(i / 3)));
+            Json::Array features;
+            features.push_back(Json::Value::string("extra"));
+            dep.insert("features", std::move(features));
+            dep.insert("version>=", Json::Value::string(port_version(i / 3).text()));
+            dependencies.push_back(std::move(dep));
+        }
+
+        Json::Object extra;
+        extra.insert("description", Json::Value::string("Optional functionality"));
+        if (i > 4)
+        {
+            Json::Array extra_dependencies;
+            extra_dependencies.push_back(Json::Value::string(port_name(i / 4)));
+            extra.insert("dependencies", std::move(extra_dependencies));
+        }
+
+        Json::Object features;
+        features.insert("extra", std::move(extra));
+
+        Json::Object manifest;
+        manifest.insert("name", Json::Value::string(port_name(i)));
+        manifest.insert("version", Json::Value::string(port_version(i).text()));
+        manifest.insert("description", Json::Value::string(Strings::concat("Generated port number ", i)));
+        manifest.insert("license", Json::Value::string("MIT"));
+        manifest.insert("supports", Json::Value::string("!(uwp & arm)"));
+        manifest.insert("dependencies", std::move(dependencies));
+        manifest.insert("features", std::move(features));
+        return Json::stringify(manifest, {});
+    }
+
+    std::string make_baseline(size_t entries)
+    {
+        Json::Object ports;
+        for (size_t i = 0; i < entries; ++i)
+        {
+            Json::Object version;
+            version.insert("baseline", Json::Value::string(port_version(i).text()));
+            version.insert("port-version", Json::Value::integer(static_cast<int64_t>(i % 3)));
+            ports.insert(port_name(i), std::move(version));
+        }
+
+        Json::Object baseline;
+        baseline.insert("default", std::move(ports));
+        return Json::stringify(baseline, {});
+    }
+
+    std::string make_big_file(size_t size)
+    {
+        std::string contents(size, '\0');
+        uint32_t state = 0x12345678;
+        for (auto& ch : contents)
+        {
+            // xorshift, so that the file doesn't compress to nothing on filesystems that do that
+            state ^= state << 13;
+            state ^= state >> 17;
+            state ^= state << 5;
+            ch = static_cast<char>(state);
+        }
+
+        return contents;
+    }
+
+    // The fixtures live in a vcpkg-bench-fixtures directory created inside the directory the user chose, and are
+    // marked so that only a directory that vcpkg-bench created is ever deleted.
+    struct Fixtures
+    {
+        Path root;
+        Path ports;
+        Path baseline;
+        Path big_file;
+        size_t port_count;
+
+        Fixtures(Filesystem& fs, const Path& parent, size_t port_count_)
+            : root(parent / "vcpkg-bench-fixtures")
+            , ports(root / "ports")
+            , baseline(root / "versions" / "baseline.json")
+            , big_file(root / "big-file.bin")
+            , port_count(port_count_)
+        {
+            print2("Generating fixtures in ", root, "...\n");
+            if (fs.exists(root, VCPKG_LINE_INFO))
+            {
+                Checks::check_exit(VCPKG_LINE_INFO,
+                                   fs.exists(marker(), VCPKG_LINE_INFO),
+                                   "Error: %s already exists and was not created by vcpkg-bench",
+                                   root);
+                fs.remove_all(root, VCPKG_LINE_INFO);
+            }
+
+            fs.write_contents_and_dirs(marker(), "", VCPKG_LINE_INFO);
+            for (size_t i = 0; i < port_count; ++i)
+            {
+                fs.write_contents_and_dirs(ports / port_name(i) / "vcpkg.json", make_port_manifest(i), VCPKG_LINE_INFO);
+            }
+
+            fs.write_contents_and_dirs(baseline, make_baseline(10000), VCPKG_LINE_INFO);
+            fs.write_contents(big_file, make_big_file(64 << 20), VCPKG_LINE_INFO);
+        }
+
+        Path marker() const { return root / ".vcpkg-bench-fixtures"; }
+    };
+
+    // Every triplet looks like x64-linux, and tag information is never needed to create a plan.
+    struct BenchCMakeVarProvider final : CMakeVars::CMakeVarProvider
+    {
+        using SMap = std::unordered_map<std::string, std::string>;
+
+        void load_generic_triplet_vars(Triplet triplet, Optional<bin2sth::CompileTriplet>) const override
+        {
+            generic_triplet_vars.emplace(triplet, triplet_vars());
+        }
+
+        void load_dep_info_vars(Span<const PackageSpec> specs, Triplet) const override
+        {
+            for (auto&& spec : specs)
+                dep_info_vars.emplace(spec, triplet_vars());
+        }
+
+        void load_tag_vars(Span<const FullPackageSpec> specs,
+                           const PortFileProvider::PortFileProvider&,
+                           Triplet) const override
+        {
+            for (auto&& spec : specs)
+                tag_vars.emplace(spec.package_spec, triplet_vars());
+        }
+
+        Optional<const SMap&> get_generic_triplet_vars(Triplet triplet) const override
+        {
+            return find_vars(generic_triplet_vars, triplet);
+        }
+
+        Optional<const SMap&> get_dep_info_vars(const PackageSpec& spec) const override
+        {
+            return find_vars(dep_info_vars, spec);
+        }
+
+        Optional<const SMap&> get_tag_vars(const PackageSpec& spec) const override
+        {
+            return find_vars(tag_vars, spec);
+        }
+
+    private:
+        static SMap triplet_vars()
+        {
+            return {
+                {"VCPKG_TARGET_ARCHITECTURE", "x64"},
+                {"VCPKG_CMAKE_SYSTEM_NAME", "Linux"},
+                {"VCPKG_LIBRARY_LINKAGE", "static"},
+                {"VCPKG_CRT_LINKAGE", "dynamic"},
+            };
+        }
+
+        template<class Key>
+        static Optional<const SMap&> find_vars(const std::unordered_map<Key, SMap>& vars, const Key& key)
+        {
+            auto it = vars.find(key);
+            if (it == vars.end()) return nullopt;
+            return it->second;
+        }
+
+        mutable std::unordered_map<PackageSpec, SMap> dep_info_vars;
+        mutable std::unordered_map<PackageSpec, SMap> tag_vars;
+        mutable std::unordered_map<Triplet, SMap> generic_triplet_vars;
+    };
+
+    // Serves the generated ports as a registry with exactly one version of each port.
+    struct BenchVersionedProvider final : PortFileProvider::IVersionedPortfileProvider,
+                                          PortFileProvider::IBaselineProvider,
+                                          PortFileProvider::IOverlayProvider
+    {
+        explicit BenchVersionedProvider(const std::unordered_map<std::string, SourceControlFileAndLocation>& ports)
+            : m_ports(ports)
+        {
+            for (auto&& port : m_ports)
+            {
+                m_versions[port.first].push_back(port.second.to_version());
+            }
+        }
+
+        View<Version> get_port_versions(StringView port_name) const override
+        {
+            auto it = m_versions.find(port_name.to_string());
+            if (it == m_versions.end()) return {};
+            return it->second;
+        }
+
+        ExpectedS<const SourceControlFileAndLocation&> get_control_file(const VersionSpec& version_spec) const override
+        {
+            auto it = m_ports.find(version_spec.port_name);
+            if (it == m_ports.end() || it->second.to_version() != version_spec.version)
+            {
+                return Strings::concat("no such port version: ", version_spec.port_name, '@', version_spec.version);
+            }
+
+            return it->second;
+        }
+
+        void load_all_control_files(std::map<std::string, const SourceControlFileAndLocation*>& out) const override
+        {
+            for (auto&& port : m_ports)
+                out.emplace(port.first, &port.second);
+        }
+
+        Optional<Version> get_baseline_version(StringView port_name) const override
+        {
+            auto it = m_ports.find(port_name.to_string());
+            if (it == m_ports.end()) return nullopt;
+            return it->second.to_version();
+        }
+
+        Optional<const SourceControlFileAndLocation&> get_control_file(StringView) const override { return nullopt; }
+        Optional<Version> get_port_version(StringView) const override { return nullopt; }
+
+    private:
+        const std::unordered_map<std::string, SourceControlFileAndLocation>& m_ports;
+        std::unordered_map<std::string, std::vector<Version>> m_versions;
+    };
+
+    std::unordered_map<std::string, SourceControlFileAndLocation> load_ports(const Filesystem& fs,
+                                                                            const Fixtures& fixtures)
+    {
+        std::unordered_map<std::string, SourceControlFileAndLocation> ports;
+        for (size_t i = 0; i < fixtures.port_count; ++i)
+        {
+            const auto port_dir = fixtures.ports / port_name(i);
+            auto maybe_scf = Paragraphs::try_load_port(fs, port_dir);
+            if (!maybe_scf)
+            {
+                print_error_message(maybe_scf.error());
+                Checks::exit_fail(VCPKG_LINE_INFO);
+            }
+
+            ports.emplace(port_name(i), SourceControlFileAndLocation{std::move(*maybe_scf.get()), port_dir});
+        }
+
+        return ports;
+    }
+
+    void run_benchmarks(BenchHarness& harness, Filesystem& fs, const Fixtures& fixtures)
+    {
+        const auto baseline_text = fs.read_contents(fixtures.baseline, VCPKG_LINE_INFO);
+        harness.run("json/parse-baseline-10k", [&] {
+            auto parsed = Json::parse(baseline_text);
+            Checks::check_exit(VCPKG_LINE_INFO, parsed.has_value());
+        });
+
+        const auto manifest_text = fs.read_contents(fixtures.ports / port_name(fixtures.port_count - 1) / "vcpkg.json",
+                                                    VCPKG_LINE_INFO);
+        const auto baseline_json = Json::parse(baseline_text).value_or_exit(VCPKG_LINE_INFO).first;
+        harness.run("json/stringify-baseline-10k", [&] { (void)Json::stringify(baseline_json, {}); });
+
+        harness.run("platform-expression/parse", [&] {
+            for (size_t i = 0; i < 1000; ++i)
+            {
+                for (auto&& expression : PLATFORM_EXPRESSIONS)
+                {
+                    auto parsed = PlatformExpression::parse_platform_expression(
+                        expression, PlatformExpression::MultipleBinaryOperators::Deny);
+                    Checks::check_exit(VCPKG_LINE_INFO, parsed.has_value());
+                }
+            }
+        });
+
+        std::vector<PlatformExpression::Expr> expressions;
+        for (auto&& expression : PLATFORM_EXPRESSIONS)
+        {
+            expressions.push_back(PlatformExpression::parse_platform_expression(
+                                      expression, PlatformExpression::MultipleBinaryOperators::Deny)
+                                      .value_or_exit(VCPKG_LINE_INFO));
+        }
+
+        const PlatformExpression::Context context{
+            {"VCPKG_TARGET_ARCHITECTURE", "x64"},
+            {"VCPKG_CMAKE_SYSTEM_NAME", "Linux"},
+            {"VCPKG_LIBRARY_LINKAGE", "static"},
+            {"VCPKG_CRT_LINKAGE", "dynamic"},
+        };
+        harness.run("platform-expression/evaluate", [&] {
+            size_t matched = 0;
+            for (size_t i = 0; i < 10000; ++i)
+            {
+                for (auto&& expression : expressions)
+                {
+                    matched += expression.evaluate(context);
+                }
+            }
+
+            Checks::check_exit(VCPKG_LINE_INFO, matched != 0);
+        });
+
+        const auto lowered_context = PlatformExpression::EvaluationContext::from_cmake_vars(context);
+        harness.run("platform-expression/evaluate-lowered", [&] {
+            size_t matched = 0;
+            for (size_t i = 0; i < 10000; ++i)
+            {
+                for (auto&& expression : expressions)
+                {
+                    matched += expression.evaluate(lowered_context);
+                }
+            }
+
+            Checks::check_exit(VCPKG_LINE_INFO, matched != 0);
+        });
+
+        harness.run("hash/sha256-file-64MiB", [&] {
+            (void)Hash::get_file_hash(VCPKG_LINE_INFO, fs, fixtures.big_file, Hash::Algorithm::Sha256);
+        });
+
+        harness.run("hash/sha256-manifest", [&] {
+            for (size_t i = 0; i < 1000; ++i)
+            {
+                (void)Hash::get_string_hash(manifest_text, Hash::Algorithm::Sha256);
+            }
+        });
+
+        harness.run("ports/load-all", [&] { (void)load_ports(fs, fixtures); });
+
+        const auto ports = load_ports(fs, fixtures);
+        const auto triplet = Triplet::from_canonical_name("x64-linux");
+        const auto top = port_name(fixtures.port_count - 1);
+
+        harness.run("plan/feature-install-deep-graph", [&] {
+            PortFileProvider::MapPortFileProvider provider(ports);
+            BenchCMakeVarProvider var_provider;
+            const StatusParagraphs status_db;
+            const FullPackageSpec spec{PackageSpec{top, triplet}, {"core", "extra"}};
+            auto plan =
+                Dependencies::create_feature_install_plan(provider, var_provider, {&spec, 1}, status_db, {triplet});
+            Checks::check_exit(VCPKG_LINE_INFO, plan.install_actions.size() == fixtures.port_count);
+        });
+
+        harness.run("plan/versioned-install-deep-graph", [&] {
+            BenchVersionedProvider provider(ports);
+            BenchCMakeVarProvider var_provider;
+            Dependency dep;
+            dep.name = top;
+            dep.features.push_back("extra");
+            auto plan = Dependencies::create_versioned_install_plan(provider,
+                                                                    provider,
+                                                                    provider,
+                                                                    var_provider,
+                                                                    {dep},
+                                                                    {},
+                                                                    PackageSpec{"toplevel", triplet},
+                                                                    triplet,
+                                                                    Dependencies::UnsupportedPortAction::Error);
+            Checks::check_exit(VCPKG_LINE_INFO,
+                               plan.value_or_exit(VCPKG_LINE_INFO).install_actions.size() == fixtures.port_count);
+        });
+    }
+}
+
+int main(int argc, char** argv)
+{
+    const BenchArgs args(argc, argv);
+    auto& fs = get_real_filesystem();
+    const Fixtures fixtures(fs, fs.absolute(args.fixtures, VCPKG_LINE_INFO), args.scale);
+
+    BenchHarness harness(args);
+    run_benchmarks(harness, fs, fixtures);
+
+    if (!args.output.empty())
+    {
+        fs.write_contents_and_dirs(args.output, Json::stringify(harness.to_json(), {}), VCPKG_LINE_INFO);
+        print2("Results written to ", args.output, '\n');
+    }
+
+    if (!args.keep_fixtures)
+    {
+        fs.remove_all(fixtures.root, VCPKG_LINE_INFO);
+    }
+
+    Checks::exit_success(VCPKG_LINE_INFO);
+}
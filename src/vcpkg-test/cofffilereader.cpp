@@ -0,0 +1,100 @@
+#include <catch2/catch.hpp>
+
+#include <vcpkg/base/cofffilereader.h>
+#include <vcpkg/base/strings.h>
+
+#include <string>
+#include <vector>
+
+using namespace vcpkg;
+
+namespace
+{
+    void append_u16(std::string& target, uint16_t value)
+    {
+        target.push_back(static_cast<char>(value & 0xFF));
+        target.push_back(static_cast<char>(value >> 8));
+    }
+
+    void append_u32(std::string& target, uint32_t value)
+    {
+        append_u16(target, static_cast<uint16_t>(value & 0xFFFF));
+        append_u16(target, static_cast<uint16_t>(value >> 16));
+    }
+
+    void append_member_header(std::string& target, StringView name, size_t size)
+    {
+        const auto padded = [](std::string field, size_t width) {
+            field.resize(width, ' ');
+            return field;
+        };
+
+        target.append(padded(name.to_string(), 16));
+        target.append(padded("0", 12));
+        target.append(padded("", 6));
+        target.append(padded("", 6));
+        target.append(padded("644", 8));
+        target.append(padded(std::to_string(size), 10));
+        target.append("`\n");
+    }
+
+    // An archive containing an AMD64 object, an AMD64 import object, and a member of unknown machine type; the
+    // second linker member lists some of them more than once, out of order, and with null offsets.
+    std::string make_archive()
+    {
+        std::string archive = "!<arch>\n";
+        append_member_header(archive, "/", 4);
+        append_u32(archive, 0);
+
+        static constexpr uint32_t member_count = 6;
+        const uint32_t second_linker_member_size = 4 + 4 * member_count + 4;
+        const uint32_t first_member = static_cast<uint32_t>(archive.size() + 60 + second_linker_member_size);
+        const uint32_t member_stride = 60 + 8;
+        append_member_header(archive, "/", second_linker_member_size);
+        append_u32(archive, member_count);
+        append_u32(archive, first_member + 2 * member_stride);
+        append_u32(archive, first_member);
+        append_u32(archive, 0);
+        append_u32(archive, first_member + member_stride);
+        append_u32(archive, first_member);
+        append_u32(archive, 0);
+        append_u32(archive, 0); // number of symbols
+
+        append_member_header(archive, "/0", 8);
+        append_u16(archive, static_cast<uint16_t>(MachineType::AMD64));
+        archive.append(6, '\0');
+
+        append_member_header(archive, "/1", 8);
+        append_u16(archive, 0x0000);
+        append_u16(archive, 0xFFFF);
+        append_u16(archive, 0);
+        append_u16(archive, static_cast<uint16_t>(MachineType::AMD64));
+
+        append_member_header(archive, "/2", 8);
+        archive.append(8, '\0');
+        return archive;
+    }
+
+    std::string make_image(MachineType machine)
+    {
+        std::string image(0x3c, '\0');
+        append_u32(image, 0x40);
+        image.append("PE");
+        image.append(2, '\0');
+        append_u16(image, static_cast<uint16_t>(machine));
+        image.append(18, '\0');
+        return image;
+    }
+}
+
+TEST_CASE ("read_lib_machine_types", "[cofffilereader]")
+{
+    const auto archive = make_archive();
+    CHECK(read_lib_machine_types(archive) == std::vector<MachineType>{MachineType::AMD64});
+}
+
+TEST_CASE ("read_dll_machine_type", "[cofffilereader]")
+{
+    CHECK(read_dll_machine_type(make_image(MachineType::ARM64)) == MachineType::ARM64);
+    CHECK(read_dll_machine_type(make_image(MachineType::I386)) == MachineType::I386);
+}
@@ -70,6 +70,7 @@ TEST_CASE ("list of commands is correct", "[commands]")
         "x-check-support",
         "x-ci-clean",
         "x-ci-verify-versions",
+        "x-compile-versions-db",
         "x-download",
         "x-generate-default-message-map",
         "x-history",
@@ -0,0 +1,58 @@
+#include <catch2/catch.hpp>
+
+#include <vcpkg/compile-triplet.h>
+
+#include <vcpkg-test/util.h>
+
+using namespace vcpkg;
+using namespace vcpkg::bin2sth;
+
+TEST_CASE ("CompileTriplet is interned", "[compile-triplet]")
+{
+    const auto x64_linux = Triplet::from_canonical_name("x64-linux");
+    const auto arm64_linux = Triplet::from_canonical_name("arm64-linux");
+
+    const CompileTriplet gcc("gcc", "O2", "NONE", x64_linux);
+    CHECK(gcc.canonical_name() == "gcc_O2_NONE");
+    CHECK(gcc.to_string() == "gcc_O2_NONE");
+    CHECK(gcc.compiler_tag() == "gcc");
+    CHECK(gcc.optimization_tag() == "O2");
+    CHECK(gcc.obfuscation_tag() == "NONE");
+    CHECK(gcc.triplet() == x64_linux);
+
+    const CompileTriplet same("gcc", "O2", "NONE", x64_linux);
+    CHECK(gcc == same);
+    CHECK(&gcc.canonical_name() == &same.canonical_name());
+    CHECK(gcc.hash_code() == same.hash_code());
+
+    const CompileTriplet other_triplet("gcc", "O2", "NONE", arm64_linux);
+    CHECK(gcc != other_triplet);
+    CHECK(gcc.canonical_name() == other_triplet.canonical_name());
+
+    auto retargeted = gcc;
+    retargeted.with_triplet(arm64_linux);
+    CHECK(retargeted == other_triplet);
+
+    const CompileTriplet clang("clang", "O2", "NONE", x64_linux);
+    CHECK(clang < gcc);
+    CHECK_FALSE(gcc < clang);
+    CHECK_FALSE(gcc < same);
+}
+
+TEST_CASE ("CompileTriplet::from_canonical_name", "[compile-triplet]")
+{
+    const auto x64_linux = Triplet::from_canonical_name("x64-linux");
+
+    CHECK_FALSE(CompileTriplet::from_canonical_name("", x64_linux).has_value());
+
+    // the first time a name is seen it is split into tags, then it is found in the registry
+    auto parsed = CompileTriplet::from_canonical_name("msvc_Od_LLVM", x64_linux);
+    REQUIRE(parsed.has_value());
+    CHECK(parsed.value_or_exit(VCPKG_LINE_INFO).compiler_tag() == "msvc");
+    CHECK(parsed.value_or_exit(VCPKG_LINE_INFO).optimization_tag() == "Od");
+    CHECK(parsed.value_or_exit(VCPKG_LINE_INFO).obfuscation_tag() == "LLVM");
+
+    auto found = CompileTriplet::from_canonical_name("msvc_Od_LLVM", x64_linux);
+    CHECK(found == parsed);
+    CHECK(found == CompileTriplet("msvc", "Od", "LLVM", x64_linux));
+}
@@ -0,0 +1,155 @@
+#include <catch2/catch.hpp>
+
+#include <vcpkg/base/files.h>
+
+#include <vcpkg/compiledversiondb.h>
+#include <vcpkg/registries.h>
+
+#include <vcpkg-test/util.h>
+
+using namespace vcpkg;
+
+namespace
+{
+    constexpr StringLiteral ZLIB_TREE = "0123456789abcdef0123456789abcdef01234567";
+    constexpr StringLiteral FMT_TREE = "fedcba9876543210fedcba9876543210fedcba98";
+
+    VersionDbEntry make_entry(std::string text, int port_version, VersionScheme scheme, StringView git_tree)
+    {
+        VersionDbEntry entry;
+        entry.version = Version{std::move(text), port_version};
+        entry.scheme = scheme;
+        entry.git_tree = git_tree.to_string();
+        return entry;
+    }
+
+    std::vector<CompiledVersionDb::PortVersions> make_ports()
+    {
+        std::vector<CompiledVersionDb::PortVersions> ports;
+        ports.push_back({"zlib",
+                         {make_entry("1.2.12", 0, VersionScheme::Relaxed, ZLIB_TREE),
+                          make_entry("1.2.11", 13, VersionScheme::Relaxed, FMT_TREE)}});
+        ports.push_back({"fmt", {make_entry("2022-01-01", 1, VersionScheme::Date, FMT_TREE)}});
+        return ports;
+    }
+
+    constexpr StringLiteral SOURCE_KEY = "b074f0395b2e3ec6f5be845fec3a1dbdb332967a";
+
+    Optional<CompiledVersionDb> load_from_bytes(const Path& temp_dir, StringView bytes)
+    {
+        auto& fs = get_real_filesystem();
+        const auto db_path = temp_dir / "versions.db";
+        fs.write_contents(db_path, bytes.to_string(), VCPKG_LINE_INFO);
+        return CompiledVersionDb::from_mapping(fs.map_for_read(db_path, VCPKG_LINE_INFO));
+    }
+}
+
+TEST_CASE ("compiled versions database round trip", "[versions]")
+{
+    auto& fs = get_real_filesystem();
+    const auto temp_dir = Test::base_temporary_directory() / "compiled-versions-db";
+    fs.remove_all(temp_dir, VCPKG_LINE_INFO);
+    fs.create_directories(temp_dir, VCPKG_LINE_INFO);
+
+    const std::map<std::string, Version, std::less<>> baseline{
+        {"zlib", Version{"1.2.12", 0}},
+        {"baseline-only", Version{"1.0", 2}},
+    };
+    auto bytes = CompiledVersionDb::compile(make_ports(), baseline, SOURCE_KEY).value_or_exit(VCPKG_LINE_INFO);
+
+    // compiling is deterministic, whatever the order of the ports
+    auto reversed_ports = make_ports();
+    std::reverse(reversed_ports.begin(), reversed_ports.end());
+    CHECK(CompiledVersionDb::compile(std::move(reversed_ports), baseline, SOURCE_KEY)
+              .value_or_exit(VCPKG_LINE_INFO) == bytes);
+
+    auto maybe_db = load_from_bytes(temp_dir, bytes);
+    auto db = maybe_db.get();
+    REQUIRE(db);
+    CHECK(db->source_key() == SOURCE_KEY);
+
+    auto maybe_zlib = db->get_port_versions("zlib");
+    auto zlib = maybe_zlib.get();
+    REQUIRE(zlib);
+    REQUIRE(zlib->size() == 2);
+    CHECK((*zlib)[0].version == Version{"1.2.12", 0});
+    CHECK((*zlib)[0].scheme == VersionScheme::Relaxed);
+    CHECK((*zlib)[0].git_tree == ZLIB_TREE);
+    CHECK((*zlib)[1].version == Version{"1.2.11", 13});
+    CHECK((*zlib)[1].git_tree == FMT_TREE);
+
+    auto maybe_fmt = db->get_port_versions("fmt");
+    auto fmt = maybe_fmt.get();
+    REQUIRE(fmt);
+    REQUIRE(fmt->size() == 1);
+    CHECK((*fmt)[0].version == Version{"2022-01-01", 1});
+    CHECK((*fmt)[0].scheme == VersionScheme::Date);
+
+    CHECK_FALSE(db->get_port_versions("baseline-only").has_value());
+    CHECK_FALSE(db->get_port_versions("zlib2").has_value());
+    CHECK_FALSE(db->get_port_versions("a").has_value());
+
+    CHECK(db->get_baseline_version("zlib").value_or_exit(VCPKG_LINE_INFO) == Version{"1.2.12", 0});
+    CHECK(db->get_baseline_version("baseline-only").value_or_exit(VCPKG_LINE_INFO) == Version{"1.0", 2});
+    CHECK_FALSE(db->get_baseline_version("fmt").has_value());
+    CHECK(db->get_baseline() == baseline);
+
+    fs.remove_all(temp_dir, VCPKG_LINE_INFO);
+}
+
+TEST_CASE ("compiled versions database rejects bad input", "[versions]")
+{
+    auto& fs = get_real_filesystem();
+    const auto temp_dir = Test::base_temporary_directory() / "compiled-versions-db-invalid";
+    fs.remove_all(temp_dir, VCPKG_LINE_INFO);
+    fs.create_directories(temp_dir, VCPKG_LINE_INFO);
+
+    auto ports = make_ports();
+    ports[0].entries[0].git_tree = "ABCDEF";
+    CHECK_FALSE(CompiledVersionDb::compile(std::move(ports), {}, SOURCE_KEY).has_value());
+
+    auto bytes = CompiledVersionDb::compile(make_ports(), {}, SOURCE_KEY).value_or_exit(VCPKG_LINE_INFO);
+    CHECK(load_from_bytes(temp_dir, bytes).has_value());
+    CHECK_FALSE(load_from_bytes(temp_dir, "").has_value());
+    CHECK_FALSE(load_from_bytes(temp_dir, StringView{bytes}.substr(0, bytes.size() - 1)).has_value());
+    auto wrong_magic = bytes;
+    wrong_magic[0] = 'V';
+    CHECK_FALSE(load_from_bytes(temp_dir, wrong_magic).has_value());
+    auto wrong_format = bytes;
+    wrong_format[8] = '\x7F';
+    CHECK_FALSE(load_from_bytes(temp_dir, wrong_format).has_value());
+
+    fs.remove_all(temp_dir, VCPKG_LINE_INFO);
+}
+
+TEST_CASE ("compile versions database from registry files", "[versions]")
+{
+    auto& fs = get_real_filesystem();
+    const auto temp_dir = Test::base_temporary_directory() / "compiled-versions-db-registry";
+    fs.remove_all(temp_dir, VCPKG_LINE_INFO);
+    const auto versions = temp_dir / "versions";
+    fs.create_directories(versions / "z-", VCPKG_LINE_INFO);
+    fs.write_contents(
+        versions / "z-" / "zlib.json",
+        R"json({"versions": [{"version": "1.2.12", "git-tree": "0123456789abcdef0123456789abcdef01234567"}]})json",
+        VCPKG_LINE_INFO);
+    fs.write_contents(versions / "baseline.json",
+                      R"json({"default": {"zlib": {"baseline": "1.2.12", "port-version": 0}}})json",
+                      VCPKG_LINE_INFO);
+
+    const auto db_path = temp_dir / "versions.db";
+    CHECK_FALSE(try_load_compiled_versions_db(fs, db_path, SOURCE_KEY).has_value());
+
+    auto bytes = compile_versions_db(fs, versions, SOURCE_KEY).value_or_exit(VCPKG_LINE_INFO);
+    fs.write_contents(db_path, bytes, VCPKG_LINE_INFO);
+    auto maybe_db = try_load_compiled_versions_db(fs, db_path, SOURCE_KEY);
+    auto db = maybe_db.get();
+    REQUIRE(db);
+    CHECK(db->get_port_versions("zlib").value_or_exit(VCPKG_LINE_INFO)[0].git_tree == ZLIB_TREE);
+    CHECK(db->get_baseline_version("zlib").value_or_exit(VCPKG_LINE_INFO) == Version{"1.2.12", 0});
+
+    // a database compiled from other sources is stale
+    CHECK_FALSE(try_load_compiled_versions_db(fs, db_path, "0000000000000000000000000000000000000000").has_value());
+
+    fs.remove_all(temp_dir, VCPKG_LINE_INFO);
+}
@@ -0,0 +1,78 @@
+#include <catch2/catch.hpp>
+
+#include <vcpkg/base/files.h>
+
+#include <vcpkg/compiler-info.h>
+
+#include <vcpkg-test/util.h>
+
+using namespace vcpkg;
+
+TEST_CASE ("CompilerIndex", "[compiler-info]")
+{
+    auto& fs = get_real_filesystem();
+    const auto temp_dir = Test::base_temporary_directory() / "compiler-index";
+    fs.remove_all(temp_dir, VCPKG_LINE_INFO);
+    fs.create_directories(temp_dir, VCPKG_LINE_INFO);
+
+    const auto c_path = temp_dir / "gcc-9";
+    const auto cxx_path = temp_dir / "g++-9";
+    fs.write_contents(c_path, "c compiler", VCPKG_LINE_INFO);
+    fs.write_contents(cxx_path, "cxx compiler", VCPKG_LINE_INFO);
+
+    const auto index_path = temp_dir / "compilers.json";
+    CHECK(CompilerIndex::load(fs, index_path).empty());
+
+    CompilerInfo gcc{"gcc", "9.4.0", c_path, cxx_path};
+    gcc.fingerprint = CompilerInfo::compute_fingerprint(fs, c_path, cxx_path);
+    CHECK(gcc.fingerprint.size() == 64);
+    CHECK(gcc.fingerprint == CompilerInfo::compute_fingerprint(fs, c_path, cxx_path));
+
+    const CompilerInfo legacy{"clang", "12.0.0", c_path, cxx_path};
+    CompilerIndex::dump(fs, index_path, {{gcc.nickname(), gcc}, {legacy.nickname(), legacy}});
+
+    auto loaded = CompilerIndex::load(fs, index_path);
+    REQUIRE(loaded.size() == 2);
+    CHECK(loaded.at("gcc-9.4.0").fingerprint == gcc.fingerprint);
+    CHECK(loaded.at("gcc-9.4.0").c_full_path == c_path);
+    CHECK(loaded.at("clang-12.0.0").fingerprint.empty());
+
+    // a different binary under the same nickname gets a different fingerprint
+    fs.write_contents(cxx_path, "patched cxx compiler", VCPKG_LINE_INFO);
+    CHECK(CompilerInfo::compute_fingerprint(fs, c_path, cxx_path) != gcc.fingerprint);
+
+    fs.remove_all(temp_dir, VCPKG_LINE_INFO);
+}
+
+TEST_CASE ("CompilerIndex::add upgrades compilers registered without a fingerprint", "[compiler-info]")
+{
+    auto& fs = get_real_filesystem();
+    const auto temp_dir = Test::base_temporary_directory() / "compiler-index-add";
+    fs.remove_all(temp_dir, VCPKG_LINE_INFO);
+    fs.create_directories(temp_dir, VCPKG_LINE_INFO);
+
+    const auto c_path = temp_dir / "clang";
+    const auto cxx_path = temp_dir / "clang++";
+    fs.write_contents(c_path, "c compiler", VCPKG_LINE_INFO);
+    fs.write_contents(cxx_path, "cxx compiler", VCPKG_LINE_INFO);
+
+    const auto index_path = temp_dir / "bin2sth" / "compilers.json";
+    const CompilerInfo legacy{"clang", "12.0.0", c_path, cxx_path};
+    fs.create_directories(index_path.parent_path(), VCPKG_LINE_INFO);
+    CompilerIndex::dump(fs, index_path, {{legacy.nickname(), legacy}});
+
+    CHECK(CompilerIndex::add(fs, index_path, legacy));
+    auto loaded = CompilerIndex::load(fs, index_path);
+    REQUIRE(loaded.size() == 1);
+    CHECK(loaded.at("clang-12.0.0").fingerprint == CompilerInfo::compute_fingerprint(fs, c_path, cxx_path));
+
+    // once fingerprinted, registering the same nickname again is refused
+    CHECK_FALSE(CompilerIndex::add(fs, index_path, legacy));
+
+    // a compiler that only has a legacy config file is not in the index yet, and creates it
+    fs.remove(index_path, VCPKG_LINE_INFO);
+    CHECK(CompilerIndex::add(fs, index_path, legacy));
+    CHECK_FALSE(CompilerIndex::load(fs, index_path).at("clang-12.0.0").fingerprint.empty());
+
+    fs.remove_all(temp_dir, VCPKG_LINE_INFO);
+}
@@ -8,6 +8,7 @@
 #include <vcpkg/triplet.h>
 
 #include <memory>
+#include <set>
 #include <unordered_map>
 #include <vector>
 
@@ -194,6 +195,11 @@ struct MockOverlayProvider : PortFileProvider::IOverlayProvider
         return it->second;
     }
 
+    virtual Optional<Version> get_port_version(StringView name) const override
+    {
+        return get_control_file(name).map([](const SourceControlFileAndLocation& scfl) { return scfl.to_version(); });
+    }
+
     SourceControlFileAndLocation& emplace(const std::string& name,
                                           Version&& version,
                                           VersionScheme scheme = VersionScheme::String)
@@ -1949,6 +1955,42 @@ TEST_CASE ("version install host tool", "[versionplan]")
         CHECK(install_plan.install_actions[1].request_type == Dependencies::RequestType::USER_REQUESTED);
     }
 }
+
+TEST_CASE ("version install qualified dependencies per triplet", "[versionplan]")
+{
+    MockBaselineProvider bp;
+    bp.v["a"] = {"1", 0};
+    bp.v["b"] = {"1", 0};
+    bp.v["c"] = {"1", 0};
+
+    MockVersionedPortfileProvider vp;
+    auto& a_scf = vp.emplace("a", {"1", 0}).source_control_file;
+    a_scf->core_paragraph->dependencies.push_back({"c", {}, parse_platform("linux")});
+    auto& b_scf = vp.emplace("b", {"1", 0}).source_control_file;
+    b_scf->core_paragraph->dependencies.push_back(Dependency{"a"});
+    b_scf->core_paragraph->dependencies.push_back(Dependency{"a", {}, {}, {}, true});
+    vp.emplace("c", {"1", 0});
+
+    // the same version of a is resolved for both triplets, but its dependencies must be evaluated for each one
+    MockCMakeVarProvider var_provider;
+    var_provider.dep_info_vars[PackageSpec{"a", Test::X86_WINDOWS}] = {{"VCPKG_CMAKE_SYSTEM_NAME", "Windows"}};
+    var_provider.dep_info_vars[PackageSpec{"a", Test::ARM_UWP}] = {{"VCPKG_CMAKE_SYSTEM_NAME", "Linux"}};
+
+    auto install_plan = unwrap(create_versioned_install_plan(vp, bp, var_provider, {{"b"}}, {}, toplevel_spec()));
+
+    REQUIRE(install_plan.size() == 4);
+    std::set<PackageSpec> specs;
+    for (auto&& action : install_plan.install_actions)
+    {
+        specs.insert(action.spec);
+    }
+
+    CHECK(specs == std::set<PackageSpec>{{"a", Test::X86_WINDOWS},
+                                         {"a", Test::ARM_UWP},
+                                         {"b", Test::X86_WINDOWS},
+                                         {"c", Test::ARM_UWP}});
+}
+
 TEST_CASE ("version overlay ports", "[versionplan]")
 {
     MockBaselineProvider bp;
@@ -816,6 +816,76 @@ TEST_CASE ("get_regular_files_recursive_symlinks", "[files]")
         });
 }
 
+TEST_CASE ("visit_recursive_symlinks", "[files]")
+{
+    do_filesystem_enumeration_test(
+        [](Filesystem& fs, const Path& root) {
+            std::vector<Path> results;
+            fs.visit_recursive(
+                root,
+                [&](const Path& path, FileType type) {
+                    // symlinks are reported as their targets, but only real directories are descended into
+                    if (Strings::ends_with(path.native(), "directory"))
+                    {
+                        CHECK(type == FileType::directory);
+                    }
+                    else
+                    {
+                        CHECK(type == FileType::regular);
+                    }
+
+                    results.push_back(path);
+                },
+                VCPKG_LINE_INFO);
+            return results;
+        },
+        [](const Path& root) {
+            return std::vector<Path>{
+                root / "file.txt",
+                root / "some-directory",
+                root / "some-directory" / "file2.txt",
+                root / "some-directory" / "some-inner-directory",
+                root / "some-directory" / "symlink-to-file2.txt",
+                root / "some-directory" / "symlink-to-some-inner-directory",
+                root / "symlink-to-file.txt",
+                root / "symlink-to-some-directory",
+            };
+        });
+}
+
+TEST_CASE ("visit_recursive matches get_files_recursive", "[files]")
+{
+    urbg_t urbg;
+
+    auto& fs = setup();
+
+    auto temp_dir = base_temporary_directory() / get_random_filename(urbg);
+    INFO("temp dir is: " << temp_dir.native());
+
+    create_directory_tree(urbg, fs, temp_dir);
+
+    std::vector<Path> visited;
+    fs.visit_recursive(
+        temp_dir,
+        [&](const Path& path, FileType) {
+            // a directory is always visited before its contents
+            const Path parent = path.parent_path();
+            CHECK((parent == temp_dir || std::find(visited.begin(), visited.end(), parent) != visited.end()));
+            visited.push_back(path);
+        },
+        VCPKG_LINE_INFO);
+
+    std::sort(visited.begin(), visited.end());
+    CHECK(visited == fs.get_files_recursive(temp_dir, VCPKG_LINE_INFO));
+
+    std::vector<Path> none;
+    fs.visit_recursive(
+        temp_dir / "does-not-exist", [&](const Path& path, FileType) { none.push_back(path); }, VCPKG_LINE_INFO);
+    CHECK(none.empty());
+
+    fs.remove_all(temp_dir, VCPKG_LINE_INFO);
+}
+
 TEST_CASE ("get_regular_files_non_recursive_symlinks", "[files]")
 {
     do_filesystem_enumeration_test(
@@ -942,6 +1012,38 @@ TEST_CASE ("copy_symlink", "[files]")
     CHECK_EC_ON_FILE(temp_dir, ec);
 }
 
+TEST_CASE ("map_for_read", "[files]")
+{
+    urbg_t urbg;
+
+    auto& fs = setup();
+
+    auto temp_dir = base_temporary_directory() / get_random_filename(urbg);
+    INFO("temp dir is: " << temp_dir.native());
+
+    fs.create_directory(temp_dir, VCPKG_LINE_INFO);
+    fs.write_contents(temp_dir / "file", "some file contents", VCPKG_LINE_INFO);
+    fs.write_contents(temp_dir / "empty", "", VCPKG_LINE_INFO);
+
+    {
+        auto mapped = fs.map_for_read(temp_dir / "file", VCPKG_LINE_INFO);
+        CHECK(mapped.contents() == "some file contents");
+        auto moved = std::move(mapped);
+        CHECK(mapped.contents().empty());
+        CHECK(moved.contents() == "some file contents");
+    }
+
+    CHECK(fs.map_for_read(temp_dir / "empty", VCPKG_LINE_INFO).contents().empty());
+
+    std::error_code ec;
+    fs.map_for_read(temp_dir / "nonexistent", ec);
+    CHECK(ec);
+
+    Path fp;
+    fs.remove_all(temp_dir, ec, fp);
+    CHECK_EC_ON_FILE(fp, ec);
+}
+
 TEST_CASE ("LinesCollector", "[files]")
 {
     using Strings::LinesCollector;
@@ -0,0 +1,103 @@
+#include <catch2/catch.hpp>
+
+#include <vcpkg/base/graphs.h>
+
+#include <algorithm>
+#include <map>
+#include <string>
+#include <vector>
+
+using namespace vcpkg;
+
+namespace
+{
+    struct MapAdjacencyProvider final : Graphs::AdjacencyProvider<int>
+    {
+        std::map<size_t, std::vector<size_t>> edges;
+        mutable int loads = 0;
+
+        void append_adjacency_list(size_t vertex, std::vector<size_t>& out) const override
+        {
+            auto it = edges.find(vertex);
+            if (it != edges.end())
+            {
+                out.insert(out.end(), it->second.begin(), it->second.end());
+            }
+        }
+
+        std::string to_string(size_t vertex) const override { return std::to_string(vertex); }
+
+        int load_vertex_data(size_t vertex) const override
+        {
+            ++loads;
+            return static_cast<int>(vertex);
+        }
+    };
+
+    struct CountingRandomizer final : Graphs::Randomizer
+    {
+        int calls = 0;
+
+        int random(int max_exclusive) override { return calls++ % max_exclusive; }
+    };
+
+    size_t position_of(const std::vector<int>& sorted, int vertex)
+    {
+        return static_cast<size_t>(std::find(sorted.begin(), sorted.end(), vertex) - sorted.begin());
+    }
+}
+
+TEST_CASE ("CompactGraph", "[graphs]")
+{
+    MapAdjacencyProvider provider;
+    provider.edges[1] = {2, 3};
+    provider.edges[2] = {3};
+    provider.edges[3] = {};
+    provider.edges[4] = {5};
+
+    const std::vector<size_t> starts{2, 1};
+    Graphs::CompactGraph graph(starts, provider);
+
+    // 4 and 5 aren't reachable from the starting vertices
+    REQUIRE(graph.size() == 3);
+    CHECK(graph.vertices == std::vector<size_t>{2, 1, 3});
+    CHECK(graph.edge_offsets == std::vector<size_t>{0, 1, 3, 3});
+    CHECK(graph.edges == std::vector<size_t>{2, 0, 2});
+    CHECK(graph.starts == std::vector<size_t>{0, 1});
+    // vertex data is only loaded when the graph is walked
+    CHECK(provider.loads == 0);
+}
+
+TEST_CASE ("topological_sort", "[graphs]")
+{
+    MapAdjacencyProvider provider;
+    provider.edges[1] = {2, 3, 4};
+    provider.edges[2] = {4};
+    provider.edges[3] = {2, 5};
+    provider.edges[4] = {5};
+
+    const std::vector<size_t> starts{1, 3};
+    SECTION ("in order")
+    {
+        const auto sorted = Graphs::topological_sort(starts, provider, nullptr);
+        CHECK(sorted == std::vector<int>{5, 4, 2, 3, 1});
+        CHECK(provider.loads == 5);
+    }
+
+    SECTION ("randomized")
+    {
+        CountingRandomizer randomizer;
+        const auto sorted = Graphs::topological_sort(starts, provider, &randomizer);
+        REQUIRE(sorted.size() == 5);
+        for (auto&& edges : provider.edges)
+        {
+            for (auto neighbour : edges.second)
+            {
+                CHECK(position_of(sorted, static_cast<int>(neighbour)) <
+                      position_of(sorted, static_cast<int>(edges.first)));
+            }
+        }
+
+        CHECK(randomizer.calls > 0);
+    }
+}
@@ -0,0 +1,55 @@
+#include <catch2/catch.hpp>
+
+#include <vcpkg/base/files.h>
+
+#include <vcpkg/binaryparagraph.h>
+#include <vcpkg/install.h>
+#include <vcpkg/installedpaths.h>
+
+#include <vcpkg-test/util.h>
+
+using namespace vcpkg;
+
+TEST_CASE ("install_files_and_write_listfile", "[install]")
+{
+    auto& fs = get_real_filesystem();
+    const auto temp_dir = Test::base_temporary_directory() / "install-files";
+    fs.remove_all(temp_dir, VCPKG_LINE_INFO);
+
+    const auto source = temp_dir / "source";
+    fs.create_directories(source / "include" / "zlib", VCPKG_LINE_INFO);
+    fs.write_contents(source / "include" / "zlib.h", "zlib", VCPKG_LINE_INFO);
+    fs.write_contents(source / "include" / "zlib" / "zconf.h", "zconf", VCPKG_LINE_INFO);
+    fs.write_contents(source / "BUILD_INFO", "not installed", VCPKG_LINE_INFO);
+    const auto files = fs.get_files_recursive(source, VCPKG_LINE_INFO);
+
+    BinaryParagraph pgh;
+    pgh.spec = PackageSpec("zlib", Test::X64_WINDOWS);
+    pgh.version = "1.2.11";
+    const InstalledPaths installed(temp_dir / "installed");
+    const auto dirs = Install::InstallDir::from_destination_root(installed, pgh.spec, pgh);
+
+    const auto mode = GENERATE(Install::InstallFileMode::Copy, Install::InstallFileMode::HardLink);
+    Install::install_files_and_write_listfile(fs, source, files, dirs, mode);
+
+    const auto destination = installed.triplet_dir(pgh.spec);
+    CHECK(fs.read_contents(destination / "include" / "zlib.h", VCPKG_LINE_INFO) == "zlib");
+    CHECK(fs.read_contents(destination / "include" / "zlib" / "zconf.h", VCPKG_LINE_INFO) == "zconf");
+    CHECK_FALSE(fs.exists(destination / "BUILD_INFO", VCPKG_LINE_INFO));
+    const std::vector<std::string> expected_listfile{
+        "x64-windows/",
+        "x64-windows/include/",
+        "x64-windows/include/zlib.h",
+        "x64-windows/include/zlib/",
+        "x64-windows/include/zlib/zconf.h",
+        "",
+    };
+    CHECK(fs.read_lines(dirs.listfile(), VCPKG_LINE_INFO) == expected_listfile);
+
+    // installing again overwrites the files
+    fs.write_contents(source / "include" / "zlib.h", "zlib 2", VCPKG_LINE_INFO);
+    Install::install_files_and_write_listfile(fs, source, files, dirs, mode);
+    CHECK(fs.read_contents(destination / "include" / "zlib.h", VCPKG_LINE_INFO) == "zlib 2");
+
+    fs.remove_all(temp_dir, VCPKG_LINE_INFO);
+}
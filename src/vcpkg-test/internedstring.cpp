@@ -0,0 +1,76 @@
+#include <catch2/catch.hpp>
+
+#include <vcpkg/base/internedstring.h>
+
+#include <vcpkg/packagespec.h>
+
+#include <vcpkg-test/util.h>
+
+#include <set>
+#include <thread>
+#include <vector>
+
+using namespace vcpkg;
+
+TEST_CASE ("InternedString", "[internedstring]")
+{
+    const auto zlib = InternedString::intern("zlib");
+    const std::string zlib_copy = "zlib";
+    CHECK(InternedString::intern(zlib_copy) == zlib);
+    CHECK(&InternedString::intern(zlib_copy).str() == &zlib.str());
+    CHECK(zlib.str() == "zlib");
+    CHECK(zlib.hash_code() == std::hash<std::string>()("zlib"));
+
+    CHECK(InternedString::intern("") == InternedString());
+    CHECK(InternedString().empty());
+    CHECK(InternedString::intern("zlib-ng") != zlib);
+
+    // ordering is by the strings, whatever order they were interned in
+    const auto boost = InternedString::intern("boost");
+    CHECK(boost < zlib);
+    CHECK_FALSE(zlib < boost);
+    CHECK_FALSE(zlib < zlib);
+    CHECK(InternedString() < boost);
+
+    std::vector<InternedString> results(8);
+    std::vector<std::thread> threads;
+    for (size_t i = 0; i < results.size(); ++i)
+    {
+        threads.emplace_back([&results, i] { results[i] = InternedString::intern("interned-from-many-threads"); });
+    }
+
+    for (auto&& thread : threads)
+    {
+        thread.join();
+    }
+
+    CHECK(std::set<InternedString>(results.begin(), results.end()).size() == 1);
+}
+
+TEST_CASE ("PackageSpec handles", "[internedstring]")
+{
+    const auto x64_linux = Triplet::from_canonical_name("x64-linux");
+    const auto release = bin2sth::CompileTriplet::from_canonical_name("gcc_O2_NONE", x64_linux);
+    const auto debug = bin2sth::CompileTriplet::from_canonical_name("gcc_O0_NONE", x64_linux);
+
+    const PackageSpec plain("zlib", x64_linux);
+    const PackageSpec a("zlib", x64_linux, release);
+    const PackageSpec b(std::string("zlib"), x64_linux, release);
+    const PackageSpec c("zlib", x64_linux, debug);
+
+    CHECK(a == b);
+    CHECK(std::hash<PackageSpec>()(a) == std::hash<PackageSpec>()(b));
+    CHECK(a.compile_triplet() == b.compile_triplet());
+    CHECK(a != c);
+    CHECK(a != plain);
+    CHECK(plain == PackageSpec("zlib", x64_linux));
+    CHECK(plain < a);
+    CHECK(c < a);
+    CHECK(a.to_string() == "zlib:x64-linux_gcc_O2_NONE");
+    CHECK(PackageSpec().name().empty());
+
+    const FeatureSpec core(a, "core");
+    CHECK(core == FeatureSpec(b, std::string("core")));
+    CHECK(core.feature() == "core");
+    CHECK(FeatureSpec(a, "bzip2") < core);
+}
@@ -1046,6 +1046,14 @@ TEST_CASE ("license serialization", "[manifests][license]")
     CHECK(test_serialized_license("mit") == "MIT");
     CHECK(test_serialized_license("MiT    AND (aPACHe-2.0 \tOR   \n gpl-2.0+)") == "MIT AND (Apache-2.0 OR GPL-2.0+)");
     CHECK(test_serialized_license("uNkNoWnLiCeNsE") == "uNkNoWnLiCeNsE");
+
+    // the first and last entries of the lists, and neighbors which only differ in case or length
+    CHECK(test_serialized_license("0bsd") == "0BSD");
+    CHECK(test_serialized_license("zpl-2.1") == "ZPL-2.1");
+    CHECK(test_serialized_license("ZLIB") == "Zlib");
+    CHECK(test_serialized_license("ZLIB-ACKNOWLEDGEMENT") == "zlib-acknowledgement");
+    CHECK(test_serialized_license("mit WITH 389-EXCEPTION") == "MIT WITH 389-exception");
+    CHECK(test_serialized_license("mit WITH wxwindows-exception-3.1") == "MIT WITH WxWindows-exception-3.1");
 }
 
 TEST_CASE ("license error messages", "[manifests][license]")
@@ -1092,3 +1100,51 @@ TEST_CASE ("license error messages", "[manifests][license]")
     on expression: MIT AND unknownlicense
                            ^)");
 }
+
+TEST_CASE ("port identity from manifest", "[manifests]")
+{
+    auto m_identity = try_load_port_identity_text(R"json({
+    "name": "zlib",
+    "version-semver": "1.2.11",
+    "port-version": 3,
+    "license": "not a license",
+    "dependencies": [ { "name": "invalid dependency name" } ]
+})json",
+                                                  "<test manifest>",
+                                                  true);
+    REQUIRE(m_identity.has_value());
+    auto& identity = **m_identity.get();
+    CHECK(identity.name == "zlib");
+    CHECK(identity.schemed_version.scheme == VersionScheme::Semver);
+    CHECK(identity.to_version() == Version{"1.2.11", 3});
+
+    // the identity is only valid if the full manifest's name and version are
+    CHECK_FALSE(
+        try_load_port_identity_text(R"json({ "version": "1.2.11" })json", "<test manifest>", true).has_value());
+    CHECK_FALSE(try_load_port_identity_text(R"json({ "name": "zlib" })json", "<test manifest>", true).has_value());
+    CHECK_FALSE(try_load_port_identity_text(
+                    R"json({ "name": "zlib", "version": "1", "version-string": "1" })json", "<test manifest>", true)
+                    .has_value());
+}
+
+TEST_CASE ("port identity from CONTROL", "[manifests]")
+{
+    auto m_identity = try_load_port_identity_text(R"(Source: zlib
+Version: 1.2.11
+Port-Version: 2
+Build-Depends: not a dependency list (
+Unknown-Field: ignored
+
+Feature: feature
+Description: only the first paragraph is read
+)",
+                                                  "<test CONTROL>",
+                                                  false);
+    REQUIRE(m_identity.has_value());
+    auto& identity = **m_identity.get();
+    CHECK(identity.name == "zlib");
+    CHECK(identity.schemed_version.scheme == VersionScheme::String);
+    CHECK(identity.to_version() == Version{"1.2.11", 2});
+
+    CHECK_FALSE(try_load_port_identity_text("Version: 1.2.11\n", "<test CONTROL>", false).has_value());
+}
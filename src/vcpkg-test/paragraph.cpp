@@ -456,6 +456,79 @@ TEST_CASE ("parse comment before single line feed", "[paragraph]")
     REQUIRE(pghs[0]["f1"].first == "v1");
 }
 
+TEST_CASE ("paragraph tokenizer matches parse paragraphs", "[paragraph]")
+{
+    const char* str = GENERATE("",
+                               "f1: v1",
+                               "\n\nf1: v1\nf2: v2\n\n\nf3: v3\r\n\r\nf4: v4\n  more\n  . \n",
+                               "f1: v1\r\n  more\r\n\r\nf2:\r\n",
+                               "f1: v1\r  more\r\rf2: v2\r",
+                               "# comment\nf1: v1\n# comment\nf2: v2\n\n# comment\n",
+                               "f1: caf\xc3\xa9\n  na\xc3\xafve\n",
+                               "f1: v1\nf1: v2\n",
+                               "f1 v1\n",
+                               "f1: v1\n  \nf2: v2\n",
+                               "f1: v1\n\n  f2: v2\n",
+                               "f1: v1\n ",
+                               "f1: caf\xc3\xa9\n\xc3\xa9: v2\n");
+    auto pghs = vcpkg::Paragraphs::parse_paragraphs(str, "<origin>");
+
+    vcpkg::Paragraphs::ParagraphTokenizer tokenizer(str, "<origin>");
+    std::vector<Paragraph> tokenized;
+    std::vector<vcpkg::Parse::ParagraphFieldView> fields;
+    while (tokenizer.next(fields))
+    {
+        tokenized.emplace_back();
+        for (auto&& field : fields)
+        {
+            tokenized.back().emplace(field.name.to_string(), std::make_pair(field.value(), vcpkg::Parse::TextRowCol{}));
+        }
+    }
+
+    if (auto p = pghs.get())
+    {
+        REQUIRE(tokenizer.error() == nullptr);
+        REQUIRE(tokenized.size() == p->size());
+        for (size_t i = 0; i < p->size(); ++i)
+        {
+            REQUIRE(tokenized[i].size() == (*p)[i].size());
+            for (auto&& field : (*p)[i])
+            {
+                CHECK(tokenized[i][field.first].first == field.second.first);
+            }
+        }
+    }
+    else
+    {
+        REQUIRE(tokenizer.error() != nullptr);
+        CHECK(*tokenizer.error() == pghs.error());
+    }
+}
+
+TEST_CASE ("StatusParagraph from field views", "[paragraph]")
+{
+    const std::string str = "Package: zlib\n"
+                            "Version: 1.2.11\n"
+                            "Port-Version: 2\n"
+                            "Architecture: x64-windows\n"
+                            "Multi-Arch: same\n"
+                            "Description: a\r\n"
+                            "  compression library\n"
+                            "Status: install ok installed\n";
+    vcpkg::Paragraphs::ParagraphTokenizer tokenizer(str, "<origin>");
+    std::vector<vcpkg::Parse::ParagraphFieldView> fields;
+    REQUIRE(tokenizer.next(fields));
+    const vcpkg::StatusParagraph pgh(fields);
+    CHECK(pgh.package.spec.name() == "zlib");
+    CHECK(pgh.package.version == "1.2.11");
+    CHECK(pgh.package.port_version == 2);
+    CHECK(pgh.package.description == std::vector<std::string>{"a", "compression library"});
+    CHECK(pgh.want == vcpkg::Want::INSTALL);
+    CHECK(pgh.state == vcpkg::InstallState::INSTALLED);
+    CHECK_FALSE(tokenizer.next(fields));
+    CHECK(tokenizer.error() == nullptr);
+}
+
 TEST_CASE ("BinaryParagraph serialize min", "[paragraph]")
 {
     auto pgh = test_make_binary_paragraph({
@@ -0,0 +1,44 @@
+#include <catch2/catch.hpp>
+
+#include <vcpkg/base/parallel-algorithms.h>
+
+#include <atomic>
+#include <thread>
+#include <vector>
+
+using namespace vcpkg;
+
+TEST_CASE ("in_parallel_region", "[parallel-algorithms]")
+{
+    CHECK_FALSE(in_parallel_region());
+
+    std::vector<int> items(16);
+    std::atomic<size_t> outside{0};
+    parallel_for_each_n(items.begin(), items.size(), [&](int&) {
+        if (!in_parallel_region())
+        {
+            ++outside;
+        }
+    });
+
+    CHECK(outside == 0);
+    CHECK_FALSE(in_parallel_region());
+}
+
+TEST_CASE ("nested parallel algorithms run on the calling thread", "[parallel-algorithms]")
+{
+    std::vector<int> outer(8);
+    std::atomic<size_t> elsewhere{0};
+    parallel_for_each_n(outer.begin(), outer.size(), [&](int&) {
+        const auto outer_thread = std::this_thread::get_id();
+        std::vector<int> inner(16);
+        parallel_for_each_n(inner.begin(), inner.size(), [&](int&) {
+            if (std::this_thread::get_id() != outer_thread)
+            {
+                ++elsewhere;
+            }
+        });
+    });
+
+    CHECK(elsewhere == 0);
+}
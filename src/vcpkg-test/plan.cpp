@@ -2,7 +2,9 @@
 
 #include <vcpkg/base/graphs.h>
 
+#include <vcpkg/compile-triplet.h>
 #include <vcpkg/dependencies.h>
+#include <vcpkg/install.h>
 #include <vcpkg/portfileprovider.h>
 #include <vcpkg/sourceparagraph.h>
 #include <vcpkg/triplet.h>
@@ -81,6 +83,56 @@ TEST_CASE ("basic install scheme", "[plan]")
     REQUIRE(install_plan.install_actions.at(2).spec.name() == "a");
 }
 
+TEST_CASE ("compile triplet variants are batched", "[plan]")
+{
+    PackageSpecMap spec_map;
+    spec_map.emplace("a", "b");
+    spec_map.emplace("b", "c");
+    spec_map.emplace("c");
+    spec_map.emplace("d");
+
+    PortFileProvider::MapPortFileProvider map_port(spec_map.map);
+    MockCMakeVarProvider var_provider;
+
+    const auto o0 = bin2sth::CompileTriplet::from_canonical_name("gcc_O0_NONE", Test::X86_WINDOWS);
+    const auto o2 = bin2sth::CompileTriplet::from_canonical_name("gcc_O2_NONE", Test::X86_WINDOWS);
+    std::vector<FullPackageSpec> specs{
+        FullPackageSpec{{"a", Test::X86_WINDOWS, o0}, {"core"}},
+        FullPackageSpec{{"a", Test::X86_WINDOWS, o2}, {"core"}},
+        FullPackageSpec{{"d", Test::X86_WINDOWS}, {"core"}},
+    };
+
+    auto install_plan = Dependencies::create_feature_install_plan(map_port, var_provider, specs, StatusParagraphs());
+    REQUIRE(install_plan.install_actions.size() == 7);
+
+    auto batches = Install::batch_install_actions(install_plan.install_actions);
+    std::vector<std::string> names;
+    for (auto&& batch : batches)
+    {
+        names.push_back(Strings::join(",", batch, [](const Dependencies::InstallPlanAction* action) {
+            return action->spec.to_string();
+        }));
+    }
+
+    CHECK(names == std::vector<std::string>{
+                       "c:x86-windows_gcc_O0_NONE,c:x86-windows_gcc_O2_NONE",
+                       "d:x86-windows",
+                       "b:x86-windows_gcc_O0_NONE,b:x86-windows_gcc_O2_NONE",
+                       "a:x86-windows_gcc_O0_NONE,a:x86-windows_gcc_O2_NONE",
+                   });
+
+    // without variants the plan order is kept
+    auto plain_plan = Dependencies::create_feature_install_plan(
+        map_port, var_provider, Test::parse_test_fspecs("a d"), StatusParagraphs());
+    auto plain_batches = Install::batch_install_actions(plain_plan.install_actions);
+    REQUIRE(plain_batches.size() == plain_plan.install_actions.size());
+    for (size_t i = 0; i < plain_batches.size(); ++i)
+    {
+        REQUIRE(plain_batches[i].size() == 1);
+        CHECK(plain_batches[i][0] == &plain_plan.install_actions[i]);
+    }
+}
+
 TEST_CASE ("multiple install scheme", "[plan]")
 {
     std::vector<std::unique_ptr<StatusParagraph>> status_paragraphs;
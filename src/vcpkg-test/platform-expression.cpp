@@ -125,6 +125,52 @@ TEST_CASE ("platform-expression-identifier-misc", "[platform-expression]")
     CHECK_FALSE(staticcrt.evaluate({{"VCPKG_CRT_LINKAGE", "dynamic"}, {"VCPKG_LIBRARY_LINKAGE", "dynamic"}}));
 }
 
+TEST_CASE ("platform-expression-overrides", "[platform-expression]")
+{
+    auto m_expr = parse_expr("(windows | mycustom) & !static");
+    REQUIRE(m_expr);
+    auto& expr = *m_expr.get();
+
+    Context linux_static{{"VCPKG_CMAKE_SYSTEM_NAME", "Linux"}, {"VCPKG_LIBRARY_LINKAGE", "static"}};
+    CHECK_FALSE(expr.evaluate(linux_static));
+
+    linux_static["VCPKG_DEP_INFO_OVERRIDE_VARS"] = "mycustom;!static";
+    CHECK(expr.evaluate(linux_static));
+
+    // the first override of an identifier wins
+    linux_static["VCPKG_DEP_INFO_OVERRIDE_VARS"] = "!windows;windows;mycustom;!mycustom;static";
+    CHECK_FALSE(expr.evaluate(linux_static));
+
+    auto m_native = parse_expr("native");
+    REQUIRE(m_native);
+    CHECK(m_native.get()->evaluate({{"VCPKG_DEP_INFO_OVERRIDE_VARS", "native"}}));
+}
+
+TEST_CASE ("platform-expression-evaluation-context", "[platform-expression]")
+{
+    const auto x64_windows = EvaluationContext::from_cmake_vars(
+        {{"VCPKG_TARGET_ARCHITECTURE", "x64"}, {"VCPKG_CMAKE_SYSTEM_NAME", ""}, {"VCPKG_LIBRARY_LINKAGE", "dynamic"}});
+    const auto arm64_osx = EvaluationContext::from_cmake_vars({{"VCPKG_TARGET_ARCHITECTURE", "arm64"},
+                                                               {"VCPKG_CMAKE_SYSTEM_NAME", "Darwin"},
+                                                               {"VCPKG_LIBRARY_LINKAGE", "static"}});
+
+    auto m_expr = parse_expr("!(arm & !osx) & (x64 | arm64), windows | static");
+    REQUIRE(m_expr);
+    const auto copied = *m_expr.get();
+    CHECK(copied.evaluate(x64_windows));
+    CHECK(copied.evaluate(arm64_osx));
+
+    auto m_arm_only = parse_expr("arm & !osx");
+    REQUIRE(m_arm_only);
+    CHECK_FALSE(m_arm_only.get()->evaluate(x64_windows));
+    CHECK_FALSE(m_arm_only.get()->evaluate(arm64_osx));
+
+    CHECK(Expr::And({}).evaluate(x64_windows));
+    CHECK_FALSE(Expr::Or({}).evaluate(x64_windows));
+    CHECK(Expr::Not(Expr::Identifier("osx")).evaluate(x64_windows));
+    CHECK(Expr::Empty().evaluate(arm64_osx));
+}
+
 TEST_CASE ("platform-expression-not", "[platform-expression]")
 {
     auto m_expr = parse_expr("!windows");
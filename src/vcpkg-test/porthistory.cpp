@@ -0,0 +1,98 @@
+#include <catch2/catch.hpp>
+
+#include <vcpkg/base/files.h>
+
+#include <vcpkg/commands.porthistory.h>
+
+#include <vcpkg-test/util.h>
+
+using namespace vcpkg;
+using namespace vcpkg::Commands::PortHistory;
+
+TEST_CASE ("parse port history with a merge and a delete", "[port-history]")
+{
+    static constexpr StringLiteral LOG = R"(@1111111111111111111111111111111111111111 2022-03-04
+
+:040000 000000 aaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaa 0000000000000000000000000000000000000000 D	ports/zlib
+@2222222222222222222222222222222222222222 2022-03-03
+@3333333333333333333333333333333333333333 2022-03-02
+
+:040000 040000 bbbbbbbbbbbbbbbbbbbbbbbbbbbbbbbbbbbbbbbb aaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaa M	ports/zlib
+:100644 100644 cccccccccccccccccccccccccccccccccccccccc dddddddddddddddddddddddddddddddddddddddd M	ports/zlib/vcpkg.json
+@4444444444444444444444444444444444444444 2022-03-01
+
+:000000 040000 0000000000000000000000000000000000000000 bbbbbbbbbbbbbbbbbbbbbbbbbbbbbbbbbbbbbbbb A	ports/zlib
+:040000 040000 eeeeeeeeeeeeeeeeeeeeeeeeeeeeeeeeeeeeeeee ffffffffffffffffffffffffffffffffffffffff M	ports/zlib2
+)";
+
+    auto commits = parse_port_log(LOG, "zlib");
+    REQUIRE(commits.size() == 4);
+
+    // deleted the port
+    CHECK(commits[0].commit_id == "1111111111111111111111111111111111111111");
+    CHECK(commits[0].commit_date == "2022-03-04");
+    CHECK(commits[0].deleted);
+    CHECK(commits[0].git_tree.empty());
+
+    // a merge commit has no raw diff output; its tree must be resolved separately
+    CHECK(commits[1].commit_id == "2222222222222222222222222222222222222222");
+    CHECK_FALSE(commits[1].deleted);
+    CHECK(commits[1].git_tree.empty());
+
+    CHECK(commits[2].commit_id == "3333333333333333333333333333333333333333");
+    CHECK_FALSE(commits[2].deleted);
+    CHECK(commits[2].git_tree == "aaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaa");
+
+    CHECK(commits[3].commit_id == "4444444444444444444444444444444444444444");
+    CHECK(commits[3].commit_date == "2022-03-01");
+    CHECK_FALSE(commits[3].deleted);
+    CHECK(commits[3].git_tree == "bbbbbbbbbbbbbbbbbbbbbbbbbbbbbbbbbbbbbbbb");
+}
+
+TEST_CASE ("port history cache round trip", "[port-history]")
+{
+    auto& fs = get_real_filesystem();
+    const auto temp_dir = Test::base_temporary_directory() / "port-history-cache";
+    fs.remove_all(temp_dir, VCPKG_LINE_INFO);
+    const auto cache_path = temp_dir / "zlib.json";
+
+    PortHistoryCache cache;
+    cache.head = "1111111111111111111111111111111111111111";
+    cache.versions.push_back(make_history_version("zlib",
+                                                  "aaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaa",
+                                                  "1111111111111111111111111111111111111111",
+                                                  "2022-03-04",
+                                                  "1.2.12",
+                                                  1,
+                                                  VersionScheme::Relaxed));
+    cache.versions.push_back(make_history_version("zlib",
+                                                  "bbbbbbbbbbbbbbbbbbbbbbbbbbbbbbbbbbbbbbbb",
+                                                  "2222222222222222222222222222222222222222",
+                                                  "2022-03-01",
+                                                  "1.2.11",
+                                                  0,
+                                                  VersionScheme::Relaxed));
+    CHECK(cache.versions[0].version_string == "1.2.12#1");
+    CHECK(cache.versions[1].version_string == "1.2.11#0");
+
+    store_port_history_cache(fs, cache_path, cache);
+    auto maybe_loaded = try_load_port_history_cache(fs, cache_path, "zlib");
+    auto loaded = maybe_loaded.get();
+    REQUIRE(loaded);
+    CHECK(loaded->head == cache.head);
+    REQUIRE(loaded->versions.size() == 2);
+    for (size_t i = 0; i < 2; ++i)
+    {
+        CHECK(loaded->versions[i].version_string == cache.versions[i].version_string);
+        CHECK(loaded->versions[i].git_tree == cache.versions[i].git_tree);
+        CHECK(loaded->versions[i].scheme == cache.versions[i].scheme);
+    }
+
+    // `x-history` prints the same thing whether the history came from git or from the cache
+    CHECK(format_port_history(loaded->versions) == format_port_history(cache.versions));
+
+    fs.write_contents(cache_path, "{}", VCPKG_LINE_INFO);
+    CHECK_FALSE(try_load_port_history_cache(fs, cache_path, "zlib").has_value());
+
+    fs.remove_all(temp_dir, VCPKG_LINE_INFO);
+}
@@ -0,0 +1,98 @@
+#include <catch2/catch.hpp>
+
+#include <vcpkg/base/files.h>
+#include <vcpkg/base/util.h>
+
+#include <vcpkg/portsearchindex.h>
+
+#include <vcpkg-test/util.h>
+
+using namespace vcpkg;
+
+namespace
+{
+    void write_port(Filesystem& fs, const Path& directory, const std::string& manifest)
+    {
+        fs.create_directories(directory, VCPKG_LINE_INFO);
+        fs.write_contents(directory / "vcpkg.json", manifest, VCPKG_LINE_INFO);
+    }
+
+    std::vector<std::string> names_of(const std::vector<SearchResult>& results)
+    {
+        return Util::fmap(results, [](const SearchResult& result) { return result.port->name; });
+    }
+}
+
+TEST_CASE ("PortSearchIndex", "[portsearchindex]")
+{
+    auto& fs = get_real_filesystem();
+    const auto temp_dir = Test::base_temporary_directory() / "port-search-index";
+    fs.remove_all(temp_dir, VCPKG_LINE_INFO);
+
+    const auto overlay = temp_dir / "overlay" / "zlib";
+    const auto ports = temp_dir / "ports";
+    write_port(fs, overlay, R"({"name": "zlib", "version": "2.0", "description": "overlay zlib"})");
+    write_port(fs, ports / "zlib", R"({"name": "zlib", "version": "1.2.11", "description": "A compression library"})");
+    write_port(fs, ports / "libpng", R"json({
+    "name": "libpng",
+    "version": "1.6.37",
+    "port-version": 2,
+    "description": "PNG image library",
+    "features": { "apng": { "description": "Animated PNG support" } }
+})json");
+    write_port(fs, ports / "zstd", R"({"name": "zstd", "version": "1.5.0", "description": "Zstandard compression"})");
+    write_port(fs,
+               ports / "zlib-ng",
+               R"({"name": "zlib-ng", "version": "2.0.5", "description": "zlib for the next generation"})");
+
+    const std::vector<Path> directories{overlay, ports / "libpng", ports / "zlib", ports / "zlib-ng", ports / "zstd"};
+
+    PortSearchIndex index;
+    CHECK(index.refresh(fs, directories));
+    CHECK_FALSE(index.refresh(fs, directories));
+
+    // the overlay hides the zlib from the ports directory
+    auto all = index.ports();
+    REQUIRE(all.size() == 4);
+    CHECK(all[0]->name == "libpng");
+    CHECK(all[0]->port_version == 2);
+    CHECK(all[1]->name == "zlib");
+    CHECK(all[1]->version == "2.0");
+
+    CHECK(names_of(index.search("ZLIB")) == std::vector<std::string>{"zlib", "zlib-ng"});
+    CHECK(names_of(index.search("lib")) == std::vector<std::string>{"libpng", "zlib", "zlib-ng"});
+    CHECK(names_of(index.search("compression")) == std::vector<std::string>{"zstd"});
+    CHECK(names_of(index.search("z")) == std::vector<std::string>{"zlib", "zlib-ng", "zstd"});
+    CHECK(index.search("zlibz").empty());
+
+    // a feature match lists only the matching feature
+    auto animated = index.search("animated");
+    REQUIRE(animated.size() == 1);
+    CHECK(animated[0].match == SearchMatch::Feature);
+    REQUIRE(animated[0].features.size() == 1);
+    CHECK(animated[0].features[0]->name == "apng");
+    auto png = index.search("png");
+    REQUIRE(png.size() == 1);
+    CHECK(png[0].match == SearchMatch::Name);
+    CHECK(png[0].features.size() == 1);
+
+    const auto index_path = temp_dir / "search-index.json";
+    std::error_code ec;
+    index.save(fs, index_path, ec);
+    REQUIRE_FALSE(ec);
+
+    auto loaded = PortSearchIndex::load(fs, index_path);
+    CHECK(loaded.ports().size() == 4);
+    CHECK(names_of(loaded.search("compression")) == std::vector<std::string>{"zstd"});
+    CHECK_FALSE(loaded.refresh(fs, directories));
+
+    // dropping the overlay makes the zlib from the ports directory visible, without re-reading anything
+    const std::vector<Path> without_overlay(directories.begin() + 1, directories.end());
+    CHECK(loaded.refresh(fs, without_overlay));
+    CHECK(names_of(loaded.search("compression")) == std::vector<std::string>{"zlib", "zstd"});
+
+    fs.write_contents(index_path, "not json", VCPKG_LINE_INFO);
+    CHECK(PortSearchIndex::load(fs, index_path).ports().empty());
+
+    fs.remove_all(temp_dir, VCPKG_LINE_INFO);
+}
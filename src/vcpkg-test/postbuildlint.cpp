@@ -0,0 +1,74 @@
+#include <catch2/catch.hpp>
+
+#include <vcpkg/base/files.h>
+#include <vcpkg/base/util.h>
+
+#include <vcpkg/postbuildlint.h>
+
+#include <vcpkg-test/util.h>
+
+using namespace vcpkg;
+using namespace vcpkg::PostBuildLint;
+
+namespace
+{
+    std::vector<std::string> relative_to(const Path& root, const std::vector<Path>& paths)
+    {
+        auto ret = Util::fmap(paths, [&root](const Path& path) {
+            return Path(path.native().substr(root.native().size() + 1)).generic_u8string();
+        });
+        Util::sort(ret);
+        return ret;
+    }
+}
+
+TEST_CASE ("package file index lookups", "[postbuildlint]")
+{
+    auto& fs = get_real_filesystem();
+    const auto package_dir = Test::base_temporary_directory() / "package-file-index";
+    fs.remove_all(package_dir, VCPKG_LINE_INFO);
+    for (auto&& file : {"include/a.h",
+                        "debug/include/b.h",
+                        "debug/include/sub/c.h",
+                        "debug/includes/d.h",
+                        "debug/Lib/e.lib",
+                        "lib/cmake/f.cmake"})
+    {
+        fs.write_contents_and_dirs(package_dir / file, "", VCPKG_LINE_INFO);
+    }
+
+    fs.create_directories(package_dir / "share" / "empty", VCPKG_LINE_INFO);
+
+    const PackageFileIndex index(fs, package_dir);
+    CHECK(index.regular_files.size() == 6);
+
+    const std::vector<std::string> debug_include{"debug/include/b.h", "debug/include/sub/c.h"};
+    CHECK(relative_to(package_dir, index.regular_files_under(package_dir / "debug" / "include")) == debug_include);
+    CHECK(relative_to(package_dir, index.regular_files_in(package_dir / "debug" / "include")) ==
+          std::vector<std::string>{"debug/include/b.h"});
+
+    // directories are matched however the path is spelled
+    CHECK(relative_to(package_dir, index.regular_files_under(package_dir / "debug/include/")) == debug_include);
+    CHECK(relative_to(package_dir, index.regular_files_under(package_dir / "debug" / "." / "include")) ==
+          debug_include);
+#if defined(_WIN32)
+    // and case only matters where the filesystem distinguishes it
+    CHECK(relative_to(package_dir, index.regular_files_under(package_dir / "DEBUG" / "Include")) == debug_include);
+    CHECK(relative_to(package_dir, index.regular_files_in(package_dir / "debug" / "lib")) ==
+          std::vector<std::string>{"debug/Lib/e.lib"});
+#else
+    CHECK(index.regular_files_under(package_dir / "DEBUG" / "Include").empty());
+    CHECK(index.regular_files_in(package_dir / "debug" / "lib").empty());
+    CHECK(relative_to(package_dir, index.regular_files_in(package_dir / "debug" / "Lib")) ==
+          std::vector<std::string>{"debug/Lib/e.lib"});
+#endif
+
+    CHECK(index.regular_files_under(package_dir / "debug" / "inc").empty());
+    CHECK(index.regular_files_under(package_dir / "share").empty());
+
+    const auto empty_dirs = index.empty_directories(fs);
+    REQUIRE(empty_dirs.size() == 1);
+    CHECK(empty_dirs[0] == package_dir / "share" / "empty");
+
+    fs.remove_all(package_dir, VCPKG_LINE_INFO);
+}
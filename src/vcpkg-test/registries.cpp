@@ -5,6 +5,8 @@
 #include <vcpkg/configuration.h>
 #include <vcpkg/registries.h>
 
+#include <atomic>
+
 using namespace vcpkg;
 
 namespace
@@ -19,7 +21,10 @@ namespace
 
         Optional<Version> get_baseline_version(StringView) const override { return nullopt; }
 
+        void prefetch_baseline() const override { ++prefetches; }
+
         int number;
+        mutable std::atomic<int> prefetches{0};
 
         TestRegistryImplementation(int n) : number(n) { }
     };
@@ -87,6 +92,48 @@ static vcpkg::Optional<Configuration> visit_default_registry(Json::Reader& r, Js
     return r.visit(config, get_configuration_deserializer());
 }
 
+TEST_CASE ("registry_set_prefetches_baselines", "[registries]")
+{
+    std::vector<Registry> rs;
+    rs.push_back(make_registry(1, {"p1", "q1", "r1"}));
+    rs.push_back(make_registry(2, {"p2", "q2", "r2"}));
+    rs.push_back(make_registry(3, {"p3"}));
+    RegistrySet set(std::make_unique<TestRegistryImplementation>(0), std::move(rs));
+
+    const std::vector<std::string> port_names{"p1", "q1", "p2", "a", "b"};
+    set.prefetch_baselines(port_names);
+
+    const auto prefetches = [&](StringView port_name) {
+        return dynamic_cast<const TestRegistryImplementation&>(*set.registry_for_port(port_name)).prefetches.load();
+    };
+
+    // each registry is loaded once, however many of the ports it has
+    CHECK(prefetches("p1") == 1);
+    CHECK(prefetches("p2") == 1);
+    CHECK(prefetches("a") == 1);
+    CHECK(prefetches("p3") == 0);
+}
+
+TEST_CASE ("lockfile_find_does_not_fetch", "[registries]")
+{
+    LockFile lockfile;
+    lockfile.lockdata.emplace("https://example.com/registry",
+                              LockFile::EntryData{"HEAD", "0123456789abcdef0123456789abcdef01234567", true});
+    lockfile.lockdata.emplace("https://example.com/registry",
+                              LockFile::EntryData{"main", "fedcba9876543210fedcba9876543210fedcba98", true});
+
+    auto maybe_entry = lockfile.find("https://example.com/registry", "main");
+    auto entry = maybe_entry.get();
+    REQUIRE(entry);
+    CHECK(entry->commit_id() == "fedcba9876543210fedcba9876543210fedcba98");
+    CHECK(entry->stale());
+
+    CHECK_FALSE(lockfile.find("https://example.com/registry", "release").has_value());
+    CHECK_FALSE(lockfile.find("https://example.com/other", "HEAD").has_value());
+    CHECK(lockfile.lockdata.size() == 2);
+    CHECK_FALSE(lockfile.modified);
+}
+
 TEST_CASE ("registry_parsing", "[registries]")
 {
     {
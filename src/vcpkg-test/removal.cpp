@@ -0,0 +1,103 @@
+#include <catch2/catch.hpp>
+
+#include <vcpkg/base/files.h>
+#include <vcpkg/base/removal.h>
+#include <vcpkg/base/strings.h>
+#include <vcpkg/base/system.h>
+
+#include <vcpkg-test/util.h>
+
+using namespace vcpkg;
+
+namespace
+{
+    void create_tree(Filesystem& fs, const Path& base, int depth)
+    {
+        fs.create_directories(base, VCPKG_LINE_INFO);
+        for (int i = 0; i < 3; ++i)
+        {
+            fs.write_contents(base / Strings::concat("file-", i), "contents", VCPKG_LINE_INFO);
+            if (depth > 0)
+            {
+                create_tree(fs, base / Strings::concat("dir-", i), depth - 1);
+            }
+        }
+    }
+}
+
+TEST_CASE ("remove_all_parallel", "[removal]")
+{
+    auto& fs = get_real_filesystem();
+    const auto temp_dir = Test::base_temporary_directory() / "remove-all-parallel";
+    fs.remove_all(temp_dir, VCPKG_LINE_INFO);
+
+    const auto target = temp_dir / "target";
+    create_tree(fs, temp_dir / "tree", 3);
+    create_tree(fs, target, 0);
+    std::error_code ec;
+    fs.create_directory_symlink(target, temp_dir / "tree" / "dir-0" / "symlink", ec);
+
+    Path failure_point;
+    Removal::remove_all_parallel(fs, temp_dir / "tree", ec, failure_point);
+    REQUIRE_FALSE(ec);
+    CHECK_FALSE(fs.exists(temp_dir / "tree", VCPKG_LINE_INFO));
+    // symlinks are removed, not followed
+    CHECK(fs.get_files_non_recursive(target, VCPKG_LINE_INFO).size() == 3);
+
+    Removal::remove_all_parallel(fs, temp_dir / "does-not-exist", ec, failure_point);
+    CHECK_FALSE(ec);
+
+    fs.remove_all(temp_dir, VCPKG_LINE_INFO);
+}
+
+TEST_CASE ("remove_all_in_background", "[removal]")
+{
+    auto& fs = get_real_filesystem();
+    const auto temp_dir = Test::base_temporary_directory() / "remove-all-in-background";
+    fs.remove_all(temp_dir, VCPKG_LINE_INFO);
+
+    const auto target = temp_dir / "buildtree";
+    create_tree(fs, target, 2);
+    Removal::remove_all_in_background(fs, target, VCPKG_LINE_INFO);
+
+    // the path is free before the removal finishes
+    CHECK_FALSE(fs.exists(target, VCPKG_LINE_INFO));
+    create_tree(fs, target, 0);
+    Removal::remove_all_in_background(fs, target, VCPKG_LINE_INFO);
+    Removal::remove_all_in_background(fs, temp_dir / "does-not-exist", VCPKG_LINE_INFO);
+
+    // no tombstone is left behind
+    Removal::join();
+    CHECK(fs.get_files_non_recursive(temp_dir, VCPKG_LINE_INFO).empty());
+
+    fs.remove_all(temp_dir, VCPKG_LINE_INFO);
+}
+
+TEST_CASE ("remove_all_in_background sweeps stale tombstones", "[removal]")
+{
+    auto& fs = get_real_filesystem();
+    const auto temp_dir = Test::base_temporary_directory() / "remove-all-in-background-stale";
+    fs.remove_all(temp_dir, VCPKG_LINE_INFO);
+
+    CHECK(is_process_running(get_process_id()));
+    long dead_pid = 2147483000;
+    while (is_process_running(dead_pid))
+    {
+        --dead_pid;
+    }
+
+    const auto stale = temp_dir / Strings::concat("buildtree.vcpkg-removing-", dead_pid, "-0");
+    const auto live = temp_dir / Strings::concat("other.vcpkg-removing-", get_process_id(), "-1000000");
+    create_tree(fs, stale, 1);
+    create_tree(fs, live, 0);
+    create_tree(fs, temp_dir / "buildtree", 0);
+
+    Removal::remove_all_in_background(fs, temp_dir / "buildtree", VCPKG_LINE_INFO);
+    Removal::join();
+
+    // only the tombstone whose process is gone is removed
+    CHECK_FALSE(fs.exists(stale, VCPKG_LINE_INFO));
+    CHECK(fs.get_files_non_recursive(temp_dir, VCPKG_LINE_INFO) == std::vector<Path>{live});
+
+    fs.remove_all(temp_dir, VCPKG_LINE_INFO);
+}
@@ -0,0 +1,111 @@
+#include <catch2/catch.hpp>
+
+#include <vcpkg/base/files.h>
+#include <vcpkg/base/strings.h>
+
+#include <vcpkg/installedpaths.h>
+#include <vcpkg/remove.h>
+#include <vcpkg/vcpkglib.h>
+
+#include <vcpkg-test/util.h>
+
+using namespace vcpkg;
+
+namespace
+{
+    size_t count_packages(const std::string& contents)
+    {
+        size_t count = 0;
+        for (auto pos = contents.find("Package: "); pos != std::string::npos; pos = contents.find("Package: ", pos + 1))
+        {
+            ++count;
+        }
+
+        return count;
+    }
+
+    std::vector<Path> update_files(const Filesystem& fs, const InstalledPaths& installed)
+    {
+        return fs.get_regular_files_non_recursive(installed.vcpkg_dir_updates(), VCPKG_LINE_INFO);
+    }
+}
+
+TEST_CASE ("write_update writes one update for many paragraphs", "[remove]")
+{
+    auto& fs = get_real_filesystem();
+    const auto temp_dir = Test::base_temporary_directory() / "write-update-batch";
+    fs.remove_all(temp_dir, VCPKG_LINE_INFO);
+    const InstalledPaths installed(temp_dir / "installed");
+    (void)database_load_check(fs, installed);
+
+    std::vector<StatusParagraph> pghs;
+    pghs.push_back(*Test::make_status_pgh("a"));
+    pghs.push_back(*Test::make_status_feature_pgh("a", "feat"));
+    pghs.push_back(*Test::make_status_pgh("b"));
+    write_update(fs, installed, pghs);
+
+    const auto updates = update_files(fs, installed);
+    REQUIRE(updates.size() == 1);
+    CHECK(count_packages(fs.read_contents(updates[0], VCPKG_LINE_INFO)) == 3);
+
+    const auto status_db = database_load_check(fs, installed);
+    CHECK(status_db.find_installed(PackageSpec{"a", Test::X86_WINDOWS}) != status_db.end());
+    CHECK(status_db.find_installed(FeatureSpec{{"a", Test::X86_WINDOWS}, "feat"}) != status_db.end());
+    CHECK(status_db.find_installed(PackageSpec{"b", Test::X86_WINDOWS}) != status_db.end());
+    CHECK(update_files(fs, installed).empty());
+
+    fs.remove_all(temp_dir, VCPKG_LINE_INFO);
+}
+
+TEST_CASE ("remove_installed_packages removes packages as one batch", "[remove]")
+{
+    auto& fs = get_real_filesystem();
+    const auto temp_dir = Test::base_temporary_directory() / "remove-installed-packages";
+    fs.remove_all(temp_dir, VCPKG_LINE_INFO);
+    const InstalledPaths installed(temp_dir / "installed");
+    (void)database_load_check(fs, installed);
+
+    std::vector<StatusParagraph> pghs;
+    pghs.push_back(*Test::make_status_pgh("a"));
+    pghs.push_back(*Test::make_status_feature_pgh("a", "feat"));
+    pghs.push_back(*Test::make_status_pgh("b"));
+    pghs.push_back(*Test::make_status_pgh("c"));
+    write_update(fs, installed, pghs);
+    auto status_db = database_load_check(fs, installed);
+
+    const std::vector<PackageSpec> specs{{"a", Test::X86_WINDOWS}, {"b", Test::X86_WINDOWS}};
+    for (auto&& spec : specs)
+    {
+        const auto header = Strings::concat("x86-windows/include/", spec.name(), ".h");
+        fs.write_contents_and_dirs(installed.root() / header, "", VCPKG_LINE_INFO);
+        fs.write_contents(installed.listfile_path((*status_db.find_installed(spec))->package),
+                          Strings::concat("x86-windows/\nx86-windows/include/\n", header, "\n"),
+                          VCPKG_LINE_INFO);
+    }
+
+    fs.write_contents_and_dirs(installed.root() / "x86-windows" / "include" / "c.h", "", VCPKG_LINE_INFO);
+
+    const auto timings = Remove::remove_installed_packages(fs, installed, specs, &status_db);
+    CHECK(timings.size() == 2);
+
+    // one update marks every paragraph half-installed, and one marks them all not installed
+    auto updates = update_files(fs, installed);
+    REQUIRE(updates.size() == 2);
+    for (auto&& update : updates)
+    {
+        CHECK(count_packages(fs.read_contents(update, VCPKG_LINE_INFO)) == 3);
+    }
+
+    CHECK_FALSE(fs.exists(installed.root() / "x86-windows" / "include" / "a.h", VCPKG_LINE_INFO));
+    CHECK_FALSE(fs.exists(installed.root() / "x86-windows" / "include" / "b.h", VCPKG_LINE_INFO));
+    CHECK(fs.exists(installed.root() / "x86-windows" / "include" / "c.h", VCPKG_LINE_INFO));
+
+    const auto reloaded = database_load_check(fs, installed);
+    CHECK(reloaded.find_installed(PackageSpec{"a", Test::X86_WINDOWS}) == reloaded.end());
+    CHECK(reloaded.find_installed(FeatureSpec{{"a", Test::X86_WINDOWS}, "feat"}) == reloaded.end());
+    CHECK(reloaded.find_installed(PackageSpec{"b", Test::X86_WINDOWS}) == reloaded.end());
+    CHECK(reloaded.find_installed(PackageSpec{"c", Test::X86_WINDOWS}) != reloaded.end());
+    CHECK(update_files(fs, installed).empty());
+
+    fs.remove_all(temp_dir, VCPKG_LINE_INFO);
+}
@@ -148,3 +148,44 @@ TEST_CASE ("cmdlinebuilder", "[system]")
     REQUIRE(cmd.command_line() == "\"trailing\\\\slash\\\\\" \"inner\\\"quotes\"");
 #endif
 }
+
+#if !defined(_WIN32)
+TEST_CASE ("cmd_execute_and_capture_output", "[system]")
+{
+    using vcpkg::cmd_execute;
+    using vcpkg::cmd_execute_and_capture_output;
+    using vcpkg::Command;
+    using vcpkg::InWorkingDirectory;
+    using vcpkg::Path;
+
+    // arguments are passed through verbatim, without a shell reinterpreting them
+    auto result = cmd_execute_and_capture_output(
+        Command("printf").string_arg("[%s]").string_arg("with space").string_arg("a\"quote").string_arg("b\\c"));
+    CHECK(result.exit_code == 0);
+    CHECK(result.output == "[with space][a\"quote][b\\c]");
+
+    // both stdout and stderr are captured
+    result = cmd_execute_and_capture_output(Command("sh").string_arg("-c").string_arg("echo out; echo err >&2"));
+    CHECK(result.exit_code == 0);
+    CHECK((result.output == "out\nerr\n" || result.output == "err\nout\n"));
+
+    // command lines that depend on the shell still work
+    result = cmd_execute_and_capture_output(Command("echo").string_arg("redirected").raw_arg("1>&2"));
+    CHECK(result.output == "redirected\n");
+    CHECK(cmd_execute_and_capture_output(Command("command").string_arg("-v").string_arg("sh")).exit_code == 0);
+
+    result = cmd_execute_and_capture_output(Command("pwd"), InWorkingDirectory{Path("/")});
+    CHECK(result.output == "/\n");
+
+    result = cmd_execute_and_capture_output(Command("sh").string_arg("-c").string_arg("exit 3"));
+    CHECK(result.exit_code == 3);
+    CHECK(cmd_execute(Command("sh").string_arg("-c").string_arg("exit 4")) == 4);
+
+    result = cmd_execute_and_capture_output(Command("vcpkg-test-command-that-does-not-exist"));
+    CHECK(result.exit_code == 127);
+
+    const auto env = vcpkg::get_modified_clean_environment({}, "/vcpkg-test-prepended");
+    result = cmd_execute_and_capture_output(Command("sh").string_arg("-c").string_arg("echo \"$PATH\""), env);
+    CHECK(vcpkg::Strings::starts_with(result.output, "/vcpkg-test-prepended:"));
+}
+#endif // ^^^ !_WIN32
@@ -0,0 +1,55 @@
+#include <catch2/catch.hpp>
+
+#include <vcpkg/base/json.h>
+#include <vcpkg/base/tracing.h>
+
+#include <vcpkg-test/util.h>
+
+using namespace vcpkg;
+
+TEST_CASE ("trace spans", "[tracing]")
+{
+    {
+        // nothing is recorded before tracing starts
+        Tracing::TraceSpan ignored("test", "ignored");
+    }
+
+    auto& fs = get_real_filesystem();
+    const auto trace_file = Test::base_temporary_directory() / "tracing" / "trace.json";
+    Tracing::start(trace_file);
+    REQUIRE(Tracing::is_enabled());
+    {
+        Tracing::TraceSpan outer("test", "outer");
+        Tracing::TraceSpan inner("test", "inner");
+    }
+
+    Tracing::finish(fs);
+    CHECK_FALSE(Tracing::is_enabled());
+
+    auto trace = Json::parse_file(VCPKG_LINE_INFO, fs, trace_file).first;
+    REQUIRE(trace.is_object());
+    const auto events = trace.object().get("traceEvents");
+    REQUIRE(events);
+    REQUIRE(events->is_array());
+
+    const Json::Object* outer = nullptr;
+    const Json::Object* inner = nullptr;
+    for (auto&& event : events->array())
+    {
+        const auto& obj = event.object();
+        CHECK(obj["ph"].string() == "X");
+        CHECK(obj["name"].string() != "ignored");
+        if (obj["name"].string() == "outer") outer = &obj;
+        if (obj["name"].string() == "inner") inner = &obj;
+    }
+
+    REQUIRE(outer);
+    REQUIRE(inner);
+    CHECK((*outer)["cat"].string() == "test");
+    CHECK((*outer)["tid"].integer() == (*inner)["tid"].integer());
+    CHECK((*outer)["ts"].integer() <= (*inner)["ts"].integer());
+    CHECK((*inner)["ts"].integer() + (*inner)["dur"].integer() <=
+          (*outer)["ts"].integer() + (*outer)["dur"].integer());
+
+    fs.remove_all(trace_file.parent_path(), VCPKG_LINE_INFO);
+}
@@ -4,9 +4,11 @@
 #include <vcpkg/base/files.h>
 #include <vcpkg/base/messages.h>
 #include <vcpkg/base/pragmas.h>
+#include <vcpkg/base/removal.h>
 #include <vcpkg/base/strings.h>
 #include <vcpkg/base/system.debug.h>
 #include <vcpkg/base/system.process.h>
+#include <vcpkg/base/tracing.h>
 
 #include <vcpkg/commands.contact.h>
 #include <vcpkg/commands.h>
@@ -211,8 +213,11 @@ int main(const int argc, const char* const* const argv)
     set_environment_variable("CLICOLOR", "0");
 
     Checks::register_global_shutdown_handler([]() {
+        Removal::join();
         const auto elapsed_us_inner = GlobalState::timer.microseconds();
 
+        Tracing::finish(get_real_filesystem());
+
         bool debugging = Debug::g_debugging;
 
         LockGuardPtr<Metrics> metrics(g_metrics);
@@ -271,6 +276,7 @@ int main(const int argc, const char* const* const argv)
 
     VcpkgCmdArguments args = VcpkgCmdArguments::create_from_command_line(fs, argc, argv);
     if (const auto p = args.debug.get()) Debug::g_debugging = *p;
+    if (const auto p = args.trace_file.get()) Tracing::start(fs.absolute(*p, VCPKG_LINE_INFO));
     args.imbue_from_environment();
     VcpkgCmdArguments::imbue_or_apply_process_recursion(args);
     args.check_feature_flag_consistency();
@@ -2,7 +2,7 @@
 #include <vcpkg/base/cofffilereader.h>
 #include <vcpkg/base/optional.h>
 #include <vcpkg/base/stringliteral.h>
-#include <vcpkg/base/system.debug.h>
+#include <vcpkg/base/strings.h>
 
 #include <stdio.h>
 
@@ -12,22 +12,33 @@ using namespace std;
 
 namespace vcpkg
 {
-    static void read_and_verify_pe_signature(const ReadFilePointer& fs)
+    // Copies a T out of `bytes` at `offset`; the bytes of a mapped file have no particular alignment.
+    template<class T>
+    static T read_at(StringView bytes, uint64_t offset)
     {
-        static constexpr long OFFSET_TO_PE_SIGNATURE_OFFSET = 0x3c;
+        Checks::check_exit(VCPKG_LINE_INFO,
+                           offset <= bytes.size() && bytes.size() - offset >= sizeof(T),
+                           "Unexpected end of file while reading binary");
+        T result;
+        memcpy(&result, bytes.data() + offset, sizeof(T));
+        return result;
+    }
 
-        static constexpr StringLiteral PE_SIGNATURE = "PE\0\0";
+    static uint32_t read_and_verify_pe_signature(StringView image)
+    {
+        static constexpr uint64_t OFFSET_TO_PE_SIGNATURE_OFFSET = 0x3c;
 
-        Checks::check_exit(VCPKG_LINE_INFO, fs.seek(OFFSET_TO_PE_SIGNATURE_OFFSET, SEEK_SET) == 0);
-        uint32_t offset_to_pe_signature;
-        Checks::check_exit(VCPKG_LINE_INFO, fs.read(&offset_to_pe_signature, sizeof(uint32_t), 1) == 1);
-        Checks::check_exit(VCPKG_LINE_INFO, fs.seek(offset_to_pe_signature, SEEK_SET) == 0);
+        static constexpr StringLiteral PE_SIGNATURE = "PE\0\0";
 
-        char signature[PE_SIGNATURE.size()];
+        const auto offset_to_pe_signature = read_at<uint32_t>(image, OFFSET_TO_PE_SIGNATURE_OFFSET);
+        Checks::check_exit(VCPKG_LINE_INFO,
+                           offset_to_pe_signature <= image.size() &&
+                               image.size() - offset_to_pe_signature >= PE_SIGNATURE.size(),
+                           "Unexpected end of file while reading binary");
         Checks::check_exit(VCPKG_LINE_INFO,
-                           fs.read(signature, sizeof(char), PE_SIGNATURE.size()) == PE_SIGNATURE.size());
-        Checks::check_exit(
-            VCPKG_LINE_INFO, PE_SIGNATURE == StringView{signature, PE_SIGNATURE.size()}, "Incorrect PE signature.");
+                           PE_SIGNATURE == image.substr(offset_to_pe_signature, PE_SIGNATURE.size()),
+                           "Incorrect PE signature.");
+        return offset_to_pe_signature + static_cast<uint32_t>(PE_SIGNATURE.size());
     }
 
     struct CoffFileHeader
@@ -43,12 +54,10 @@ namespace vcpkg
 
     static_assert(sizeof(CoffFileHeader) == 20, "The CoffFileHeader struct must match its on-disk representation");
 
-    MachineType read_dll_machine_type(const ReadFilePointer& fs)
+    MachineType read_dll_machine_type(StringView image)
     {
-        read_and_verify_pe_signature(fs);
-        CoffFileHeader header;
-        Checks::check_exit(VCPKG_LINE_INFO, fs.read(&header, sizeof(header), 1) == 1);
-        return to_machine_type(header.machine);
+        const auto header_offset = read_and_verify_pe_signature(image);
+        return to_machine_type(read_at<CoffFileHeader>(image, header_offset).machine);
     }
 
     struct ArchiveMemberHeader
@@ -87,16 +96,16 @@ namespace vcpkg
     static_assert(sizeof(ArchiveMemberHeader) == 60,
                   "The ArchiveMemberHeader struct must match its on-disk representation");
 
-    static MachineType read_import_machine_type_after_sig1(const ReadFilePointer& fs)
+    static MachineType read_import_machine_type_after_sig1(StringView archive, uint64_t offset)
     {
         struct ImportHeaderPrefixAfterSig1
         {
             uint16_t sig2;
             uint16_t version;
             uint16_t machine;
-        } tmp;
+        };
 
-        Checks::check_exit(VCPKG_LINE_INFO, fs.read(&tmp, sizeof(tmp), 1) == 1);
+        const auto tmp = read_at<ImportHeaderPrefixAfterSig1>(archive, offset);
         if (tmp.sig2 == 0xFFFF)
         {
             return to_machine_type(tmp.machine);
@@ -106,78 +115,75 @@ namespace vcpkg
         return MachineType::UNKNOWN;
     }
 
-    static void read_and_verify_archive_file_signature(const ReadFilePointer& fs)
+    static uint64_t read_and_verify_archive_file_signature(StringView archive)
     {
         static constexpr StringLiteral FILE_START = "!<arch>\n";
-        Checks::check_exit(VCPKG_LINE_INFO, fs.seek(0, SEEK_SET) == 0);
-
-        char file_start[FILE_START.size()];
-        Checks::check_exit(VCPKG_LINE_INFO, fs.read(&file_start, FILE_START.size(), 1) == 1);
         Checks::check_exit(VCPKG_LINE_INFO,
-                           FILE_START == StringView{file_start, FILE_START.size()},
+                           FILE_START == archive.substr(0, FILE_START.size()),
                            "Incorrect archive file signature");
+        return FILE_START.size();
     }
 
-    static void read_and_skip_first_linker_member(const vcpkg::ReadFilePointer& fs)
+    static uint64_t read_and_skip_first_linker_member(StringView archive, uint64_t offset)
     {
-        ArchiveMemberHeader first_linker_member_header;
-        Checks::check_exit(VCPKG_LINE_INFO,
-                           fs.read(&first_linker_member_header, sizeof(first_linker_member_header), 1) == 1);
+        const auto first_linker_member_header = read_at<ArchiveMemberHeader>(archive, offset);
         Checks::check_exit(VCPKG_LINE_INFO,
                            memcmp(first_linker_member_header.name, "/ ", 2) == 0,
                            "Could not find proper first linker member");
-        Checks::check_exit(VCPKG_LINE_INFO, fs.seek(first_linker_member_header.decoded_size(), SEEK_CUR) == 0);
+        return offset + sizeof(ArchiveMemberHeader) + first_linker_member_header.decoded_size();
     }
 
-    static std::vector<uint32_t> read_second_linker_member_offsets(const vcpkg::ReadFilePointer& fs)
+    static std::vector<uint32_t> read_second_linker_member_offsets(StringView archive, uint64_t offset)
     {
-        ArchiveMemberHeader second_linker_member_header;
-        Checks::check_exit(VCPKG_LINE_INFO,
-                           fs.read(&second_linker_member_header, sizeof(second_linker_member_header), 1) == 1);
+        const auto second_linker_member_header = read_at<ArchiveMemberHeader>(archive, offset);
         Checks::check_exit(VCPKG_LINE_INFO,
                            memcmp(second_linker_member_header.name, "/ ", 2) == 0,
                            "Could not find proper second linker member");
 
         const auto second_size = second_linker_member_header.decoded_size();
+        offset += sizeof(ArchiveMemberHeader);
         // The first 4 bytes contains the number of archive members
-        uint32_t archive_member_count;
         Checks::check_exit(VCPKG_LINE_INFO,
-                           second_size >= sizeof(archive_member_count),
+                           second_size >= sizeof(uint32_t),
                            "Second linker member was too small to contain a single uint32_t");
-        Checks::check_exit(VCPKG_LINE_INFO, fs.read(&archive_member_count, sizeof(archive_member_count), 1) == 1);
+        const auto archive_member_count = read_at<uint32_t>(archive, offset);
         const auto maximum_possible_archive_members = (second_size / sizeof(uint32_t)) - 1;
         Checks::check_exit(VCPKG_LINE_INFO,
                            archive_member_count <= maximum_possible_archive_members,
                            "Second linker member was too small to contain the expected number of archive members");
-        std::vector<uint32_t> offsets(archive_member_count);
+        offset += sizeof(uint32_t);
         Checks::check_exit(VCPKG_LINE_INFO,
-                           fs.read(&offsets[0], sizeof(uint32_t), archive_member_count) == archive_member_count);
+                           offset <= archive.size() &&
+                               (archive.size() - offset) / sizeof(uint32_t) >= archive_member_count,
+                           "Unexpected end of file while reading binary");
+        std::vector<uint32_t> offsets(archive_member_count);
+        if (archive_member_count != 0)
+        {
+            memcpy(offsets.data(), archive.data() + offset, archive_member_count * sizeof(uint32_t));
+        }
 
         // Ignore offsets that point to offset 0. See vcpkg github #223 #288 #292
         offsets.erase(std::remove(offsets.begin(), offsets.end(), 0u), offsets.end());
         // Sort the offsets, because it is possible for them to be unsorted. See vcpkg github #292
         std::sort(offsets.begin(), offsets.end());
-        uint64_t leftover = second_size - sizeof(uint32_t) - (archive_member_count * sizeof(uint32_t));
-        Checks::check_exit(VCPKG_LINE_INFO, fs.seek(leftover, SEEK_CUR) == 0);
+        // Several offsets usually point into the same member
+        offsets.erase(std::unique(offsets.begin(), offsets.end()), offsets.end());
         return offsets;
     }
 
-    static std::vector<MachineType> read_machine_types_from_archive_members(const vcpkg::ReadFilePointer& fs,
+    static std::vector<MachineType> read_machine_types_from_archive_members(StringView archive,
                                                                             const std::vector<uint32_t>& member_offsets)
     {
         std::vector<MachineType> machine_types; // used as a set because n is tiny
         // Next we have the obj and pseudo-object files
-        for (size_t idx = 0; idx < member_offsets.size(); ++idx)
+        for (const auto offset : member_offsets)
         {
-            const auto offset = member_offsets[idx];
             // Skip the header, no need to read it
-            Checks::check_exit(VCPKG_LINE_INFO, fs.seek(offset + sizeof(ArchiveMemberHeader), SEEK_SET) == 0);
-            uint16_t machine_type_raw;
-            Checks::check_exit(VCPKG_LINE_INFO, fs.read(&machine_type_raw, sizeof(machine_type_raw), 1) == 1);
-            auto result_machine_type = to_machine_type(machine_type_raw);
+            const uint64_t member_offset = uint64_t{offset} + sizeof(ArchiveMemberHeader);
+            auto result_machine_type = to_machine_type(read_at<uint16_t>(archive, member_offset));
             if (result_machine_type == MachineType::UNKNOWN)
             {
-                result_machine_type = read_import_machine_type_after_sig1(fs);
+                result_machine_type = read_import_machine_type_after_sig1(archive, member_offset + sizeof(uint16_t));
             }
 
             if (result_machine_type == MachineType::UNKNOWN ||
@@ -193,12 +199,12 @@ namespace vcpkg
         return machine_types;
     }
 
-    std::vector<MachineType> read_lib_machine_types(const ReadFilePointer& fs)
+    std::vector<MachineType> read_lib_machine_types(StringView archive)
     {
-        read_and_verify_archive_file_signature(fs);
-        read_and_skip_first_linker_member(fs);
-        const auto offsets = read_second_linker_member_offsets(fs);
-        return read_machine_types_from_archive_members(fs, offsets);
+        auto offset = read_and_verify_archive_file_signature(archive);
+        offset = read_and_skip_first_linker_member(archive, offset);
+        const auto member_offsets = read_second_linker_member_offsets(archive, offset);
+        return read_machine_types_from_archive_members(archive, member_offsets);
     }
 
     MachineType to_machine_type(const uint16_t value)
@@ -1,6 +1,7 @@
 #include <vcpkg/base/system_headers.h>
 
 #include <vcpkg/base/files.h>
+#include <vcpkg/base/parallel-algorithms.h>
 #include <vcpkg/base/system.debug.h>
 #include <vcpkg/base/system.h>
 #include <vcpkg/base/system.print.h>
@@ -15,6 +16,7 @@
 #include <limits.h>
 
 #include <sys/file.h>
+#include <sys/mman.h>
 #include <sys/stat.h>
 #endif // !_WIN32
 
@@ -25,7 +27,11 @@
 #endif // ^^^ defined(__APPLE__)
 
 #include <algorithm>
+#include <chrono>
+#include <condition_variable>
+#include <deque>
 #include <list>
+#include <mutex>
 #include <string>
 #include <thread>
 
@@ -710,6 +716,20 @@ namespace
             }
         }
 
+        // Takes ownership of `fd`, even on failure.
+        ReadDirOp(int fd, std::error_code& ec) : dirp(fdopendir(fd))
+        {
+            if (dirp)
+            {
+                ec.clear();
+            }
+            else
+            {
+                ec.assign(errno, std::generic_category());
+                ::close(fd);
+            }
+        }
+
         ReadDirOp(const ReadDirOp&) = delete;
         ReadDirOp& operator=(const ReadDirOp&) = delete;
 
@@ -899,6 +919,208 @@ namespace
             mark_recursive_error(base, ec, failure_point);
         }
     }
+
+    // A directory waiting to be read by walk_tree, and the path its entries are reported under.
+    struct PendingDirectory
+    {
+        Path full;
+        Path out;
+    };
+
+    struct WalkedEntry
+    {
+        Path path;
+        FileType type;
+    };
+
+    // Reads the entries of `directory` into `entries`, and the real directories among them into `subdirectories`.
+    // d_type is trusted where the filesystem provides it; otherwise entries are classified with fstatat relative to the
+    // open directory, so that the path doesn't have to be resolved again. Symlinks are resolved only when
+    // `resolve_symlinks`, and reported as FileType::symlink otherwise or when dangling.
+    void read_walked_directory(const PendingDirectory& directory,
+                               bool resolve_symlinks,
+                               std::vector<WalkedEntry>& entries,
+                               std::vector<PendingDirectory>& subdirectories,
+                               std::error_code& ec)
+    {
+        const int fd = ::open(directory.full.c_str(), O_RDONLY | O_DIRECTORY | O_CLOEXEC);
+        if (fd < 0)
+        {
+            // the directory may have been removed after it was found
+            ec.assign(errno, std::generic_category());
+            translate_not_found_to_success(ec);
+            return;
+        }
+
+        ReadDirOp op{fd, ec};
+        if (ec)
+        {
+            return;
+        }
+
+        const int dir_fd = dirfd(op.dirp);
+        for (;;)
+        {
+            auto entry = op.read(ec);
+            if (ec)
+            {
+                return;
+            }
+
+            if (!entry)
+            {
+                // no more entries left
+                return;
+            }
+
+            if (is_dot_or_dot_dot(entry->d_name))
+            {
+                continue;
+            }
+
+            FileType type;
+            bool descend = false;
+            switch (get_d_type(entry))
+            {
+                case PosixDType::Directory:
+                    type = FileType::directory;
+                    descend = true;
+                    break;
+                case PosixDType::Regular: type = FileType::regular; break;
+                case PosixDType::Fifo: type = FileType::fifo; break;
+                case PosixDType::Socket: type = FileType::socket; break;
+                case PosixDType::CharacterDevice: type = FileType::character; break;
+                case PosixDType::BlockDevice: type = FileType::block; break;
+                case PosixDType::Link:
+                case PosixDType::Unknown:
+                default:
+                {
+                    struct stat ls;
+                    if (::fstatat(dir_fd, entry->d_name, &ls, AT_SYMLINK_NOFOLLOW) != 0)
+                    {
+                        if (errno == ENOENT)
+                        {
+                            // removed while we were reading the directory
+                            continue;
+                        }
+
+                        ec.assign(errno, std::generic_category());
+                        return;
+                    }
+
+                    if (!S_ISLNK(ls.st_mode))
+                    {
+                        type = posix_translate_stat_mode_to_file_type(ls.st_mode);
+                        descend = S_ISDIR(ls.st_mode);
+                        break;
+                    }
+
+                    type = FileType::symlink;
+                    struct stat s;
+                    if (resolve_symlinks && ::fstatat(dir_fd, entry->d_name, &s, 0) == 0)
+                    {
+                        type = posix_translate_stat_mode_to_file_type(s.st_mode);
+                    }
+
+                    // symlinks are never descended into
+                    break;
+                }
+            }
+
+            entries.push_back({directory.out / entry->d_name, type});
+            if (descend)
+            {
+                subdirectories.push_back({directory.full / entry->d_name, entries.back().path});
+            }
+        }
+    }
+
+    // Walks the tree below `dir`, reporting paths under `out_dir`. Directories are read breadth-first on the calling
+    // thread until there are enough of them to keep every thread busy, then concurrently, depth-first, from a shared
+    // queue. Inside a parallel region the whole walk stays on the calling thread. `on_entries` receives the entries of
+    // one directory at a time, never concurrently, and always before the entries of its subdirectories.
+    template<class OnEntries>
+    void walk_tree(
+        const Path& dir, const Path& out_dir, bool resolve_symlinks, std::error_code& ec, OnEntries on_entries)
+    {
+        ec.clear();
+        std::deque<PendingDirectory> pending;
+        pending.push_back({dir, out_dir});
+        std::vector<WalkedEntry> entries;
+        std::vector<PendingDirectory> subdirectories;
+        // execute_in_parallel would run on one thread there anyway; this skips the locking as well
+        const auto concurrency = in_parallel_region() ? size_t(1) : static_cast<size_t>(get_concurrency());
+        while (!pending.empty() && (concurrency <= 1 || pending.size() < concurrency))
+        {
+            const auto directory = std::move(pending.front());
+            pending.pop_front();
+            entries.clear();
+            subdirectories.clear();
+            read_walked_directory(directory, resolve_symlinks, entries, subdirectories, ec);
+            if (ec)
+            {
+                return;
+            }
+
+            on_entries(entries);
+            for (auto&& subdirectory : subdirectories)
+            {
+                pending.push_back(std::move(subdirectory));
+            }
+        }
+
+        if (pending.empty())
+        {
+            return;
+        }
+
+        std::mutex mtx;
+        std::condition_variable cv;
+        size_t active = 0;
+        execute_in_parallel(concurrency, [&]() {
+            std::vector<WalkedEntry> local_entries;
+            std::vector<PendingDirectory> local_subdirectories;
+            std::error_code local_ec;
+            std::unique_lock<std::mutex> lock(mtx);
+            for (;;)
+            {
+                cv.wait(lock, [&]() { return ec || !pending.empty() || active == 0; });
+                if (ec || pending.empty())
+                {
+                    return;
+                }
+
+                const auto directory = std::move(pending.back());
+                pending.pop_back();
+                ++active;
+                lock.unlock();
+
+                local_entries.clear();
+                local_subdirectories.clear();
+                read_walked_directory(directory, resolve_symlinks, local_entries, local_subdirectories, local_ec);
+
+                lock.lock();
+                --active;
+                if (local_ec)
+                {
+                    if (!ec)
+                    {
+                        ec = local_ec;
+                    }
+                }
+                else if (!ec)
+                {
+                    on_entries(local_entries);
+                    for (auto&& subdirectory : local_subdirectories)
+                    {
+                        pending.push_back(std::move(subdirectory));
+                    }
+                }
+
+                cv.notify_all();
+            }
+        });
+    }
 #endif // ^^^ !_WIN32
 }
 
@@ -1326,6 +1548,96 @@ namespace vcpkg
 #endif // ^^^ !_WIN32
     }
 
+    MappedFile::MappedFile(const Path& file_path, std::error_code& ec) noexcept
+    {
+#if defined(_WIN32)
+        FileHandle file(to_stdfs_path(file_path).c_str(),
+                        GENERIC_READ,
+                        FILE_SHARE_READ | FILE_SHARE_DELETE,
+                        OPEN_EXISTING,
+                        FILE_ATTRIBUTE_NORMAL,
+                        ec);
+        if (ec)
+        {
+            return;
+        }
+
+        LARGE_INTEGER file_size;
+        if (!::GetFileSizeEx(file.h_file, &file_size))
+        {
+            ec.assign(static_cast<int>(GetLastError()), std::system_category());
+            return;
+        }
+
+        if (file_size.QuadPart == 0)
+        {
+            // empty files cannot be mapped
+            return;
+        }
+
+        const HANDLE mapping = ::CreateFileMappingW(file.h_file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+        if (!mapping)
+        {
+            ec.assign(static_cast<int>(GetLastError()), std::system_category());
+            return;
+        }
+
+        // the view keeps the mapping and the file alive after their handles are closed
+        const void* view = ::MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+        const auto last_error = static_cast<int>(GetLastError());
+        Checks::check_exit(VCPKG_LINE_INFO, ::CloseHandle(mapping));
+        if (!view)
+        {
+            ec.assign(last_error, std::system_category());
+            return;
+        }
+
+        m_data = static_cast<const char*>(view);
+        m_size = static_cast<size_t>(file_size.QuadPart);
+#else  // ^^^ _WIN32 / !_WIN32 vvv
+        PosixFd fd(file_path.c_str(), O_RDONLY, ec);
+        if (ec)
+        {
+            return;
+        }
+
+        struct stat s;
+        fd.fstat(&s, ec);
+        if (ec)
+        {
+            return;
+        }
+
+        if (s.st_size == 0)
+        {
+            // empty files cannot be mapped
+            return;
+        }
+
+        void* view = ::mmap(nullptr, static_cast<size_t>(s.st_size), PROT_READ, MAP_PRIVATE, fd.get(), 0);
+        if (view == MAP_FAILED)
+        {
+            ec.assign(errno, std::generic_category());
+            return;
+        }
+
+        m_data = static_cast<const char*>(view);
+        m_size = static_cast<size_t>(s.st_size);
+#endif // ^^^ !_WIN32
+    }
+
+    MappedFile::~MappedFile()
+    {
+        if (m_data)
+        {
+#if defined(_WIN32)
+            Checks::check_exit(VCPKG_LINE_INFO, ::UnmapViewOfFile(m_data));
+#else  // ^^^ _WIN32 / !_WIN32 vvv
+            Checks::check_exit(VCPKG_LINE_INFO, ::munmap(const_cast<char*>(m_data), m_size) == 0);
+#endif // ^^^ !_WIN32
+        }
+    }
+
     std::vector<std::string> Filesystem::read_lines(const Path& file_path, LineInfo li) const
     {
         std::error_code ec;
@@ -1434,6 +1746,18 @@ namespace vcpkg
         return maybe_directories;
     }
 
+    void Filesystem::visit_recursive(const Path& dir,
+                                     const std::function<void(const Path&, FileType)>& visitor,
+                                     LineInfo li) const
+    {
+        std::error_code ec;
+        this->visit_recursive(dir, visitor, ec);
+        if (ec)
+        {
+            exit_filesystem_call_error(li, ec, __func__, {dir});
+        }
+    }
+
     std::vector<Path> Filesystem::get_regular_files_non_recursive(const Path& dir, LineInfo li) const
     {
         std::error_code ec;
@@ -1678,6 +2002,18 @@ namespace vcpkg
         return result;
     }
 
+    int64_t Filesystem::last_write_time(const Path& target, vcpkg::LineInfo li) const noexcept
+    {
+        std::error_code ec;
+        auto result = this->last_write_time(target, ec);
+        if (ec)
+        {
+            exit_filesystem_call_error(li, ec, __func__, {target});
+        }
+
+        return result;
+    }
+
     void Filesystem::write_lines(const Path& file_path, const std::vector<std::string>& lines, LineInfo li)
     {
         std::error_code ec;
@@ -1849,6 +2185,18 @@ namespace vcpkg
         return ret;
     }
 
+    MappedFile Filesystem::map_for_read(const Path& file_path, LineInfo li) const
+    {
+        std::error_code ec;
+        auto ret = this->map_for_read(file_path, ec);
+        if (ec)
+        {
+            exit_filesystem_call_error(li, ec, __func__, {file_path});
+        }
+
+        return ret;
+    }
+
     struct RealFilesystem final : Filesystem
     {
         virtual std::string read_contents(const Path& file_path, std::error_code& ec) const override
@@ -2095,178 +2443,77 @@ namespace vcpkg
             }
             return ret;
         }
-#else  // ^^^ _WIN32 // !_WIN32 vvv
-        static void insert_if_stat_matches(std::vector<Path>& result,
-                                           const Path& full,
-                                           struct stat* s,
-                                           bool want_directories,
-                                           bool want_regular_files,
-                                           bool want_other)
+
+        virtual void visit_recursive(const Path& dir,
+                                     const std::function<void(const Path&, FileType)>& visitor,
+                                     std::error_code& ec) const override
         {
-            if (S_ISDIR(s->st_mode))
+            stdfs::recursive_directory_iterator b(to_stdfs_path(dir), ec), e{};
+            if (ec)
             {
-                if (!want_directories)
-                {
-                    return;
-                }
+                translate_not_found_to_success(ec);
+                return;
             }
-            else if (S_ISREG(s->st_mode))
+
+            while (b != e)
             {
-                if (!want_regular_files)
+                auto type = convert_file_type(b->status(ec).type());
+                if (type == FileType::not_found)
+                {
+                    // a dangling symlink
+                    ec.clear();
+                    type = FileType::symlink;
+                }
+                else if (ec)
                 {
                     return;
                 }
-            }
-            else
-            {
-                if (!want_other)
+
+                visitor(from_stdfs_path(b->path()), type);
+                b.increment(ec);
+                if (ec)
                 {
                     return;
                 }
             }
-
-            result.push_back(full);
         }
-
-        static void get_files_recursive_impl(std::vector<Path>& result,
-                                             const Path& base,
-                                             const Path& out_base,
-                                             std::error_code& ec,
-                                             bool want_directories,
-                                             bool want_regular_files,
-                                             bool want_other)
+#else  // ^^^ _WIN32 // !_WIN32 vvv
+        static std::vector<Path> get_files_recursive_impl(const Path& dir,
+                                                          const Path& out_dir,
+                                                          std::error_code& ec,
+                                                          bool want_directories,
+                                                          bool want_regular_files,
+                                                          bool want_other)
         {
-            ReadDirOp op{base, ec};
+            std::vector<Path> result;
+            // skip the extra stat of symlinks when we want everything
+            const bool resolve_symlinks = !(want_directories && want_regular_files && want_other);
+            walk_tree(dir, out_dir, resolve_symlinks, ec, [&](std::vector<WalkedEntry>& entries) {
+                for (auto&& entry : entries)
+                {
+                    const bool wanted = vcpkg::is_directory(entry.type)      ? want_directories
+                                        : vcpkg::is_regular_file(entry.type) ? want_regular_files
+                                                                             : want_other;
+                    if (wanted)
+                    {
+                        result.push_back(std::move(entry.path));
+                    }
+                }
+            });
+
             if (ec)
             {
-                translate_not_found_to_success(ec);
+                result.clear();
             }
             else
             {
-                for (;;)
-                {
-                    errno = 0;
-                    auto entry = op.read();
-                    if (!entry)
-                    {
-                        if (errno != 0)
-                        {
-                            ec.assign(errno, std::generic_category());
-                            return;
-                        }
-
-                        // no more entries left
-                        break;
-                    }
-
-                    if (is_dot_or_dot_dot(entry->d_name))
-                    {
-                        continue;
-                    }
-
-                    const auto full = base / entry->d_name;
-                    const auto out_full = out_base / entry->d_name;
-                    const auto entry_dtype = get_d_type(entry);
-                    struct stat s;
-                    struct stat ls;
-                    switch (entry_dtype)
-                    {
-                        case PosixDType::Directory:
-                            if (want_directories)
-                            {
-                                // push results before recursion to get outer entries first
-                                result.push_back(out_full);
-                            }
-
-                            get_files_recursive_impl(
-                                result, full, out_full, ec, want_directories, want_regular_files, want_other);
-                            if (ec)
-                            {
-                                return;
-                            }
-
-                            break;
-                        case PosixDType::Regular:
-                            if (want_regular_files)
-                            {
-                                result.push_back(out_full);
-                            }
-
-                            break;
-
-                        case PosixDType::Fifo:
-                        case PosixDType::Socket:
-                        case PosixDType::CharacterDevice:
-                        case PosixDType::BlockDevice:
-                            if (want_other)
-                            {
-                                result.push_back(out_full);
-                            }
-
-                            break;
-
-                        case PosixDType::Unknown:
-                        default:
-                            if (::lstat(full.c_str(), &ls) != 0)
-                            {
-                                if (errno == ENOENT || errno == ENOTDIR)
-                                {
-                                    ec.clear();
-                                }
-                                else
-                                {
-                                    result.clear();
-                                    ec.assign(errno, std::generic_category());
-                                }
-
-                                return;
-                            }
-
-                            if (S_ISLNK(ls.st_mode))
-                            {
-                                if (want_directories && want_regular_files && want_other)
-                                {
-                                    // skip extra stat syscall since we want everything
-                                    result.push_back(out_full);
-                                }
-                                else
-                                {
-                                    if (::stat(full.c_str(), &s) != 0)
-                                    {
-                                        if (errno == ENOENT || errno == ENOTDIR)
-                                        {
-                                            ec.clear();
-                                        }
-                                        else
-                                        {
-                                            result.clear();
-                                            ec.assign(errno, std::generic_category());
-                                        }
-
-                                        return;
-                                    }
-
-                                    insert_if_stat_matches(
-                                        result, out_full, &s, want_directories, want_regular_files, want_other);
-                                }
-                            }
-                            else
-                            {
-                                // push results before recursion to get outer entries first
-                                insert_if_stat_matches(
-                                    result, out_full, &ls, want_directories, want_regular_files, want_other);
-                            }
-
-                            // recursion check doesn't follow symlinks:
-                            if (S_ISDIR(ls.st_mode))
-                            {
-                                get_files_recursive_impl(
-                                    result, full, out_full, ec, want_directories, want_regular_files, want_other);
-                            }
-                            break;
-                    }
-                }
+                // directories were read in no particular order; sorting puts outer entries first again
+                std::sort(result.begin(), result.end(), [](const Path& lhs, const Path& rhs) {
+                    return lhs.native() < rhs.native();
+                });
             }
+
+            return result;
         }
 
         // Selector is a function taking (PosixDType dtype, const Path&) and returning bool
@@ -2316,10 +2563,7 @@ namespace vcpkg
 
         virtual std::vector<Path> get_files_recursive(const Path& dir, std::error_code& ec) const override
         {
-            std::vector<Path> result;
-            Path out_base = dir;
-            get_files_recursive_impl(result, dir, out_base, ec, true, true, true);
-            return result;
+            return get_files_recursive_impl(dir, dir, ec, true, true, true);
         }
 
         virtual std::vector<Path> get_files_non_recursive(const Path& dir, std::error_code& ec) const override
@@ -2331,11 +2575,7 @@ namespace vcpkg
 
         virtual std::vector<Path> get_directories_recursive(const Path& dir, std::error_code& ec) const override
         {
-            std::vector<Path> result;
-            Path out_base = dir;
-            get_files_recursive_impl(result, dir, out_base, ec, true, false, false);
-
-            return result;
+            return get_files_recursive_impl(dir, dir, ec, true, false, false);
         }
 
         virtual std::vector<Path> get_directories_non_recursive(const Path& dir, std::error_code& ec) const override
@@ -2361,19 +2601,25 @@ namespace vcpkg
 
         virtual std::vector<Path> get_regular_files_recursive(const Path& dir, std::error_code& ec) const override
         {
-            std::vector<Path> result;
-            Path out_base = dir;
-            get_files_recursive_impl(result, dir, out_base, ec, false, true, false);
-            return result;
+            return get_files_recursive_impl(dir, dir, ec, false, true, false);
         }
 
         virtual std::vector<Path> get_regular_files_recursive_lexically_proximate(const Path& dir,
                                                                                   std::error_code& ec) const override
         {
-            std::vector<Path> result;
-            Path out_base;
-            get_files_recursive_impl(result, dir, out_base, ec, false, true, false);
-            return result;
+            return get_files_recursive_impl(dir, Path{}, ec, false, true, false);
+        }
+
+        virtual void visit_recursive(const Path& dir,
+                                     const std::function<void(const Path&, FileType)>& visitor,
+                                     std::error_code& ec) const override
+        {
+            walk_tree(dir, dir, true, ec, [&](const std::vector<WalkedEntry>& entries) {
+                for (auto&& entry : entries)
+                {
+                    visitor(entry.path, entry.type);
+                }
+            });
         }
 
         virtual std::vector<Path> get_regular_files_non_recursive(const Path& dir, std::error_code& ec) const override
@@ -3012,6 +3258,27 @@ namespace vcpkg
 
             ec.assign(errno, std::generic_category());
             return FileType::unknown;
+#endif // ^^^ !_WIN32
+        }
+        virtual int64_t last_write_time(const Path& target, std::error_code& ec) const override
+        {
+#if defined(_WIN32)
+            auto result = stdfs::last_write_time(to_stdfs_path(target), ec);
+            return std::chrono::duration_cast<std::chrono::nanoseconds>(result.time_since_epoch()).count();
+#else  // ^^^ _WIN32 // !_WIN32 vvv
+            struct stat s;
+            if (::stat(target.c_str(), &s) == 0)
+            {
+                ec.clear();
+#if defined(__APPLE__)
+                return static_cast<int64_t>(s.st_mtimespec.tv_sec) * 1000000000 + s.st_mtimespec.tv_nsec;
+#else  // ^^^ __APPLE__ // !__APPLE__ vvv
+                return static_cast<int64_t>(s.st_mtim.tv_sec) * 1000000000 + s.st_mtim.tv_nsec;
+#endif // ^^^ !__APPLE__
+            }
+
+            ec.assign(errno, std::generic_category());
+            return 0;
 #endif // ^^^ !_WIN32
         }
         virtual void write_contents(const Path& file_path, const std::string& data, std::error_code& ec) override
@@ -3282,6 +3549,11 @@ namespace vcpkg
         {
             return WriteFilePointer{file_path, ec};
         }
+
+        virtual MappedFile map_for_read(const Path& file_path, std::error_code& ec) const override
+        {
+            return MappedFile{file_path, ec};
+        }
     };
 
     Filesystem& get_real_filesystem()
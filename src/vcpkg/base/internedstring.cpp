@@ -0,0 +1,52 @@
+#include <vcpkg/base/internedstring.h>
+#include <vcpkg/base/lockguarded.h>
+
+#include <memory>
+#include <string_view>
+#include <unordered_map>
+
+namespace
+{
+    using namespace vcpkg;
+
+    struct StringViewHash
+    {
+        size_t operator()(StringView sv) const noexcept
+        {
+            return std::hash<std::string_view>()(std::string_view(sv.data(), sv.size()));
+        }
+    };
+
+    // keyed by views of the instances' own strings
+    using InstanceTable = std::unordered_map<StringView, std::unique_ptr<InternedStringInstance>, StringViewHash>;
+}
+
+namespace vcpkg
+{
+    InternedStringInstance::InternedStringInstance(std::string&& s)
+        : value(std::move(s)), hash(std::hash<std::string>()(value))
+    {
+    }
+
+    const InternedStringInstance InternedString::EMPTY_INSTANCE({});
+
+    InternedString InternedString::intern(StringView sv)
+    {
+        if (sv.empty())
+        {
+            return InternedString();
+        }
+
+        static LockGuarded<InstanceTable> g_instances;
+        LockGuardPtr<InstanceTable> instances(g_instances);
+        auto it = instances->find(sv);
+        if (it == instances->end())
+        {
+            auto instance = std::make_unique<InternedStringInstance>(sv.to_string());
+            const StringView key = instance->value;
+            it = instances->emplace(key, std::move(instance)).first;
+        }
+
+        return it->second.get();
+    }
+}
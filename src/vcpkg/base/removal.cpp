@@ -0,0 +1,297 @@
+#include <vcpkg/base/parallel-algorithms.h>
+#include <vcpkg/base/removal.h>
+#include <vcpkg/base/strings.h>
+#include <vcpkg/base/system.h>
+#include <vcpkg/base/system.print.h>
+
+#include <condition_variable>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <unordered_set>
+#include <vector>
+
+namespace
+{
+    using namespace vcpkg;
+
+    constexpr StringLiteral TOMBSTONE_MARKER = ".vcpkg-removing-";
+
+    // Returns the id of the process that created the tombstone named `filename`, or nullopt if it is not a tombstone.
+    Optional<long> tombstone_owner(StringView filename)
+    {
+        const auto name = filename.to_string();
+        const auto marker = name.rfind(TOMBSTONE_MARKER.c_str());
+        if (marker == std::string::npos)
+        {
+            return nullopt;
+        }
+
+        const auto pid_start = marker + TOMBSTONE_MARKER.size();
+        const auto pid_end = name.find('-', pid_start);
+        if (pid_end == std::string::npos)
+        {
+            return nullopt;
+        }
+
+        return Strings::strto<long>(name.substr(pid_start, pid_end - pid_start));
+    }
+
+    struct Tombstone
+    {
+        Filesystem* fs;
+        Path path;
+    };
+
+    struct RemovalState
+    {
+        std::mutex mutex;
+        std::condition_variable cv;
+        std::vector<Tombstone> pending;
+        std::vector<std::string> failures;
+        std::thread worker;
+        bool joining = false;
+        size_t next_tombstone = 0;
+        // the directories already searched for tombstones left behind by processes that were killed
+        std::unordered_set<std::string> swept_directories;
+
+        void enqueue(Filesystem& fs, Path&& tombstone)
+        {
+            {
+                std::lock_guard<std::mutex> lock(mutex);
+                pending.push_back({&fs, std::move(tombstone)});
+                if (!worker.joinable())
+                {
+                    worker = std::thread([this]() { run_worker(); });
+                }
+            }
+
+            cv.notify_one();
+        }
+
+        // The first time a removal happens in `dir`, queues any tombstones there whose process is no longer running.
+        void sweep_stale_tombstones(Filesystem& fs, const Path& dir)
+        {
+            {
+                std::lock_guard<std::mutex> lock(mutex);
+                if (!swept_directories.insert(dir.native()).second)
+                {
+                    return;
+                }
+            }
+
+            std::error_code ec;
+            const auto this_process = get_process_id();
+            for (auto&& entry : fs.get_files_non_recursive(dir, ec))
+            {
+                const auto owner = tombstone_owner(entry.filename());
+                if (auto pid = owner.get())
+                {
+                    if (*pid != this_process && !is_process_running(*pid))
+                    {
+                        enqueue(fs, std::move(entry));
+                    }
+                }
+            }
+        }
+
+        // Removes the pending tombstones, one at a time, until join() is called and there are none left.
+        void run_worker()
+        {
+            std::unique_lock<std::mutex> lock(mutex);
+            for (;;)
+            {
+                cv.wait(lock, [this]() { return joining || !pending.empty(); });
+                if (pending.empty())
+                {
+                    return;
+                }
+
+                auto tombstone = std::move(pending.back());
+                pending.pop_back();
+                lock.unlock();
+
+                std::error_code ec;
+                Path failure_point;
+                Removal::remove_all_parallel(*tombstone.fs, tombstone.path, ec, failure_point);
+
+                lock.lock();
+                if (ec)
+                {
+                    failures.push_back(Strings::concat(
+                        tombstone.path.native(), " due to ", failure_point.native(), ": ", ec.message()));
+                }
+            }
+        }
+
+        // Returns the failures since the last call.
+        std::vector<std::string> join_worker()
+        {
+            std::thread to_join;
+            {
+                std::lock_guard<std::mutex> lock(mutex);
+                joining = true;
+                to_join = std::move(worker);
+            }
+
+            cv.notify_all();
+            if (to_join.joinable())
+            {
+                to_join.join();
+            }
+
+            std::lock_guard<std::mutex> lock(mutex);
+            joining = false;
+            auto result = std::move(failures);
+            failures.clear();
+            return result;
+        }
+
+        ~RemovalState() { (void)join_worker(); }
+    };
+
+    RemovalState& removal_state()
+    {
+        static RemovalState state;
+        return state;
+    }
+}
+
+namespace vcpkg::Removal
+{
+    void remove_all_parallel(Filesystem& fs, const Path& base, std::error_code& ec, Path& failure_point)
+    {
+        const auto base_type = fs.symlink_status(base, ec);
+        if (ec)
+        {
+            failure_point = base;
+            return;
+        }
+
+        if (base_type != FileType::directory)
+        {
+            fs.remove_all(base, ec, failure_point);
+            return;
+        }
+
+        // Expand directories breadth-first, without following symlinks, until there are enough subtrees to keep
+        // every thread busy.
+        const auto wanted_subtrees = static_cast<size_t>(get_concurrency()) * 4;
+        std::vector<Path> expanded;
+        std::vector<Path> subtrees;
+        std::vector<Path> frontier{base};
+        while (!frontier.empty() && subtrees.size() + frontier.size() < wanted_subtrees)
+        {
+            std::vector<Path> next_frontier;
+            for (auto&& dir : frontier)
+            {
+                for (auto&& child : fs.get_files_non_recursive(dir, ec))
+                {
+                    const auto child_type = fs.symlink_status(child, ec);
+                    if (ec)
+                    {
+                        failure_point = child;
+                        return;
+                    }
+
+                    if (child_type == FileType::directory)
+                    {
+                        next_frontier.push_back(std::move(child));
+                    }
+                    else
+                    {
+                        subtrees.push_back(std::move(child));
+                    }
+                }
+
+                if (ec)
+                {
+                    failure_point = dir;
+                    return;
+                }
+
+                expanded.push_back(std::move(dir));
+            }
+
+            frontier = std::move(next_frontier);
+        }
+
+        subtrees.insert(
+            subtrees.end(), std::make_move_iterator(frontier.begin()), std::make_move_iterator(frontier.end()));
+
+        std::mutex mtx;
+        parallel_for_each_n(subtrees.begin(), subtrees.size(), [&](const Path& subtree) {
+            std::error_code subtree_ec;
+            Path subtree_failure_point;
+            fs.remove_all(subtree, subtree_ec, subtree_failure_point);
+            if (subtree_ec)
+            {
+                std::lock_guard<std::mutex> lock(mtx);
+                if (!ec)
+                {
+                    ec = subtree_ec;
+                    failure_point = std::move(subtree_failure_point);
+                }
+            }
+        });
+
+        if (ec)
+        {
+            return;
+        }
+
+        // the expanded directories are empty now; remove them innermost first
+        for (auto it = expanded.rbegin(); it != expanded.rend(); ++it)
+        {
+            fs.remove(*it, ec);
+            if (ec)
+            {
+                failure_point = *it;
+                return;
+            }
+        }
+    }
+
+    void remove_all_in_background(Filesystem& fs, const Path& target, std::error_code& ec, Path& failure_point)
+    {
+        auto& state = removal_state();
+        size_t tombstone_id;
+        {
+            std::lock_guard<std::mutex> lock(state.mutex);
+            tombstone_id = state.next_tombstone++;
+        }
+
+        Path tombstone = target.parent_path();
+        state.sweep_stale_tombstones(fs, tombstone);
+        tombstone /= Strings::concat(target.filename(), TOMBSTONE_MARKER, get_process_id(), '-', tombstone_id);
+        fs.rename(target, tombstone, ec);
+        if (ec)
+        {
+            // there is nothing to move aside, or it can't be moved (for example, because it is in use)
+            fs.remove_all(target, ec, failure_point);
+            return;
+        }
+
+        state.enqueue(fs, std::move(tombstone));
+    }
+
+    void remove_all_in_background(Filesystem& fs, const Path& target, LineInfo li)
+    {
+        std::error_code ec;
+        Path failure_point;
+        remove_all_in_background(fs, target, ec, failure_point);
+        if (ec)
+        {
+            Checks::exit_with_message(
+                li, "Failure to remove_all(\"%s\") due to file \"%s\": %s", target, failure_point, ec.message());
+        }
+    }
+
+    void join()
+    {
+        for (auto&& failure : removal_state().join_worker())
+        {
+            print2(Color::warning, "Warning: failed to remove ", failure, "\n");
+        }
+    }
+}
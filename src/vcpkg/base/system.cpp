@@ -1,3 +1,5 @@
+#include <vcpkg/base/system_headers.h>
+
 #include <vcpkg/base/checks.h>
 #include <vcpkg/base/chrono.h>
 #include <vcpkg/base/messages.h>
@@ -11,6 +13,11 @@
 #include <sys/sysctl.h>
 #endif
 
+#if !defined(_WIN32)
+#include <errno.h>
+#include <signal.h>
+#endif
+
 namespace
 {
     DECLARE_AND_REGISTER_MESSAGE(ProcessorArchitectureW6432Malformed,
@@ -41,6 +48,24 @@ namespace vcpkg
 #endif
     }
 
+    bool is_process_running(long pid)
+    {
+#ifdef _WIN32
+        HANDLE process = ::OpenProcess(SYNCHRONIZE, FALSE, static_cast<DWORD>(pid));
+        if (!process)
+        {
+            // any other failure, such as ERROR_ACCESS_DENIED, means that the process exists
+            return ::GetLastError() != ERROR_INVALID_PARAMETER;
+        }
+
+        const bool running = ::WaitForSingleObject(process, 0) == WAIT_TIMEOUT;
+        ::CloseHandle(process);
+        return running;
+#else
+        return ::kill(static_cast<pid_t>(pid), 0) == 0 || errno != ESRCH;
+#endif
+    }
+
     Optional<CPUArchitecture> to_cpu_architecture(StringView arch)
     {
         if (Strings::case_insensitive_ascii_equals(arch, "x86")) return CPUArchitecture::X86;
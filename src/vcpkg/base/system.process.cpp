@@ -1,14 +1,17 @@
+#include <vcpkg/base/system_headers.h>
+
 #include <vcpkg/base/checks.h>
 #include <vcpkg/base/chrono.h>
+#include <vcpkg/base/parallel-algorithms.h>
 #include <vcpkg/base/strings.h>
 #include <vcpkg/base/system.debug.h>
 #include <vcpkg/base/system.h>
 #include <vcpkg/base/system.print.h>
 #include <vcpkg/base/system.process.h>
+#include <vcpkg/base/tracing.h>
 #include <vcpkg/base/util.h>
 
 #include <ctime>
-#include <future>
 #include <sstream>
 
 #if defined(__APPLE__)
@@ -21,7 +24,17 @@
 
 #if defined(_WIN32)
 #pragma comment(lib, "Advapi32")
-#endif
+#else // ^^^ _WIN32 // !_WIN32 vvv
+#include <errno.h>
+#include <fcntl.h>
+#include <poll.h>
+#include <spawn.h>
+
+#include <sys/stat.h>
+#include <sys/wait.h>
+
+extern char** environ;
+#endif // ^^^ !_WIN32
 
 namespace vcpkg
 {
@@ -440,32 +453,9 @@ namespace vcpkg
             return {cmd_execute_and_capture_output(cmd_lines[0], wd, env)};
         }
         std::vector<ExitCodeAndOutput> res(cmd_lines.size());
-        std::atomic<size_t> work_item{0};
-
-        const auto num_threads =
-            static_cast<size_t>(std::max(1, std::min(get_concurrency(), static_cast<int>(cmd_lines.size()))));
-
-        auto work = [&cmd_lines, &res, &work_item, &wd, &env]() {
-            for (size_t item = work_item.fetch_add(1); item < cmd_lines.size(); item = work_item.fetch_add(1))
-            {
-                res[item] = cmd_execute_and_capture_output(cmd_lines[item], wd, env);
-            }
-        };
-
-        std::vector<std::future<void>> workers;
-        for (size_t x = 0; x < num_threads - 1; ++x)
-        {
-            workers.emplace_back(std::async(std::launch::async | std::launch::deferred, work));
-            if (work_item >= cmd_lines.size())
-            {
-                break;
-            }
-        }
-        work();
-        for (auto&& w : workers)
-        {
-            w.get();
-        }
+        parallel_transform(cmd_lines.begin(), cmd_lines.size(), res.begin(), [&wd, &env](const Command& cmd_line) {
+            return cmd_execute_and_capture_output(cmd_line, wd, env);
+        });
         return res;
     }
 
@@ -710,10 +700,439 @@ namespace vcpkg
 
         return {std::move(out_env)};
     }
+#else  // ^^^ _WIN32 // !_WIN32 vvv
+    // Splits a command line built by Command back into its arguments, undoing append_shell_escaped. Returns nullopt
+    // if the command line needs a shell to mean what it says, for example because of redirections, pipes,
+    // expansions, or unbalanced quotes.
+    static Optional<std::vector<std::string>> try_split_shell_words(StringView cmd_line)
+    {
+        std::vector<std::string> words;
+        std::string word;
+        bool in_word = false;
+        auto first = cmd_line.begin();
+        const auto last = cmd_line.end();
+        while (first != last)
+        {
+            const char ch = *first;
+            switch (ch)
+            {
+                case ' ':
+                case '\t':
+                case '\n':
+                    if (in_word)
+                    {
+                        words.push_back(std::move(word));
+                        word.clear();
+                        in_word = false;
+                    }
+
+                    ++first;
+                    break;
+                case '\\':
+                    ++first;
+                    if (first == last) return nullopt;
+                    if (*first != '\n') word.push_back(*first);
+                    ++first;
+                    in_word = true;
+                    break;
+                case '\'':
+                {
+                    const auto close = std::find(first + 1, last, '\'');
+                    if (close == last) return nullopt;
+                    word.append(first + 1, close);
+                    first = close + 1;
+                    in_word = true;
+                    break;
+                }
+                case '"':
+                    ++first;
+                    in_word = true;
+                    for (;;)
+                    {
+                        if (first == last) return nullopt;
+                        const char quoted = *first;
+                        if (quoted == '"')
+                        {
+                            ++first;
+                            break;
+                        }
+
+                        if (quoted == '$' || quoted == '`') return nullopt;
+                        if (quoted == '\\')
+                        {
+                            ++first;
+                            if (first == last) return nullopt;
+                            const char escaped = *first;
+                            if (escaped != '"' && escaped != '\\' && escaped != '$' && escaped != '`' &&
+                                escaped != '\n')
+                            {
+                                word.push_back('\\');
+                            }
+
+                            if (escaped != '\n') word.push_back(escaped);
+                        }
+                        else
+                        {
+                            word.push_back(quoted);
+                        }
+
+                        ++first;
+                    }
+
+                    break;
+                case '|':
+                case '&':
+                case ';':
+                case '<':
+                case '>':
+                case '(':
+                case ')':
+                case '{':
+                case '}':
+                case '$':
+                case '`':
+                case '*':
+                case '?':
+                case '[':
+                case '~': return nullopt;
+                case '#':
+                    if (!in_word) return nullopt;
+                    word.push_back(ch);
+                    ++first;
+                    break;
+                default:
+                    word.push_back(ch);
+                    ++first;
+                    in_word = true;
+                    break;
+            }
+        }
+
+        if (in_word)
+        {
+            words.push_back(std::move(word));
+        }
+
+        return words;
+    }
+
+    static bool is_variable_assignment(StringView word)
+    {
+        const auto eq = std::find(word.begin(), word.end(), '=');
+        if (eq == word.begin() || eq == word.end())
+        {
+            return false;
+        }
+
+        return std::all_of(word.begin(), eq, [](char ch) {
+            return ch == '_' || (ch >= 'a' && ch <= 'z') || (ch >= 'A' && ch <= 'Z') || (ch >= '0' && ch <= '9');
+        });
+    }
+
+    // The arguments and environment for one child process, ready to be passed to posix_spawn.
+    struct PosixProcessLaunch
+    {
+        std::vector<std::string> argv;
+        std::vector<std::string> envp;
+        // set if `argv` must be interpreted by /bin/sh
+        bool through_shell = false;
+    };
+
+    static PosixProcessLaunch make_process_launch(const Command& cmd_line, const Environment& env)
+    {
+        PosixProcessLaunch launch;
+        std::vector<std::string> overrides;
+        bool env_needs_shell = false;
+        if (!env.m_env_data.empty())
+        {
+            auto maybe_overrides = try_split_shell_words(env.m_env_data);
+            if (auto split = maybe_overrides.get())
+            {
+                overrides = std::move(*split);
+                env_needs_shell = !std::all_of(overrides.begin(), overrides.end(), is_variable_assignment);
+            }
+            else
+            {
+                env_needs_shell = true;
+            }
+        }
+
+        if (env_needs_shell)
+        {
+            overrides.clear();
+        }
+
+        for (char** var = environ; *var; ++var)
+        {
+            StringView entry{*var};
+            const auto eq = std::find(entry.begin(), entry.end(), '=');
+            const StringView name{entry.begin(), static_cast<size_t>(eq - entry.begin() + 1)};
+            if (std::none_of(overrides.begin(), overrides.end(), [&](const std::string& o) {
+                    return Strings::starts_with(o, name);
+                }))
+            {
+                launch.envp.push_back(entry.to_string());
+            }
+        }
+
+        launch.envp.insert(launch.envp.end(), overrides.begin(), overrides.end());
+
+        if (!env_needs_shell)
+        {
+            auto maybe_argv = try_split_shell_words(cmd_line.command_line());
+            if (auto argv = maybe_argv.get())
+            {
+                if (!argv->empty() && !is_variable_assignment(argv->front()))
+                {
+                    launch.argv = std::move(*argv);
+                    return launch;
+                }
+            }
+        }
+
+        std::string shell_cmd_line;
+        if (env_needs_shell)
+        {
+            shell_cmd_line = Strings::concat(env.m_env_data, ' ');
+        }
+
+        shell_cmd_line.append(cmd_line.command_line().data(), cmd_line.command_line().size());
+        launch.argv = {"/bin/sh", "-c", std::move(shell_cmd_line)};
+        launch.through_shell = true;
+        return launch;
+    }
+
+    static bool is_executable_file(const std::string& candidate)
+    {
+        struct stat s;
+        return ::stat(candidate.c_str(), &s) == 0 && S_ISREG(s.st_mode) && ::access(candidate.c_str(), X_OK) == 0;
+    }
+
+    // Finds the program `launch` runs the same way the shell would; if it is not a file on the PATH of the child's
+    // environment (for example, a shell builtin), the command is handed to the shell instead.
+    static std::string resolve_executable(PosixProcessLaunch& launch, const Path& working_directory)
+    {
+        const auto& program = launch.argv.front();
+        if (launch.through_shell || program.find('/') != std::string::npos)
+        {
+            return program;
+        }
+
+        StringView search_path = "/usr/bin:/bin";
+        for (auto&& var : launch.envp)
+        {
+            if (Strings::starts_with(var, "PATH="))
+            {
+                search_path = StringView{var}.substr(5);
+            }
+        }
+
+        for (auto&& dir : Strings::split(search_path, ':'))
+        {
+            auto candidate = std::move(dir);
+            candidate.push_back('/');
+            candidate.append(program);
+            if (candidate.front() != '/' && !working_directory.empty())
+            {
+                candidate = (working_directory / candidate).native();
+            }
+
+            if (is_executable_file(candidate))
+            {
+                return candidate;
+            }
+        }
+
+        std::string shell_cmd_line;
+        for (auto&& arg : launch.argv)
+        {
+            if (!shell_cmd_line.empty()) shell_cmd_line.push_back(' ');
+            append_shell_escaped(shell_cmd_line, arg);
+        }
+
+        launch.argv = {"/bin/sh", "-c", std::move(shell_cmd_line)};
+        launch.through_shell = true;
+        return launch.argv.front();
+    }
+
+    static std::vector<char*> to_c_strings(std::vector<std::string>& strings)
+    {
+        std::vector<char*> result;
+        result.reserve(strings.size() + 1);
+        for (auto&& s : strings)
+        {
+            result.push_back(&s[0]);
+        }
+
+        result.push_back(nullptr);
+        return result;
+    }
+
+    static int decode_wait_status(int status)
+    {
+        if (WIFEXITED(status))
+        {
+            return WEXITSTATUS(status);
+        }
+
+        if (WIFSIGNALED(status))
+        {
+            return WTERMSIG(status);
+        }
+
+        if (WIFSTOPPED(status))
+        {
+            return WSTOPSIG(status);
+        }
+
+        return status;
+    }
+
+    struct PosixPipe
+    {
+        int read_fd = -1;
+        int write_fd = -1;
+
+        PosixPipe() = default;
+        PosixPipe(const PosixPipe&) = delete;
+        PosixPipe& operator=(const PosixPipe&) = delete;
+
+        bool open() noexcept
+        {
+            int fds[2];
+#if defined(__linux__)
+            if (::pipe2(fds, O_CLOEXEC) != 0) return false;
+#else  // ^^^ __linux__ // !__linux__ vvv
+            if (::pipe(fds) != 0) return false;
+            ::fcntl(fds[0], F_SETFD, FD_CLOEXEC);
+            ::fcntl(fds[1], F_SETFD, FD_CLOEXEC);
+#endif // ^^^ !__linux__
+            read_fd = fds[0];
+            write_fd = fds[1];
+            return true;
+        }
+
+        static void close_fd(int& fd) noexcept
+        {
+            if (fd >= 0)
+            {
+                ::close(fd);
+                fd = -1;
+            }
+        }
+
+        ~PosixPipe()
+        {
+            close_fd(read_fd);
+            close_fd(write_fd);
+        }
+    };
+
+    struct PosixSpawnFileActions
+    {
+        posix_spawn_file_actions_t actions;
+
+        PosixSpawnFileActions() { Checks::check_exit(VCPKG_LINE_INFO, posix_spawn_file_actions_init(&actions) == 0); }
+        PosixSpawnFileActions(const PosixSpawnFileActions&) = delete;
+        PosixSpawnFileActions& operator=(const PosixSpawnFileActions&) = delete;
+        ~PosixSpawnFileActions() { posix_spawn_file_actions_destroy(&actions); }
+    };
+
+#if defined(__GLIBC__) && (__GLIBC__ > 2 || (__GLIBC__ == 2 && __GLIBC_MINOR__ >= 29))
+#define VCPKG_HAS_POSIX_SPAWN_ADDCHDIR 1
+#else
+#define VCPKG_HAS_POSIX_SPAWN_ADDCHDIR 0
 #endif
 
+    // Starts the child process described by `launch` without a shell (unless the command requires one). If
+    // `output_fd` is not negative, the child's stdout is redirected to it, and its stderr to `error_fd`. Returns the
+    // pid of the child, or the exit code the shell would have reported on failure.
+    static ExpectedT<pid_t, int> posix_spawn_process(const Command& cmd_line,
+                                                     const Path& working_directory,
+                                                     const Environment& env,
+                                                     int output_fd,
+                                                     int error_fd)
+    {
+        auto launch = make_process_launch(cmd_line, env);
+        const auto executable = resolve_executable(launch, working_directory);
+        Debug::print("posix_spawn(", executable, ") in '", working_directory, "': ", cmd_line.command_line(), '\n');
+
+        auto argv = to_c_strings(launch.argv);
+        auto envp = to_c_strings(launch.envp);
+
+        pid_t pid;
+        int err;
+#if !VCPKG_HAS_POSIX_SPAWN_ADDCHDIR
+        if (!working_directory.empty())
+        {
+            // without posix_spawn_file_actions_addchdir_np, the working directory must be changed between fork and
+            // exec, using only async-signal-safe functions
+            pid = ::fork();
+            if (pid == 0)
+            {
+                if (output_fd >= 0)
+                {
+                    ::dup2(output_fd, STDOUT_FILENO);
+                    ::dup2(error_fd, STDERR_FILENO);
+                }
+
+                if (::chdir(working_directory.c_str()) == 0)
+                {
+                    ::execve(executable.c_str(), argv.data(), envp.data());
+                }
+
+                ::_exit(127);
+            }
+
+            err = pid < 0 ? errno : 0;
+        }
+        else
+#endif // ^^^ !VCPKG_HAS_POSIX_SPAWN_ADDCHDIR
+        {
+            PosixSpawnFileActions file_actions;
+            if (output_fd >= 0)
+            {
+                posix_spawn_file_actions_adddup2(&file_actions.actions, output_fd, STDOUT_FILENO);
+                posix_spawn_file_actions_adddup2(&file_actions.actions, error_fd, STDERR_FILENO);
+            }
+
+#if VCPKG_HAS_POSIX_SPAWN_ADDCHDIR
+            if (!working_directory.empty())
+            {
+                posix_spawn_file_actions_addchdir_np(&file_actions.actions, working_directory.c_str());
+            }
+#endif // ^^^ VCPKG_HAS_POSIX_SPAWN_ADDCHDIR
+
+            err = ::posix_spawn(&pid, executable.c_str(), &file_actions.actions, nullptr, argv.data(), envp.data());
+        }
+
+        if (err != 0)
+        {
+            Debug::print("posix_spawn(", executable, ") failed: ", std::generic_category().message(err), '\n');
+            return {err == ENOENT ? 127 : 126, expected_right_tag};
+        }
+
+        return {pid, expected_left_tag};
+    }
+
+    static int posix_wait_for_process(pid_t pid)
+    {
+        int status;
+        while (::waitpid(pid, &status, 0) < 0)
+        {
+            if (errno != EINTR)
+            {
+                return 1;
+            }
+        }
+
+        return decode_wait_status(status);
+    }
+#endif // ^^^ !_WIN32
+
     int cmd_execute(const Command& cmd_line, InWorkingDirectory wd, const Environment& env)
     {
+        Tracing::TraceSpan span("process", cmd_line.command_line());
         auto timer = ElapsedTimer::create_started();
 #if defined(_WIN32)
         using vcpkg::g_ctrl_c_state;
@@ -729,27 +1148,17 @@ namespace vcpkg
         int exit_code = static_cast<int>(long_exit_code);
         g_ctrl_c_state.transition_from_spawn_process();
 #else
-        (void)env;
-        Command real_command_line_builder;
-        if (!wd.working_directory.empty())
+        fflush(nullptr);
+        auto maybe_pid = posix_spawn_process(cmd_line, wd.working_directory, env, -1, -1);
+        int exit_code;
+        if (auto pid = maybe_pid.get())
         {
-            real_command_line_builder.string_arg("cd");
-            real_command_line_builder.path_arg(wd.working_directory);
-            real_command_line_builder.raw_arg("&&");
+            exit_code = posix_wait_for_process(*pid);
         }
-
-        if (!env.m_env_data.empty())
+        else
         {
-            real_command_line_builder.raw_arg(env.m_env_data);
+            exit_code = maybe_pid.error();
         }
-
-        real_command_line_builder.raw_arg(cmd_line.command_line());
-
-        std::string real_command_line = std::move(real_command_line_builder).extract();
-        Debug::print("system(", real_command_line, ")\n");
-        fflush(nullptr);
-
-        int exit_code = system(real_command_line.c_str());
 #endif
         const auto elapsed = timer.us_64();
         g_subprocess_stats += elapsed;
@@ -776,6 +1185,7 @@ namespace vcpkg
                                     std::function<void(StringView)> data_cb,
                                     const Environment& env)
     {
+        Tracing::TraceSpan span("process", cmd_line.command_line());
         const auto timer = ElapsedTimer::create_started();
         const auto thread_id = []() {
             std::ostringstream ss;
@@ -795,56 +1205,57 @@ namespace vcpkg
         }();
         g_ctrl_c_state.transition_from_spawn_process();
 #else
-        (void)env;
-        std::string actual_cmd_line;
-        if (wd.working_directory.empty())
+        PosixPipe output_pipe;
+        PosixPipe error_pipe;
+        if (!output_pipe.open() || !error_pipe.open())
         {
-            actual_cmd_line = Strings::format(R"(%s 2>&1)", cmd_line.command_line());
-        }
-        else
-        {
-            actual_cmd_line = Command("cd")
-                                  .path_arg(wd.working_directory)
-                                  .raw_arg("&&")
-                                  .raw_arg(cmd_line.command_line())
-                                  .raw_arg("2>&1")
-                                  .extract();
+            return 1;
         }
 
-        Debug::print(thread_id, ": popen(", actual_cmd_line, ")\n");
         // Flush stdout before launching external process
         fflush(stdout);
 
-        const auto pipe = popen(actual_cmd_line.c_str(), "r");
-        if (pipe == nullptr)
+        auto maybe_pid =
+            posix_spawn_process(cmd_line, wd.working_directory, env, output_pipe.write_fd, error_pipe.write_fd);
+        PosixPipe::close_fd(output_pipe.write_fd);
+        PosixPipe::close_fd(error_pipe.write_fd);
+        auto pid = maybe_pid.get();
+        if (!pid)
         {
-            return 1;
-        }
-        char buf[1024];
-        // Use fgets because fread will block until the entire buffer is filled.
-        while (fgets(buf, 1024, pipe))
-        {
-            data_cb(StringView{buf, strlen(buf)});
+            return maybe_pid.error();
         }
 
-        if (!feof(pipe))
+        // stdout and stderr are drained as they become readable, so that neither pipe can fill up and block the
+        // child while the other is being read
+        pollfd fds[2] = {{output_pipe.read_fd, POLLIN, 0}, {error_pipe.read_fd, POLLIN, 0}};
+        nfds_t open_fds = 2;
+        std::vector<char> buf(64 * 1024);
+        while (open_fds != 0)
         {
-            return 1;
-        }
+            if (::poll(fds, 2, -1) < 0)
+            {
+                if (errno == EINTR) continue;
+                break;
+            }
 
-        auto exit_code = pclose(pipe);
-        if (WIFEXITED(exit_code))
-        {
-            exit_code = WEXITSTATUS(exit_code);
-        }
-        else if (WIFSIGNALED(exit_code))
-        {
-            exit_code = WTERMSIG(exit_code);
-        }
-        else if (WIFSTOPPED(exit_code))
-        {
-            exit_code = WSTOPSIG(exit_code);
+            for (auto& fd : fds)
+            {
+                if (fd.fd < 0 || fd.revents == 0) continue;
+                const auto bytes_read = ::read(fd.fd, buf.data(), buf.size());
+                if (bytes_read > 0)
+                {
+                    data_cb(StringView{buf.data(), static_cast<size_t>(bytes_read)});
+                }
+                else if (bytes_read == 0 || errno != EINTR)
+                {
+                    // poll ignores negative descriptors
+                    fd.fd = -1;
+                    --open_fds;
+                }
+            }
         }
+
+        const auto exit_code = posix_wait_for_process(*pid);
 #endif
         const auto elapsed = timer.us_64();
         g_subprocess_stats += elapsed;
@@ -0,0 +1,142 @@
+#include <vcpkg/base/chrono.h>
+#include <vcpkg/base/json.h>
+#include <vcpkg/base/system.debug.h>
+#include <vcpkg/base/tracing.h>
+
+#include <atomic>
+#include <mutex>
+#include <vector>
+
+namespace
+{
+    using namespace vcpkg;
+
+    struct TraceEvent
+    {
+        StringLiteral category;
+        std::string name;
+        uint64_t thread_id;
+        uint64_t start_us;
+        uint64_t duration_us;
+    };
+
+    std::atomic<bool> g_tracing_enabled(false);
+    std::atomic<uint64_t> g_next_thread_id(1);
+
+    struct TraceState
+    {
+        ElapsedTimer timer;
+        Path trace_file;
+        std::mutex mutex;
+        std::vector<TraceEvent> events;
+    };
+
+    TraceState& trace_state()
+    {
+        static TraceState state;
+        return state;
+    }
+
+    // Chrome trace viewers expect small integers; the ids are handed out in the order threads first record a span.
+    uint64_t current_thread_id()
+    {
+        thread_local const uint64_t id = g_next_thread_id.fetch_add(1);
+        return id;
+    }
+
+    Json::Object make_event(StringView category, StringView name, StringLiteral phase, uint64_t thread_id)
+    {
+        Json::Object obj;
+        obj.insert("name", Json::Value::string(name.to_string()));
+        obj.insert("cat", Json::Value::string(category.to_string()));
+        obj.insert("ph", Json::Value::string(phase.to_string()));
+        obj.insert("pid", Json::Value::integer(1));
+        obj.insert("tid", Json::Value::integer(static_cast<int64_t>(thread_id)));
+        return obj;
+    }
+}
+
+namespace vcpkg::Tracing
+{
+    void start(const Path& trace_file)
+    {
+        auto& state = trace_state();
+        {
+            std::lock_guard<std::mutex> lock(state.mutex);
+            state.timer = ElapsedTimer::create_started();
+            state.trace_file = trace_file;
+        }
+
+        // the thread that starts tracing is shown first
+        (void)current_thread_id();
+        g_tracing_enabled = true;
+    }
+
+    bool is_enabled() noexcept { return g_tracing_enabled.load(std::memory_order_relaxed); }
+
+    std::string serialize_trace()
+    {
+        auto& state = trace_state();
+        std::lock_guard<std::mutex> lock(state.mutex);
+        Json::Array events;
+        for (auto&& event : state.events)
+        {
+            auto obj = make_event(event.category, event.name, "X", event.thread_id);
+            obj.insert("ts", Json::Value::integer(static_cast<int64_t>(event.start_us)));
+            obj.insert("dur", Json::Value::integer(static_cast<int64_t>(event.duration_us)));
+            events.push_back(std::move(obj));
+        }
+
+        // the whole run, which every other span on the main thread nests in
+        auto root = make_event("vcpkg", "vcpkg", "X", 1);
+        root.insert("ts", Json::Value::integer(0));
+        root.insert("dur", Json::Value::integer(static_cast<int64_t>(state.timer.us_64())));
+        events.push_back(std::move(root));
+
+        Json::Object trace;
+        trace.insert("traceEvents", std::move(events));
+        trace.insert("displayTimeUnit", Json::Value::string("ms"));
+        return Json::stringify(trace, {});
+    }
+
+    void finish(Filesystem& fs)
+    {
+        if (!is_enabled())
+        {
+            return;
+        }
+
+        g_tracing_enabled = false;
+        const auto contents = serialize_trace();
+        std::error_code ec;
+        fs.write_contents_and_dirs(trace_state().trace_file, contents, ec);
+        if (ec)
+        {
+            Debug::print("Failed to write trace to ", trace_state().trace_file, ": ", ec.message(), '\n');
+        }
+    }
+
+    TraceSpan::TraceSpan(StringLiteral category, StringView name)
+        : m_category(category), m_start_us(0), m_enabled(is_enabled())
+    {
+        if (m_enabled)
+        {
+            m_name = name.to_string();
+            m_start_us = trace_state().timer.us_64();
+        }
+    }
+
+    TraceSpan::~TraceSpan()
+    {
+        if (!m_enabled)
+        {
+            return;
+        }
+
+        auto& state = trace_state();
+        const auto end_us = state.timer.us_64();
+        const auto thread_id = current_thread_id();
+        std::lock_guard<std::mutex> lock(state.mutex);
+        state.events.push_back({m_category, std::move(m_name), thread_id, m_start_us, end_us - m_start_us});
+    }
+}
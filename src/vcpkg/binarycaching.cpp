@@ -3,10 +3,12 @@
 #include <vcpkg/base/files.h>
 #include <vcpkg/base/messages.h>
 #include <vcpkg/base/parse.h>
+#include <vcpkg/base/removal.h>
 #include <vcpkg/base/strings.h>
 #include <vcpkg/base/system.debug.h>
 #include <vcpkg/base/system.print.h>
 #include <vcpkg/base/system.process.h>
+#include <vcpkg/base/tracing.h>
 #include <vcpkg/base/xmlserializer.h>
 
 #include <vcpkg/binarycaching.h>
@@ -178,7 +180,7 @@ namespace
 
     static void clean_prepare_dir(Filesystem& fs, const Path& dir)
     {
-        fs.remove_all(dir, VCPKG_LINE_INFO);
+        Removal::remove_all_in_background(fs, dir, VCPKG_LINE_INFO);
         bool created_last = fs.create_directories(dir, VCPKG_LINE_INFO);
         Checks::check_exit(VCPKG_LINE_INFO, created_last, "unable to clear path: %s", dir);
     }
@@ -240,9 +242,9 @@ namespace
 #endif
     }
 
-    static Path make_temp_archive_path(const Path& buildtrees, const PackageSpec& spec)
+    static Path make_temp_archive_path(const VcpkgPaths& paths, const PackageSpec& spec)
     {
-        return buildtrees / spec.name() / (spec.triplet().to_string() + ".zip");
+        return paths.build_dir(spec) / (spec.triplet().to_string() + ".zip");
     }
 
     struct ArchivesBinaryProvider : IBinaryProvider
@@ -383,7 +385,7 @@ namespace
             auto& spec = action.spec;
             auto& fs = paths.get_filesystem();
             const auto archive_subpath = make_archive_subpath(abi_tag);
-            const auto tmp_archive_path = make_temp_archive_path(paths.buildtrees(), spec);
+            const auto tmp_archive_path = make_temp_archive_path(paths, spec);
             compress_directory(paths, paths.package_dir(spec), tmp_archive_path);
             size_t http_remotes_pushed = 0;
             for (auto&& put_url_template : m_put_url_templates)
@@ -513,7 +515,7 @@ namespace
                     clean_prepare_dir(fs, paths.package_dir(action.spec));
                     auto uri = Strings::replace_all(
                         url_template, "<SHA>", action.package_abi().value_or_exit(VCPKG_LINE_INFO));
-                    url_paths.emplace_back(std::move(uri), make_temp_archive_path(paths.buildtrees(), action.spec));
+                    url_paths.emplace_back(std::move(uri), make_temp_archive_path(paths, action.spec));
                     url_indices.push_back(idx);
                 }
 
@@ -735,7 +737,7 @@ namespace
 
                 const auto& action = actions[idx];
                 const auto& spec = action.spec;
-                fs.remove_all(paths.package_dir(spec), VCPKG_LINE_INFO);
+                Removal::remove_all_in_background(fs, paths.package_dir(spec), VCPKG_LINE_INFO);
                 attempts.push_back({spec, make_nugetref(action, get_nuget_prefix()), idx});
             }
 
@@ -875,7 +877,7 @@ namespace
             auto& spec = action.spec;
 
             NugetReference nuget_ref = make_nugetref(action, get_nuget_prefix());
-            auto nuspec_path = paths.buildtrees() / spec.name() / (spec.triplet().to_string() + ".nuspec");
+            auto nuspec_path = paths.build_dir(spec) / (spec.triplet().to_string() + ".nuspec");
             auto& fs = paths.get_filesystem();
             fs.write_contents(
                 nuspec_path, generate_nuspec(paths.package_dir(spec), action, nuget_ref), VCPKG_LINE_INFO);
@@ -1052,7 +1054,7 @@ namespace
                     auto&& action = actions[idx];
                     clean_prepare_dir(fs, paths.package_dir(action.spec));
                     url_paths.emplace_back(make_gcs_path(prefix, action.package_abi().value_or_exit(VCPKG_LINE_INFO)),
-                                           make_temp_archive_path(paths.buildtrees(), action.spec));
+                                           make_temp_archive_path(paths, action.spec));
                     url_indices.push_back(idx);
                 }
 
@@ -1105,7 +1107,7 @@ namespace
             if (m_write_prefixes.empty()) return;
             const auto& abi = action.package_abi().value_or_exit(VCPKG_LINE_INFO);
             auto& spec = action.spec;
-            const auto tmp_archive_path = make_temp_archive_path(paths.buildtrees(), spec);
+            const auto tmp_archive_path = make_temp_archive_path(paths, spec);
             compress_directory(paths, paths.package_dir(spec), tmp_archive_path);
 
             size_t upload_count = 0;
@@ -1234,7 +1236,7 @@ namespace
                     auto&& action = actions[idx];
                     clean_prepare_dir(fs, paths.package_dir(action.spec));
                     url_paths.emplace_back(make_aws_path(prefix, action.package_abi().value_or_exit(VCPKG_LINE_INFO)),
-                                           make_temp_archive_path(paths.buildtrees(), action.spec));
+                                           make_temp_archive_path(paths, action.spec));
                     url_indices.push_back(idx);
                 }
 
@@ -1286,7 +1288,7 @@ namespace
             if (m_write_prefixes.empty()) return;
             const auto& abi = action.package_abi().value_or_exit(VCPKG_LINE_INFO);
             auto& spec = action.spec;
-            const auto tmp_archive_path = make_temp_archive_path(paths.buildtrees(), spec);
+            const auto tmp_archive_path = make_temp_archive_path(paths, spec);
             compress_directory(paths, paths.package_dir(spec), tmp_archive_path);
 
             size_t upload_count = 0;
@@ -1375,6 +1377,7 @@ namespace vcpkg
 
     RestoreResult BinaryCache::try_restore(const Dependencies::InstallPlanAction& action)
     {
+        Tracing::TraceSpan span("binarycache", Strings::concat("restore ", action.spec));
         const auto abi = action.package_abi().get();
         if (!abi)
         {
@@ -1442,6 +1445,7 @@ namespace vcpkg
 
     void BinaryCache::prefetch(View<Dependencies::InstallPlanAction> actions)
     {
+        Tracing::TraceSpan span("binarycache", "prefetch");
         std::vector<CacheStatus*> cache_status{actions.size()};
         for (size_t idx = 0; idx < actions.size(); ++idx)
         {
@@ -31,11 +31,13 @@ namespace vcpkg
 
     BinaryParagraph::BinaryParagraph() = default;
 
-    BinaryParagraph::BinaryParagraph(Parse::Paragraph fields)
+    BinaryParagraph::BinaryParagraph(Parse::Paragraph fields) : BinaryParagraph(Parse::to_field_views(fields)) { }
+
+    BinaryParagraph::BinaryParagraph(View<Parse::ParagraphFieldView> fields)
     {
         using namespace vcpkg::Parse;
 
-        ParagraphParser parser(std::move(fields));
+        ParagraphViewParser parser(fields);
 
         {
             auto name = parser.required_field(Fields::PACKAGE);
@@ -4,11 +4,14 @@
 #include <vcpkg/base/hash.h>
 #include <vcpkg/base/messages.h>
 #include <vcpkg/base/optional.h>
+#include <vcpkg/base/parallel-algorithms.h>
+#include <vcpkg/base/removal.h>
 #include <vcpkg/base/stringliteral.h>
 #include <vcpkg/base/system.debug.h>
 #include <vcpkg/base/system.print.h>
 #include <vcpkg/base/system.process.h>
 #include <vcpkg/base/system.proxy.h>
+#include <vcpkg/base/tracing.h>
 #include <vcpkg/base/util.h>
 
 #include <vcpkg/binarycaching.h>
@@ -19,6 +22,7 @@
 #include <vcpkg/commands.version.h>
 #include <vcpkg/compilation-flags-factory.h>
 #include <vcpkg/compile-triplet.h>
+#include <vcpkg/compiler-info.h>
 #include <vcpkg/dependencies.h>
 #include <vcpkg/documentation.h>
 #include <vcpkg/globalstate.h>
@@ -740,7 +744,8 @@ namespace vcpkg::Build
 
     static std::vector<CMakeVariable> get_cmake_build_args(const VcpkgCmdArguments& args,
                                                            const VcpkgPaths& paths,
-                                                           const Dependencies::InstallPlanAction& action)
+                                                           const Dependencies::InstallPlanAction& action,
+                                                           OnlyDownloads only_downloads)
     {
 #if !defined(_WIN32)
         // TODO: remove when vcpkg.exe is in charge for acquiring tools. Change introduced in vcpkg v0.0.107.
@@ -810,7 +815,7 @@ namespace vcpkg::Build
             action.abi_info.value_or_exit(VCPKG_LINE_INFO).toolset.value_or_exit(VCPKG_LINE_INFO),
             variables);
 
-        if (Util::Enum::to_bool(action.build_options.only_downloads))
+        if (Util::Enum::to_bool(only_downloads))
         {
             variables.push_back({"VCPKG_DOWNLOAD_MODE", "true"});
         }
@@ -890,9 +895,13 @@ namespace vcpkg::Build
         }
     }
 
+    // When `echo_output` is false the output of the port scripts only goes to the stdout log in the buildtree, so
+    // that several builds can run at once without interleaving their output.
     static ExtendedBuildResult do_build_package(const VcpkgCmdArguments& args,
                                                 const VcpkgPaths& paths,
-                                                const Dependencies::InstallPlanAction& action)
+                                                const Dependencies::InstallPlanAction& action,
+                                                OnlyDownloads only_downloads,
+                                                bool echo_output)
     {
         const auto& pre_build_info = action.pre_build_info(VCPKG_LINE_INFO);
 
@@ -921,15 +930,18 @@ namespace vcpkg::Build
 
         const auto timer = ElapsedTimer::create_started();
 
-        auto command = vcpkg::make_cmake_cmd(paths, paths.ports_cmake, get_cmake_build_args(args, paths, action));
+        auto command = vcpkg::make_cmake_cmd(paths,
+                                             paths.ports_cmake,
+                                             get_cmake_build_args(args, paths, action, only_downloads),
+                                             paths.buildtrees_root(action.spec));
 
         const auto& env = paths.get_action_env(action.abi_info.value_or_exit(VCPKG_LINE_INFO));
 
-        auto buildpath = paths.buildtrees() / action.spec.name();
+        auto buildpath = paths.build_dir(action.spec);
         if (!fs.exists(buildpath, IgnoreErrors{}))
         {
             std::error_code err;
-            fs.create_directory(buildpath, err);
+            fs.create_directories(buildpath, err);
             Checks::check_exit(
                 VCPKG_LINE_INFO, !err.value(), "Failed to create directory '%s', code: %d", buildpath, err.value());
         }
@@ -940,7 +952,11 @@ namespace vcpkg::Build
             return_code = cmd_execute_and_stream_data(
                 command,
                 [&](StringView sv) {
-                    print2(sv);
+                    if (echo_output)
+                    {
+                        print2(sv);
+                    }
+
                     Checks::check_exit(VCPKG_LINE_INFO,
                                        out_file.write(sv.data(), 1, sv.size()) == sv.size(),
                                        "Error occurred while writing '%s'",
@@ -950,7 +966,7 @@ namespace vcpkg::Build
         } // close out_file
 
         // With the exception of empty packages, builds in "Download Mode" always result in failure.
-        if (action.build_options.only_downloads == Build::OnlyDownloads::YES)
+        if (only_downloads == Build::OnlyDownloads::YES)
         {
             // TODO: Capture executed command output and evaluate whether the failure was intended.
             // If an unintended error occurs then return a BuildResult::DOWNLOAD_FAILURE status.
@@ -1023,9 +1039,10 @@ namespace vcpkg::Build
 
     static ExtendedBuildResult do_build_package_and_clean_buildtrees(const VcpkgCmdArguments& args,
                                                                      const VcpkgPaths& paths,
-                                                                     const Dependencies::InstallPlanAction& action)
+                                                                     const Dependencies::InstallPlanAction& action,
+                                                                     bool echo_output)
     {
-        auto result = do_build_package(args, paths, action);
+        auto result = do_build_package(args, paths, action, action.build_options.only_downloads, echo_output);
 
         if (action.build_options.clean_buildtrees == CleanBuildtrees::YES)
         {
@@ -1034,7 +1051,9 @@ namespace vcpkg::Build
             auto buildtree_dirs = fs.get_directories_non_recursive(paths.build_dir(action.spec), IgnoreErrors{});
             for (auto&& dir : buildtree_dirs)
             {
-                fs.remove_all(dir, IgnoreErrors{});
+                std::error_code ec;
+                Path failure_point;
+                Removal::remove_all_in_background(fs, dir, ec, failure_point);
             }
         }
 
@@ -1062,6 +1081,32 @@ namespace vcpkg::Build
         }
     }
 
+    // The registered compiler's fingerprint identifies the binaries themselves, so that packages built by different
+    // compilers under the same nickname don't share an ABI.
+    static void abi_entry_from_compiler(const VcpkgPaths& paths,
+                                        const bin2sth::CompileTriplet& compile_triplet,
+                                        std::vector<AbiEntry>& abi_tag_entries)
+    {
+        const auto& compilers = paths.get_available_compilers();
+        auto it = compilers.find(compile_triplet.compiler_tag());
+        if (it == compilers.end())
+        {
+            return;
+        }
+
+        if (it->second.fingerprint.empty())
+        {
+            Debug::print("Compiler ",
+                         it->first,
+                         " was registered without a fingerprint; register it again to include its binaries in the "
+                         "ABI\n");
+            abi_tag_entries.emplace_back("compiler", it->first);
+            return;
+        }
+
+        abi_tag_entries.emplace_back("compiler", it->second.fingerprint);
+    }
+
     struct AbiTagAndFile
     {
         const std::string* triplet_abi;
@@ -1106,8 +1151,10 @@ namespace vcpkg::Build
         abi_tag_entries.emplace_back("triplet", triplet.canonical_name());
         abi_tag_entries.emplace_back("triplet_abi", triplet_abi);
         if (auto const* p_compile_triplet = action.spec.compile_triplet().get())
+        {
             abi_tag_entries.emplace_back("compile_triplet", p_compile_triplet->canonical_name());
-        // TODO: generate compilation_abi from the interpreted compile_triplet?
+            abi_entry_from_compiler(paths, *p_compile_triplet, abi_tag_entries);
+        }
         abi_entries_from_abi_info(abi_info, abi_tag_entries);
 
         // If there is an unusually large number of files in the port then
@@ -1190,7 +1237,7 @@ namespace vcpkg::Build
         if (abi_tag_entries_missing.empty())
         {
             auto current_build_tree = paths.build_dir(action.spec);
-            fs.create_directory(current_build_tree, VCPKG_LINE_INFO);
+            fs.create_directories(current_build_tree, VCPKG_LINE_INFO);
             const auto abi_file_path = current_build_tree / (triplet.canonical_name() + ".vcpkg_abi_info.txt");
             fs.write_contents(abi_file_path, full_abi_info, VCPKG_LINE_INFO);
 
@@ -1213,11 +1260,14 @@ namespace vcpkg::Build
                           const StatusParagraphs& status_db)
     {
         using Dependencies::InstallPlanAction;
+        Tracing::TraceSpan span("abi", "compute_all_abis");
         for (auto it = action_plan.install_actions.begin(); it != action_plan.install_actions.end(); ++it)
         {
             auto& action = *it;
             if (action.abi_info.has_value()) continue;
 
+            Tracing::TraceSpan action_span("abi", Strings::concat("abi ", action.spec));
+
             std::vector<AbiEntry> dependency_abis;
             if (!Util::Enum::to_bool(action.build_options.only_downloads))
             {
@@ -1264,14 +1314,10 @@ namespace vcpkg::Build
         }
     }
 
-    ExtendedBuildResult build_package(const VcpkgCmdArguments& args,
-                                      const VcpkgPaths& paths,
-                                      const Dependencies::InstallPlanAction& action,
-                                      BinaryCache& binary_cache,
-                                      const IBuildLogsRecorder& build_logs_recorder,
-                                      const StatusParagraphs& status_db)
+    // Returns the dependencies of `action` that are not installed yet.
+    static std::vector<FeatureSpec> find_missing_dependencies(const Dependencies::InstallPlanAction& action,
+                                                              const StatusParagraphs& status_db)
     {
-        auto& filesystem = paths.get_filesystem();
         auto& spec = action.spec;
         const std::string& name = action.source_control_file_and_location.value_or_exit(VCPKG_LINE_INFO)
                                       .source_control_file->core_paragraph->name;
@@ -1288,36 +1334,38 @@ namespace vcpkg::Build
             }
         }
 
-        if (!missing_fspecs.empty() && !Util::Enum::to_bool(action.build_options.only_downloads))
+        if (!missing_fspecs.empty() || Util::Enum::to_bool(action.build_options.only_downloads))
         {
-            return {BuildResult::CASCADED_DUE_TO_MISSING_DEPENDENCIES, std::move(missing_fspecs)};
+            return missing_fspecs;
         }
 
-        std::vector<AbiEntry> dependency_abis;
         for (auto&& pspec : action.package_dependencies)
         {
-            if (pspec == spec || Util::Enum::to_bool(action.build_options.only_downloads))
+            if (pspec == spec)
             {
                 continue;
             }
             const auto status_it = status_db.find_installed(pspec);
             Checks::check_exit(VCPKG_LINE_INFO, status_it != status_db.end());
-            dependency_abis.emplace_back(
-                AbiEntry{status_it->get()->package.spec.name(), status_it->get()->package.abi});
         }
 
-        auto& abi_info = action.abi_info.value_or_exit(VCPKG_LINE_INFO);
-        if (!abi_info.abi_tag_file)
-        {
-            return do_build_package_and_clean_buildtrees(args, paths, action);
-        }
+        return missing_fspecs;
+    }
 
-        auto& abi_file = *abi_info.abi_tag_file.get();
+    // Records the result of a build of `action` and, when it succeeded, stores the package in the binary cache.
+    static void finish_build_package(const VcpkgPaths& paths,
+                                     const Dependencies::InstallPlanAction& action,
+                                     const ExtendedBuildResult& result,
+                                     BinaryCache& binary_cache,
+                                     const IBuildLogsRecorder& build_logs_recorder)
+    {
+        auto& filesystem = paths.get_filesystem();
+        auto& spec = action.spec;
+        auto& abi_file = *action.abi_info.value_or_exit(VCPKG_LINE_INFO).abi_tag_file.get();
 
         const auto abi_package_dir = paths.package_dir(spec) / "share" / spec.name();
         const auto abi_file_in_package = abi_package_dir / "vcpkg_abi_info.txt";
 
-        ExtendedBuildResult result = do_build_package_and_clean_buildtrees(args, paths, action);
         build_logs_recorder.record_build_result(paths, spec, result.code);
 
         std::error_code ec;
@@ -1345,10 +1393,107 @@ namespace vcpkg::Build
         {
             binary_cache.push_success(action);
         }
+    }
+
+    ExtendedBuildResult build_package(const VcpkgCmdArguments& args,
+                                      const VcpkgPaths& paths,
+                                      const Dependencies::InstallPlanAction& action,
+                                      BinaryCache& binary_cache,
+                                      const IBuildLogsRecorder& build_logs_recorder,
+                                      const StatusParagraphs& status_db)
+    {
+        Tracing::TraceSpan span("build", Strings::concat("build ", action.spec));
+        auto missing_fspecs = find_missing_dependencies(action, status_db);
+        if (!missing_fspecs.empty() && !Util::Enum::to_bool(action.build_options.only_downloads))
+        {
+            return {BuildResult::CASCADED_DUE_TO_MISSING_DEPENDENCIES, std::move(missing_fspecs)};
+        }
+
+        auto& abi_info = action.abi_info.value_or_exit(VCPKG_LINE_INFO);
+        if (!abi_info.abi_tag_file)
+        {
+            return do_build_package_and_clean_buildtrees(args, paths, action, true);
+        }
 
+        ExtendedBuildResult result = do_build_package_and_clean_buildtrees(args, paths, action, true);
+        finish_build_package(paths, action, result, binary_cache, build_logs_recorder);
         return result;
     }
 
+    std::vector<ExtendedBuildResult> build_package_variants(const VcpkgCmdArguments& args,
+                                                            const VcpkgPaths& paths,
+                                                            View<const Dependencies::InstallPlanAction*> variants,
+                                                            BinaryCache& binary_cache,
+                                                            const IBuildLogsRecorder& build_logs_recorder,
+                                                            const StatusParagraphs& status_db,
+                                                            std::vector<ElapsedTime>& timings)
+    {
+        std::vector<ExtendedBuildResult> results;
+        results.reserve(variants.size());
+        std::vector<ElapsedTime::duration> elapsed(variants.size());
+        const auto to_timings = [&elapsed, &timings]() {
+            timings = Util::fmap(elapsed, [](ElapsedTime::duration d) { return ElapsedTime(d); });
+        };
+
+        std::vector<size_t> to_build;
+        for (auto variant : variants)
+        {
+            if (Util::Enum::to_bool(variant->build_options.only_downloads))
+            {
+                // the variants would all download the same sources
+                const auto timer = ElapsedTimer::create_started();
+                results.push_back(build_package(args, paths, *variant, binary_cache, build_logs_recorder, status_db));
+                elapsed[results.size() - 1] = timer.elapsed().as<ElapsedTime::duration>();
+                continue;
+            }
+
+            auto missing_fspecs = find_missing_dependencies(*variant, status_db);
+            if (missing_fspecs.empty())
+            {
+                to_build.push_back(results.size());
+            }
+
+            results.emplace_back(BuildResult::CASCADED_DUE_TO_MISSING_DEPENDENCIES, std::move(missing_fspecs));
+        }
+
+        if (to_build.empty())
+        {
+            to_timings();
+            return results;
+        }
+
+        Tracing::TraceSpan span(
+            "build", Strings::format("build %zd variants of %s", to_build.size(), variants[0]->spec.to_string()));
+
+        // Run the port once in download mode so that the sources are downloaded before the variants race for them.
+        // This also fills the tool and environment caches, which must not be filled concurrently.
+        // The time spent downloading is counted for the variant it ran for.
+        vcpkg::printf("Downloading sources for %s...\n", variants[to_build[0]]->displayname());
+        const auto download_timer = ElapsedTimer::create_started();
+        (void)do_build_package(args, paths, *variants[to_build[0]], OnlyDownloads::YES, true);
+        elapsed[to_build[0]] = download_timer.elapsed().as<ElapsedTime::duration>();
+
+        parallel_for_each_n(to_build.begin(), to_build.size(), [&](size_t idx) {
+            const auto timer = ElapsedTimer::create_started();
+            results[idx] = do_build_package_and_clean_buildtrees(args, paths, *variants[idx], false);
+            elapsed[idx] += timer.elapsed().as<ElapsedTime::duration>();
+        });
+
+        for (auto idx : to_build)
+        {
+            auto& variant = *variants[idx];
+            if (variant.abi_info.value_or_exit(VCPKG_LINE_INFO).abi_tag_file)
+            {
+                const auto timer = ElapsedTimer::create_started();
+                finish_build_package(paths, variant, results[idx], binary_cache, build_logs_recorder);
+                elapsed[idx] += timer.elapsed().as<ElapsedTime::duration>();
+            }
+        }
+
+        to_timings();
+        return results;
+    }
+
     const std::string& to_string(const BuildResult build_result)
     {
         static const std::string NULLVALUE_STRING = "vcpkg::Commands::Build::BuildResult_NULLVALUE";
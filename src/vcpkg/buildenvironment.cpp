@@ -9,11 +9,19 @@ namespace vcpkg
     Command make_cmake_cmd(const VcpkgPaths& paths,
                            const Path& cmake_script,
                            std::vector<CMakeVariable>&& pass_variables)
+    {
+        return make_cmake_cmd(paths, cmake_script, std::move(pass_variables), paths.buildtrees());
+    }
+
+    Command make_cmake_cmd(const VcpkgPaths& paths,
+                           const Path& cmake_script,
+                           std::vector<CMakeVariable>&& pass_variables,
+                           const Path& buildtrees_dir)
     {
         auto local_variables = std::move(pass_variables);
         local_variables.emplace_back("VCPKG_ROOT_DIR", paths.root);
         local_variables.emplace_back("PACKAGES_DIR", paths.packages());
-        local_variables.emplace_back("BUILDTREES_DIR", paths.buildtrees());
+        local_variables.emplace_back("BUILDTREES_DIR", buildtrees_dir);
         local_variables.emplace_back("_VCPKG_INSTALLED_DIR", paths.installed().root());
         local_variables.emplace_back("DOWNLOADS", paths.downloads);
         local_variables.emplace_back("VCPKG_MANIFEST_INSTALL", "OFF");
@@ -3,6 +3,7 @@
 #include <vcpkg/base/span.h>
 #include <vcpkg/base/system.print.h>
 #include <vcpkg/base/system.process.h>
+#include <vcpkg/base/tracing.h>
 #include <vcpkg/base/util.h>
 
 #include <vcpkg/buildenvironment.h>
@@ -257,6 +258,7 @@ endfunction()
         static constexpr CStringView BLOCK_START_GUID = "c35112b6-d1ba-415b-aa5d-81de856ef8eb";
         static constexpr CStringView BLOCK_END_GUID = "e1e74b5c-18cb-4474-a6bd-5c1c8bc81f3f";
 
+        Tracing::TraceSpan span("cmakevars", Strings::concat("cmake vars for ", vars.size(), " ports"));
         const auto cmd_launch_cmake = vcpkg::make_cmake_cmd(paths, script_path, {});
 
         std::vector<std::string> lines;
@@ -1,5 +1,6 @@
 #include <vcpkg/base/checks.h>
 #include <vcpkg/base/files.h>
+#include <vcpkg/base/removal.h>
 #include <vcpkg/base/system.print.h>
 
 #include <vcpkg/commands.ciclean.h>
@@ -17,7 +18,10 @@ namespace
         if (fs.is_directory(target))
         {
             print2("Clearing contents of ", target, "\n");
-            fs.remove_all_inside(target, VCPKG_LINE_INFO);
+            for (auto&& entry : fs.get_files_non_recursive(target, VCPKG_LINE_INFO))
+            {
+                Removal::remove_all_in_background(fs, entry, VCPKG_LINE_INFO);
+            }
         }
         else
         {
@@ -36,6 +40,7 @@ namespace vcpkg::Commands::CIClean
         clear_directory(fs, paths.buildtrees());
         clear_directory(fs, paths.installed().root());
         clear_directory(fs, paths.packages());
+        Removal::join();
         print2("Completed vcpkg CI clean\n");
         Checks::exit_success(VCPKG_LINE_INFO);
     }
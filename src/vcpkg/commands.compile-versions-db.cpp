@@ -0,0 +1,59 @@
+#include <vcpkg/base/checks.h>
+#include <vcpkg/base/files.h>
+#include <vcpkg/base/system.print.h>
+
+#include <vcpkg/commands.compile-versions-db.h>
+#include <vcpkg/registries.h>
+#include <vcpkg/vcpkgcmdarguments.h>
+#include <vcpkg/vcpkgpaths.h>
+
+namespace vcpkg::Commands::CompileVersionsDb
+{
+    const CommandStructure COMMAND_STRUCTURE{
+        create_example_string("x-compile-versions-db"),
+        0,
+        0,
+        {{}, {}, {}},
+        nullptr,
+    };
+
+    void perform_and_exit(const VcpkgCmdArguments& args, const VcpkgPaths& paths)
+    {
+        (void)args.parse_arguments(COMMAND_STRUCTURE);
+
+        auto& fs = paths.get_filesystem();
+        auto maybe_tree = paths.git_builtin_registry_versions_tree();
+        auto tree = maybe_tree.get();
+        if (!tree)
+        {
+            print2(Color::error,
+                   "Error: the versions database can only be compiled from committed files: ",
+                   maybe_tree.error(),
+                   '\n');
+            Checks::exit_fail(VCPKG_LINE_INFO);
+        }
+
+        auto maybe_db = compile_versions_db(fs, paths.builtin_registry_versions, *tree);
+        auto db = maybe_db.get();
+        if (!db)
+        {
+            print2(Color::error, maybe_db.error(), '\n');
+            Checks::exit_fail(VCPKG_LINE_INFO);
+        }
+
+        // Readers only use the database while versions/ is still the tree it was compiled from. It is renamed into
+        // place so that no reader maps a partial file.
+        const auto output_path = paths.compiled_versions_db();
+        const auto new_path = output_path + ".tmp";
+        fs.create_directories(output_path.parent_path(), VCPKG_LINE_INFO);
+        fs.write_contents(new_path, *db, VCPKG_LINE_INFO);
+        fs.rename(new_path, output_path, VCPKG_LINE_INFO);
+        vcpkg::printf("Compiled %s into %s\n", paths.builtin_registry_versions, output_path);
+        Checks::exit_success(VCPKG_LINE_INFO);
+    }
+
+    void CompileVersionsDbCommand::perform_and_exit(const VcpkgCmdArguments& args, const VcpkgPaths& paths) const
+    {
+        CompileVersionsDb::perform_and_exit(args, paths);
+    }
+}
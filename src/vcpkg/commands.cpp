@@ -11,6 +11,7 @@
 #include <vcpkg/commands.ci.h>
 #include <vcpkg/commands.ciclean.h>
 #include <vcpkg/commands.civerifyversions.h>
+#include <vcpkg/commands.compile-versions-db.h>
 #include <vcpkg/commands.contact.h>
 #include <vcpkg/commands.create.h>
 #include <vcpkg/commands.dependinfo.h>
@@ -89,6 +90,7 @@ namespace vcpkg::Commands
         static const Cache::CacheCommand cache{};
         static const CIClean::CICleanCommand ciclean{};
         static const CIVerifyVersions::CIVerifyVersionsCommand ci_verify_versions{};
+        static const CompileVersionsDb::CompileVersionsDbCommand compile_versions_db{};
         static const Create::CreateCommand create{};
         static const Edit::EditCommand edit{};
         static const Fetch::FetchCommand fetch{};
@@ -137,6 +139,7 @@ namespace vcpkg::Commands
             {"x-add-version", &add_version},
             {"x-ci-clean", &ciclean},
             {"x-ci-verify-versions", &ci_verify_versions},
+            {"x-compile-versions-db", &compile_versions_db},
             {"x-history", &porthistory},
             {"x-package-info", &info},
             {"x-regenerate", &regenerate},
@@ -105,6 +105,13 @@ namespace vcpkg::Commands::Edit
         &valid_arguments,
     };
 
+    static std::string quoted_build_dirs(const VcpkgPaths& paths, const std::string& port_name)
+    {
+        return Strings::join(" ", paths.build_dirs(port_name), [](const Path& dir) {
+            return Strings::format(R"###("%s")###", dir);
+        });
+    }
+
     static std::vector<std::string> create_editor_arguments(const VcpkgPaths& paths,
                                                             const ParsedArguments& options,
                                                             const std::vector<std::string>& ports)
@@ -118,7 +125,6 @@ namespace vcpkg::Commands::Edit
             return Util::fmap(ports, [&](const std::string& port_name) -> std::string {
                 const auto portpath = paths.builtin_ports_directory() / port_name;
                 const auto portfile = portpath / "portfile.cmake";
-                const auto buildtrees_current_dir = paths.build_dir(port_name);
                 const auto pattern = port_name + "_";
 
                 std::string package_paths;
@@ -130,15 +136,18 @@ namespace vcpkg::Commands::Edit
                     }
                 }
 
-                return Strings::format(
-                    R"###("%s" "%s" "%s"%s)###", portpath, portfile, buildtrees_current_dir, package_paths);
+                return Strings::format(R"###("%s" "%s" %s%s)###",
+                                       portpath,
+                                       portfile,
+                                       quoted_build_dirs(paths, port_name),
+                                       package_paths);
             });
         }
 
         if (Util::Sets::contains(options.switches, OPTION_BUILDTREES))
         {
             return Util::fmap(ports, [&](const std::string& port_name) -> std::string {
-                return Strings::format(R"###("%s")###", paths.build_dir(port_name));
+                return quoted_build_dirs(paths, port_name);
             });
         }
 
@@ -1,34 +1,30 @@
+#include <vcpkg/base/system.debug.h>
 #include <vcpkg/base/system.print.h>
 
 #include <vcpkg/commands.find.h>
 #include <vcpkg/configure-environment.h>
-#include <vcpkg/dependencies.h>
-#include <vcpkg/globalstate.h>
 #include <vcpkg/help.h>
-#include <vcpkg/paragraphs.h>
-#include <vcpkg/portfileprovider.h>
-#include <vcpkg/sourceparagraph.h>
+#include <vcpkg/portsearchindex.h>
 #include <vcpkg/vcpkgcmdarguments.h>
 #include <vcpkg/vcpkglib.h>
+#include <vcpkg/vcpkgpaths.h>
 #include <vcpkg/versions.h>
 
 using namespace vcpkg;
-using vcpkg::PortFileProvider::PathsPortFileProvider;
 
 namespace
 {
-    void do_print_json(std::vector<const vcpkg::SourceControlFile*> source_control_files)
+    void do_print_json(const std::vector<const IndexedPort*>& ports)
     {
         Json::Object obj;
-        for (const SourceControlFile* scf : source_control_files)
+        for (const IndexedPort* port : ports)
         {
-            auto& source_paragraph = scf->core_paragraph;
-            Json::Object& library_obj = obj.insert(source_paragraph->name, Json::Object());
-            library_obj.insert("package_name", Json::Value::string(source_paragraph->name));
-            library_obj.insert("version", Json::Value::string(source_paragraph->raw_version));
-            library_obj.insert("port_version", Json::Value::integer(source_paragraph->port_version));
+            Json::Object& library_obj = obj.insert(port->name, Json::Object());
+            library_obj.insert("package_name", Json::Value::string(port->name));
+            library_obj.insert("version", Json::Value::string(port->version));
+            library_obj.insert("port_version", Json::Value::integer(port->port_version));
             Json::Array& desc = library_obj.insert("description", Json::Array());
-            for (const auto& line : source_paragraph->description)
+            for (const auto& line : port->description)
             {
                 desc.push_back(Json::Value::string(line));
             }
@@ -37,51 +33,48 @@ namespace
         print2(Json::stringify(obj, Json::JsonStyle{}));
     }
     constexpr const int s_name_and_ver_columns = 41;
-    void do_print(const SourceParagraph& source_paragraph, bool full_desc)
+    void do_print(const IndexedPort& port, bool full_desc)
     {
-        auto full_version = Version(source_paragraph.raw_version, source_paragraph.port_version).to_string();
+        auto full_version = Version(port.version, port.port_version).to_string();
         if (full_desc)
         {
-            vcpkg::printf("%-20s %-16s %s\n",
-                          source_paragraph.name,
-                          full_version,
-                          Strings::join("\n    ", source_paragraph.description));
+            vcpkg::printf("%-20s %-16s %s\n", port.name, full_version, Strings::join("\n    ", port.description));
         }
         else
         {
             std::string description;
-            if (!source_paragraph.description.empty())
+            if (!port.description.empty())
             {
-                description = source_paragraph.description[0];
+                description = port.description[0];
             }
             static constexpr const int name_columns = 24;
-            size_t used_columns = std::max<size_t>(source_paragraph.name.size(), name_columns) + 1;
+            size_t used_columns = std::max<size_t>(port.name.size(), name_columns) + 1;
             int ver_size = std::max(0, s_name_and_ver_columns - static_cast<int>(used_columns));
             used_columns += std::max<size_t>(full_version.size(), ver_size) + 1;
             size_t description_size = used_columns < (119 - 40) ? 119 - used_columns : 40;
 
             vcpkg::printf("%-*s %-*s %s\n",
                           name_columns,
-                          source_paragraph.name,
+                          port.name,
                           ver_size,
                           full_version,
                           vcpkg::shorten_text(description, description_size));
         }
     }
 
-    void do_print(const std::string& name, const FeatureParagraph& feature_paragraph, bool full_desc)
+    void do_print(const std::string& name, const IndexedFeature& feature, bool full_desc)
     {
-        auto full_feature_name = Strings::concat(name, "[", feature_paragraph.name, "]");
+        auto full_feature_name = Strings::concat(name, "[", feature.name, "]");
         if (full_desc)
         {
-            vcpkg::printf("%-37s %s\n", full_feature_name, Strings::join("\n   ", feature_paragraph.description));
+            vcpkg::printf("%-37s %s\n", full_feature_name, Strings::join("\n   ", feature.description));
         }
         else
         {
             std::string description;
-            if (!feature_paragraph.description.empty())
+            if (!feature.description.empty())
             {
-                description = feature_paragraph.description[0];
+                description = feature.description[0];
             }
             size_t desc_length =
                 119 - std::min<size_t>(60, 1 + std::max<size_t>(s_name_and_ver_columns, full_feature_name.size()));
@@ -118,65 +111,51 @@ namespace vcpkg::Commands
                                     Optional<StringView> filter,
                                     View<std::string> overlay_ports)
     {
-        PathsPortFileProvider provider(paths, overlay_ports);
-        auto source_paragraphs =
-            Util::fmap(provider.load_all_control_files(),
-                       [](auto&& port) -> const SourceControlFile* { return port->source_control_file.get(); });
+        auto& fs = paths.get_filesystem();
+        // without a buildtrees directory, the index is built from scratch and only kept in memory
+        const auto maybe_index_path = port_search_index_path(paths);
+        const auto index_path = maybe_index_path.get();
+        auto index = index_path ? PortSearchIndex::load(fs, *index_path) : PortSearchIndex{};
+        if (index.refresh(fs, get_searchable_port_directories(paths, overlay_ports)) && index_path)
+        {
+            std::error_code ec;
+            index.save(fs, *index_path, ec);
+            if (ec)
+            {
+                Debug::print("Failed to save the port search index to ", *index_path, ": ", ec.message(), '\n');
+            }
+        }
 
         if (auto* filter_str = filter.get())
         {
-            const auto contained_in = [filter_str](StringView haystack) {
-                return Strings::case_insensitive_ascii_contains(haystack, *filter_str);
-            };
-            for (const auto& source_control_file : source_paragraphs)
+            for (auto&& result : index.search(*filter_str))
             {
-                auto&& sp = *source_control_file->core_paragraph;
-
-                bool found_match = contained_in(sp.name);
-                if (!found_match)
-                {
-                    found_match = std::any_of(sp.description.begin(), sp.description.end(), contained_in);
-                }
-
-                if (found_match)
+                if (result.match != SearchMatch::Feature)
                 {
-                    do_print(sp, full_description);
+                    do_print(*result.port, full_description);
                 }
 
-                for (auto&& feature_paragraph : source_control_file->feature_paragraphs)
+                for (auto feature : result.features)
                 {
-                    bool found_match_for_feature = found_match;
-                    if (!found_match_for_feature)
-                    {
-                        found_match_for_feature = contained_in(feature_paragraph->name);
-                    }
-                    if (!found_match_for_feature)
-                    {
-                        found_match_for_feature = std::any_of(
-                            feature_paragraph->description.begin(), feature_paragraph->description.end(), contained_in);
-                    }
-
-                    if (found_match_for_feature)
-                    {
-                        do_print(sp.name, *feature_paragraph, full_description);
-                    }
+                    do_print(result.port->name, *feature, full_description);
                 }
             }
         }
         else
         {
+            const auto ports = index.ports();
             if (enable_json)
             {
-                do_print_json(source_paragraphs);
+                do_print_json(ports);
             }
             else
             {
-                for (const auto& source_control_file : source_paragraphs)
+                for (auto port : ports)
                 {
-                    do_print(*source_control_file->core_paragraph, full_description);
-                    for (auto&& feature_paragraph : source_control_file->feature_paragraphs)
+                    do_print(*port, full_description);
+                    for (auto&& feature : port->features)
                     {
-                        do_print(source_control_file->core_paragraph->name, *feature_paragraph, full_description);
+                        do_print(port->name, feature, full_description);
                     }
                 }
             }
@@ -1,4 +1,5 @@
 #include <vcpkg/base/json.h>
+#include <vcpkg/base/system.debug.h>
 #include <vcpkg/base/system.print.h>
 #include <vcpkg/base/system.process.h>
 #include <vcpkg/base/util.h>
@@ -16,17 +17,22 @@ namespace vcpkg::Commands::PortHistory
 {
     namespace
     {
-        struct HistoryVersion
-        {
-            std::string port_name;
-            std::string git_tree;
-            std::string commit_id;
-            std::string commit_date;
-            std::string version_string;
-            std::string version;
-            int port_version;
-            VersionScheme scheme;
-        };
+        static constexpr StringLiteral CACHE_HEAD = "head";
+        static constexpr StringLiteral CACHE_VERSIONS = "versions";
+        static constexpr StringLiteral CACHE_COMMIT = "commit";
+        static constexpr StringLiteral CACHE_DATE = "date";
+        static constexpr StringLiteral CACHE_GIT_TREE = "git-tree";
+
+        // nullopt if `port_name` could not be a file name in the cache directory
+        Optional<Path> port_history_cache_path(const VcpkgPaths& paths, const std::string& port_name)
+        {
+            if (!Json::IdentifierDeserializer::is_ident(port_name))
+            {
+                return nullopt;
+            }
+
+            return paths.root / ".git" / "vcpkg-port-history" / (port_name + ".json");
+        }
 
         ExitCodeAndOutput run_git_command(const VcpkgPaths& paths, const Command& cmd)
         {
@@ -42,102 +48,423 @@ namespace vcpkg::Commands::PortHistory
                                                               const std::string& port_name,
                                                               bool is_manifest)
         {
-            auto res = Paragraphs::try_load_port_text(text, Strings::concat(commit_id, ":", port_name), is_manifest);
-            if (const auto& maybe_scf = res.get())
+            auto res =
+                Paragraphs::try_load_port_identity_text(text, Strings::concat(commit_id, ":", port_name), is_manifest);
+            if (const auto& maybe_identity = res.get())
             {
-                if (const auto& scf = maybe_scf->get())
+                if (const auto& identity = maybe_identity->get())
                 {
-                    auto version = scf->core_paragraph->raw_version;
-                    auto port_version = scf->core_paragraph->port_version;
-                    auto scheme = scf->core_paragraph->version_scheme;
-                    return HistoryVersion{
-                        port_name,
-                        git_tree,
-                        commit_id,
-                        commit_date,
-                        Strings::concat(version, "#", port_version),
-                        version,
-                        port_version,
-                        scheme,
-                    };
+                    auto version = identity->schemed_version.version.text();
+                    auto port_version = identity->schemed_version.version.port_version();
+                    auto scheme = identity->schemed_version.scheme;
+                    return make_history_version(
+                        port_name, git_tree, commit_id, commit_date, version, port_version, scheme);
                 }
             }
 
             return nullopt;
         }
 
-        vcpkg::Optional<HistoryVersion> get_version_from_commit(const VcpkgPaths& paths,
-                                                                const std::string& commit_id,
-                                                                const std::string& commit_date,
-                                                                const std::string& port_name)
+        static constexpr StringLiteral NULL_OBJECT_ID = "0000000000000000000000000000000000000000";
+
+        // Resolves ports/<port_name> in each of `commits` with one batched rev-parse. If any of them does not
+        // resolve the whole batch fails, so each one is then resolved on its own.
+        void resolve_missing_trees(const VcpkgPaths& paths,
+                                   const std::string& port_name,
+                                   const std::vector<CommitTree*>& commits)
         {
-            auto rev_parse_cmd = Command("rev-parse").string_arg(Strings::concat(commit_id, ":ports/", port_name));
-            auto rev_parse_output = run_git_command(paths, rev_parse_cmd);
-            if (rev_parse_output.exit_code == 0)
+            if (commits.empty())
             {
-                // Remove newline character
-                const auto git_tree = Strings::trim(std::move(rev_parse_output.output));
+                return;
+            }
+
+            const auto make_spec = [&port_name](const CommitTree& commit) {
+                return Strings::concat(commit.commit_id, ":ports/", port_name);
+            };
+
+            Command rev_parse_cmd("rev-parse");
+            for (auto commit : commits)
+            {
+                rev_parse_cmd.string_arg(make_spec(*commit));
+            }
 
-                // Do we have a manifest file?
-                auto manifest_cmd = Command("show").string_arg(Strings::concat(git_tree, ":vcpkg.json"));
-                auto manifest_output = run_git_command(paths, manifest_cmd);
-                if (manifest_output.exit_code == 0)
+            auto rev_parse_output = run_git_command(paths, rev_parse_cmd);
+            auto trees = Strings::split(rev_parse_output.output, '\n');
+            if (rev_parse_output.exit_code == 0 && trees.size() == commits.size())
+            {
+                for (size_t i = 0; i < trees.size(); ++i)
                 {
-                    return get_version_from_text(
-                        manifest_output.output, git_tree, commit_id, commit_date, port_name, true);
+                    commits[i]->git_tree = std::move(trees[i]);
                 }
 
-                auto cmd = Command("show").string_arg(Strings::concat(git_tree, ":CONTROL"));
-                auto control_output = run_git_command(paths, cmd);
+                return;
+            }
 
-                if (control_output.exit_code == 0)
+            for (auto commit : commits)
+            {
+                auto single_output = run_git_command(paths, Command("rev-parse").string_arg(make_spec(*commit)));
+                if (single_output.exit_code == 0)
                 {
-                    return get_version_from_text(
-                        control_output.output, git_tree, commit_id, commit_date, port_name, false);
+                    commit->git_tree = Strings::trim(std::move(single_output.output));
+                }
+                else
+                {
+                    Debug::print("Could not resolve ", make_spec(*commit), ": ", single_output.output, '\n');
                 }
             }
-
-            return nullopt;
         }
 
-        std::vector<HistoryVersion> read_versions_from_log(const VcpkgPaths& paths, const std::string& port_name)
+        // Walks the history of ports/<port_name> reachable from `range` in a single git invocation. The `-t --raw`
+        // diff output records the object id of the port's tree for each commit, so no per-commit `rev-parse` is
+        // needed.
+        std::vector<CommitTree> read_commit_trees_from_log(const VcpkgPaths& paths,
+                                                           const std::string& port_name,
+                                                           StringView range)
         {
-            // log --format="%H %cd" --date=short --left-only -- ports/{port_name}/.
+            // log --format="@%H %cd" --date=short --left-only -t --raw --no-abbrev --no-renames {range}
+            //     -- ports/{port_name}/.
             Command builder;
             builder.string_arg("log");
-            builder.string_arg("--format=%H %cd");
+            builder.string_arg("--format=@%H %cd");
             builder.string_arg("--date=short");
             builder.string_arg("--left-only");
+            builder.string_arg("-t");
+            builder.string_arg("--raw");
+            builder.string_arg("--no-abbrev");
+            builder.string_arg("--no-renames");
+            builder.string_arg(range);
             builder.string_arg("--"); // Begin pathspec
             builder.string_arg(Strings::format("ports/%s/.", port_name));
             const auto output = run_git_command(paths, builder);
+            if (output.exit_code != 0)
+            {
+                Checks::exit_with_message(VCPKG_LINE_INFO, "Failed to read git history:\n%s", output.output);
+            }
 
-            auto commits = Util::fmap(
-                Strings::split(output.output, '\n'), [](const std::string& line) -> auto {
-                    auto parts = Strings::split(line, ' ');
-                    return std::make_pair(parts[0], parts[1]);
-                });
+            auto ret = parse_port_log(output.output, port_name);
 
-            std::vector<HistoryVersion> ret;
-            std::string last_version;
-            for (auto&& commit_date_pair : commits)
+            // Merge commits do not produce raw diff output without -m; ask for their trees with rev-parse. Commits
+            // that deleted the port have no tree to ask for.
+            std::vector<CommitTree*> missing;
+            for (auto&& commit : ret)
+            {
+                if (commit.git_tree.empty() && !commit.deleted)
+                {
+                    missing.push_back(&commit);
+                }
+            }
+
+            resolve_missing_trees(paths, port_name, missing);
+            return ret;
+        }
+
+        // Loads the port manifest for every distinct tree id, fanning the `git show` calls out in parallel.
+        std::map<std::string, Optional<HistoryVersion>> load_versions_for_trees(const VcpkgPaths& paths,
+                                                                                const std::string& port_name,
+                                                                                const std::vector<CommitTree>& commits)
+        {
+            std::map<std::string, const CommitTree*> first_commit_for_tree;
+            for (auto&& commit : commits)
+            {
+                if (!commit.git_tree.empty())
+                {
+                    first_commit_for_tree.emplace(commit.git_tree, &commit);
+                }
+            }
+
+            std::map<std::string, Optional<HistoryVersion>> ret;
+            if (first_commit_for_tree.empty())
+            {
+                return ret;
+            }
+
+            const auto make_show_cmd = [&paths](const std::string& git_tree, StringLiteral file) {
+                return paths.git_cmd_builder(paths.root / ".git", paths.root)
+                    .string_arg("show")
+                    .string_arg(Strings::concat(git_tree, ":", file));
+            };
+
+            std::vector<const CommitTree*> pending;
+            std::vector<Command> manifest_cmds;
+            for (auto&& entry : first_commit_for_tree)
+            {
+                pending.push_back(entry.second);
+                manifest_cmds.push_back(make_show_cmd(entry.first, "vcpkg.json"));
+            }
+
+            std::vector<const CommitTree*> control_pending;
+            std::vector<Command> control_cmds;
+            auto manifest_outputs = cmd_execute_and_capture_output_parallel(manifest_cmds);
+            for (size_t i = 0; i < pending.size(); ++i)
+            {
+                const auto& commit = *pending[i];
+                if (manifest_outputs[i].exit_code == 0)
+                {
+                    ret.emplace(commit.git_tree,
+                                get_version_from_text(manifest_outputs[i].output,
+                                                      commit.git_tree,
+                                                      commit.commit_id,
+                                                      commit.commit_date,
+                                                      port_name,
+                                                      true));
+                }
+                else
+                {
+                    control_pending.push_back(&commit);
+                    control_cmds.push_back(make_show_cmd(commit.git_tree, "CONTROL"));
+                }
+            }
+
+            auto control_outputs = cmd_execute_and_capture_output_parallel(control_cmds);
+            for (size_t i = 0; i < control_pending.size(); ++i)
+            {
+                const auto& commit = *control_pending[i];
+                if (control_outputs[i].exit_code == 0)
+                {
+                    ret.emplace(commit.git_tree,
+                                get_version_from_text(control_outputs[i].output,
+                                                      commit.git_tree,
+                                                      commit.commit_id,
+                                                      commit.commit_date,
+                                                      port_name,
+                                                      false));
+                }
+                else
+                {
+                    ret.emplace(commit.git_tree, nullopt);
+                }
+            }
+
+            return ret;
+        }
+
+        // Keeps the latest commit of each run of identical version strings; `versions` is ordered newest first.
+        void append_deduplicated(std::vector<HistoryVersion>& out, std::vector<HistoryVersion>&& versions)
+        {
+            for (auto&& version : versions)
             {
-                auto maybe_version =
-                    get_version_from_commit(paths, commit_date_pair.first, commit_date_pair.second, port_name);
-                if (maybe_version.has_value())
+                if (out.empty() || out.back().version_string != version.version_string)
                 {
-                    const auto version = maybe_version.value_or_exit(VCPKG_LINE_INFO);
+                    out.push_back(std::move(version));
+                }
+            }
+        }
 
-                    // Keep latest port with the current version string
-                    if (last_version != version.version_string)
+        std::vector<HistoryVersion> read_versions_from_log(const VcpkgPaths& paths,
+                                                           const std::string& port_name,
+                                                           StringView range)
+        {
+            const auto commits = read_commit_trees_from_log(paths, port_name, range);
+            const auto versions_by_tree = load_versions_for_trees(paths, port_name, commits);
+
+            std::vector<HistoryVersion> ret;
+            for (auto&& commit : commits)
+            {
+                if (commit.git_tree.empty()) continue;
+                const auto& maybe_version = versions_by_tree.at(commit.git_tree);
+                if (auto version = maybe_version.get())
+                {
+                    if (ret.empty() || ret.back().version_string != version->version_string)
                     {
-                        last_version = version.version_string;
-                        ret.emplace_back(version);
+                        ret.push_back(*version);
+                        ret.back().commit_id = commit.commit_id;
+                        ret.back().commit_date = commit.commit_date;
                     }
                 }
             }
             return ret;
         }
+
+        std::vector<HistoryVersion> read_versions_with_cache(const VcpkgPaths& paths, const std::string& port_name)
+        {
+            auto head_output = run_git_command(paths, Command("rev-parse").string_arg("HEAD"));
+            if (head_output.exit_code != 0)
+            {
+                Checks::exit_with_message(VCPKG_LINE_INFO, "Failed to resolve HEAD:\n%s", head_output.output);
+            }
+
+            const auto head = Strings::trim(std::move(head_output.output));
+            const auto maybe_cache_path = port_history_cache_path(paths, port_name);
+            const auto cache_path = maybe_cache_path.get();
+            auto& fs = paths.get_filesystem();
+            const auto store = [&](const std::vector<HistoryVersion>& versions) {
+                // the cache is an optimization only
+                if (cache_path)
+                {
+                    store_port_history_cache(fs, *cache_path, PortHistoryCache{head, versions});
+                }
+            };
+
+            Optional<PortHistoryCache> maybe_cache;
+            if (cache_path)
+            {
+                maybe_cache = try_load_port_history_cache(fs, *cache_path, port_name);
+            }
+
+            if (auto cache = maybe_cache.get())
+            {
+                if (cache->head == head)
+                {
+                    return std::move(cache->versions);
+                }
+
+                auto is_ancestor_cmd =
+                    Command("merge-base").string_arg("--is-ancestor").string_arg(cache->head).string_arg(head);
+                if (run_git_command(paths, is_ancestor_cmd).exit_code == 0)
+                {
+                    std::vector<HistoryVersion> versions;
+                    append_deduplicated(
+                        versions, read_versions_from_log(paths, port_name, Strings::concat(cache->head, "..", head)));
+                    append_deduplicated(versions, std::move(cache->versions));
+                    store(versions);
+                    return versions;
+                }
+            }
+
+            auto versions = read_versions_from_log(paths, port_name, head);
+            store(versions);
+            return versions;
+        }
+    }
+
+    HistoryVersion make_history_version(const std::string& port_name,
+                                        const std::string& git_tree,
+                                        const std::string& commit_id,
+                                        const std::string& commit_date,
+                                        const std::string& version,
+                                        int port_version,
+                                        VersionScheme scheme)
+    {
+        return HistoryVersion{
+            port_name,
+            git_tree,
+            commit_id,
+            commit_date,
+            Strings::concat(version, "#", port_version),
+            version,
+            port_version,
+            scheme,
+        };
+    }
+
+    Optional<PortHistoryCache> try_load_port_history_cache(const Filesystem& fs,
+                                                           const Path& cache_path,
+                                                           const std::string& port_name)
+    {
+        std::error_code ec;
+        auto maybe_json = Json::parse_file(fs, cache_path, ec);
+        if (ec) return nullopt;
+        auto json = maybe_json.get();
+        if (!json || !json->first.is_object()) return nullopt;
+
+        const auto& obj = json->first.object();
+        auto head = obj.get(CACHE_HEAD);
+        auto versions = obj.get(CACHE_VERSIONS);
+        if (!head || !head->is_string() || !versions || !versions->is_array()) return nullopt;
+
+        PortHistoryCache ret;
+        ret.head = head->string().to_string();
+        Json::Reader r;
+        for (auto&& entry : versions->array())
+        {
+            if (!entry.is_object()) return nullopt;
+            const auto& entry_obj = entry.object();
+            auto commit = entry_obj.get(CACHE_COMMIT);
+            auto date = entry_obj.get(CACHE_DATE);
+            auto git_tree = entry_obj.get(CACHE_GIT_TREE);
+            if (!commit || !commit->is_string() || !date || !date->is_string() || !git_tree || !git_tree->is_string())
+            {
+                return nullopt;
+            }
+
+            auto schemed_version = visit_required_schemed_deserializer("port history", r, entry_obj);
+            if (!r.errors().empty()) return nullopt;
+            ret.versions.push_back(make_history_version(port_name,
+                                                        git_tree->string().to_string(),
+                                                        commit->string().to_string(),
+                                                        date->string().to_string(),
+                                                        schemed_version.version.text(),
+                                                        schemed_version.version.port_version(),
+                                                        schemed_version.scheme));
+        }
+
+        return ret;
+    }
+
+    void store_port_history_cache(Filesystem& fs, const Path& cache_path, const PortHistoryCache& cache)
+    {
+        Json::Array versions_json;
+        for (auto&& version : cache.versions)
+        {
+            Json::Object object;
+            object.insert(CACHE_COMMIT, Json::Value::string(version.commit_id));
+            object.insert(CACHE_DATE, Json::Value::string(version.commit_date));
+            object.insert(CACHE_GIT_TREE, Json::Value::string(version.git_tree));
+            serialize_schemed_version(object, version.scheme, version.version, version.port_version, true);
+            versions_json.push_back(std::move(object));
+        }
+
+        Json::Object root;
+        root.insert(CACHE_HEAD, Json::Value::string(cache.head));
+        root.insert(CACHE_VERSIONS, std::move(versions_json));
+
+        // The cache is an optimization only; failing to write it is not an error.
+        std::error_code ec;
+        fs.write_contents_and_dirs(cache_path, Json::stringify(root, Json::JsonStyle::with_spaces(2)), ec);
+        if (ec)
+        {
+            Debug::print("Failed to write port history cache ", cache_path, ": ", ec.message(), '\n');
+        }
+    }
+
+    std::string format_port_history(const std::vector<HistoryVersion>& versions)
+    {
+        std::string ret = "             version          date    vcpkg commit\n";
+        for (auto&& version : versions)
+        {
+            Strings::append(
+                ret,
+                Strings::format("%20.20s    %s    %s\n", version.version_string, version.commit_date, version.commit_id));
+        }
+
+        return ret;
+    }
+
+    std::vector<CommitTree> parse_port_log(StringView log_output, StringView port_name)
+    {
+        const auto port_path = Strings::concat("ports/", port_name);
+        std::vector<CommitTree> ret;
+        for (auto&& line : Strings::split(log_output, '\n'))
+        {
+            if (line[0] == '@')
+            {
+                auto parts = Strings::split(StringView{line}.substr(1), ' ');
+                if (parts.size() == 2)
+                {
+                    ret.push_back(CommitTree{std::move(parts[0]), std::move(parts[1]), {}, false});
+                }
+            }
+            else if (line[0] == ':' && !ret.empty())
+            {
+                // :<old mode> <new mode> <old oid> <new oid> <status>\t<path>
+                const auto tab = line.find('\t');
+                if (tab == std::string::npos || StringView{line}.substr(tab + 1) != port_path) continue;
+                const auto fields = Strings::split(StringView{line}.substr(1, tab - 1), ' ');
+                if (fields.size() == 5)
+                {
+                    if (fields[3] == NULL_OBJECT_ID)
+                    {
+                        ret.back().deleted = true;
+                    }
+                    else
+                    {
+                        ret.back().git_tree = fields[3];
+                    }
+                }
+            }
+        }
+
+        return ret;
     }
 
     static constexpr StringLiteral OPTION_OUTPUT_FILE = "output";
@@ -168,7 +495,7 @@ namespace vcpkg::Commands::PortHistory
         auto maybe_output_file = maybe_lookup(parsed_args.settings, OPTION_OUTPUT_FILE);
 
         std::string port_name = args.command_arguments.at(0);
-        std::vector<HistoryVersion> versions = read_versions_from_log(paths, port_name);
+        std::vector<HistoryVersion> versions = read_versions_with_cache(paths, port_name);
 
         if (args.output_json())
         {
@@ -205,11 +532,7 @@ namespace vcpkg::Commands::PortHistory
                 vcpkg::printf(Color::warning, "Warning: Option `--$s` requires `--x-json` switch.", OPTION_OUTPUT_FILE);
             }
 
-            print2("             version          date    vcpkg commit\n");
-            for (auto&& version : versions)
-            {
-                vcpkg::printf("%20.20s    %s    %s\n", version.version_string, version.commit_date, version.commit_id);
-            }
+            print2(format_port_history(versions));
         }
         Checks::exit_success(VCPKG_LINE_INFO);
     }
@@ -6,6 +6,7 @@
 #include <vcpkg/commands.portsdiff.h>
 #include <vcpkg/help.h>
 #include <vcpkg/paragraphs.h>
+#include <vcpkg/sourceparagraph.h>
 #include <vcpkg/tools.h>
 #include <vcpkg/vcpkgcmdarguments.h>
 #include <vcpkg/vcpkgpaths.h>
@@ -77,37 +78,87 @@ namespace vcpkg::Commands::PortsDiff
         }
     }
 
-    static std::map<std::string, Version> read_ports_from_commit(const VcpkgPaths& paths,
-                                                                 const std::string& git_commit_id)
+    // Returns the object id of each port directory in the ports tree of `git_commit_id`, keyed by directory name.
+    static std::map<std::string, std::string> read_port_trees_from_commit(const VcpkgPaths& paths,
+                                                                          const std::string& git_commit_id)
     {
-        std::error_code ec;
-        auto& fs = paths.get_filesystem();
-        const auto dot_git_dir = paths.root / ".git";
         const auto ports_dir_name = paths.builtin_ports_directory().filename();
-        const auto temp_checkout_path = paths.root / Strings::format("%s-%s", ports_dir_name, git_commit_id);
-        fs.create_directory(temp_checkout_path, ec);
-        const auto checkout_this_dir =
-            Strings::format(R"(.\%s)", ports_dir_name); // Must be relative to the root of the repository
-
-        auto cmd = paths.git_cmd_builder(dot_git_dir, temp_checkout_path)
-                       .string_arg("checkout")
-                       .string_arg(git_commit_id)
-                       .string_arg("-f")
-                       .string_arg("-q")
-                       .string_arg("--")
-                       .string_arg(checkout_this_dir)
-                       .string_arg(".vcpkg-root");
-        cmd_execute_and_capture_output(cmd, get_clean_environment());
-        cmd_execute_and_capture_output(paths.git_cmd_builder(dot_git_dir, temp_checkout_path).string_arg("reset"),
-                                       get_clean_environment());
-        const auto ports_at_commit = Paragraphs::load_overlay_ports(fs, temp_checkout_path / ports_dir_name);
+        auto cmd = paths.git_cmd_builder(paths.root / ".git", paths.root)
+                       .string_arg("ls-tree")
+                       .string_arg(Strings::concat(git_commit_id, ":", ports_dir_name));
+        const auto output = cmd_execute_and_capture_output(cmd, get_clean_environment());
+        Checks::check_exit(VCPKG_LINE_INFO,
+                           output.exit_code == 0,
+                           "Failed to list the ports tree at %s:\n%s",
+                           git_commit_id,
+                           output.output);
+
+        std::map<std::string, std::string> port_trees;
+        for (auto&& line : Strings::split(output.output, '\n'))
+        {
+            // <mode> SP <type> SP <object> TAB <file>
+            const auto tab = line.find('\t');
+            if (tab == std::string::npos) continue;
+            const auto fields = Strings::split(StringView{line}.substr(0, tab), ' ');
+            if (fields.size() != 3 || fields[1] != "tree") continue;
+            port_trees.emplace(line.substr(tab + 1), fields[2]);
+        }
+
+        return port_trees;
+    }
+
+    // Loads the name and version of the port stored in each of `git_trees`, reading only the manifest or CONTROL
+    // file of each tree.
+    static std::map<std::string, Version> read_ports_from_trees(const VcpkgPaths& paths,
+                                                                const std::vector<std::string>& git_trees)
+    {
+        const auto make_show_cmd = [&paths](const std::string& git_tree, StringLiteral file) {
+            return paths.git_cmd_builder(paths.root / ".git", paths.root)
+                .string_arg("show")
+                .string_arg(Strings::concat(git_tree, ":", file));
+        };
+
         std::map<std::string, Version> names_and_versions;
-        for (auto&& port : ports_at_commit)
+        const auto add_port = [&](const std::string& text, const std::string& git_tree, bool is_manifest) {
+            auto maybe_identity = Paragraphs::try_load_port_identity_text(text, git_tree, is_manifest);
+            if (auto identity = maybe_identity.get())
+            {
+                names_and_versions.emplace((*identity)->name, (*identity)->to_version());
+            }
+            else
+            {
+                print_error_message(maybe_identity.error());
+            }
+        };
+
+        const auto manifest_cmds =
+            Util::fmap(git_trees, [&](const std::string& git_tree) { return make_show_cmd(git_tree, "vcpkg.json"); });
+        const auto manifest_outputs = cmd_execute_and_capture_output_parallel(manifest_cmds, get_clean_environment());
+
+        std::vector<const std::string*> control_trees;
+        std::vector<Command> control_cmds;
+        for (size_t i = 0; i < git_trees.size(); ++i)
         {
-            const auto& core_pgh = *port.source_control_file->core_paragraph;
-            names_and_versions.emplace(core_pgh.name, Version(core_pgh.raw_version, core_pgh.port_version));
+            if (manifest_outputs[i].exit_code == 0)
+            {
+                add_port(manifest_outputs[i].output, git_trees[i], true);
+            }
+            else
+            {
+                control_trees.push_back(&git_trees[i]);
+                control_cmds.push_back(make_show_cmd(git_trees[i], "CONTROL"));
+            }
         }
-        fs.remove_all(temp_checkout_path, VCPKG_LINE_INFO);
+
+        const auto control_outputs = cmd_execute_and_capture_output_parallel(control_cmds, get_clean_environment());
+        for (size_t i = 0; i < control_trees.size(); ++i)
+        {
+            if (control_outputs[i].exit_code == 0)
+            {
+                add_port(control_outputs[i].output, *control_trees[i], false);
+            }
+        }
+
         return names_and_versions;
     }
 
@@ -144,10 +195,34 @@ namespace vcpkg::Commands::PortsDiff
         check_commit_exists(paths, git_commit_id_for_current_snapshot);
         check_commit_exists(paths, git_commit_id_for_previous_snapshot);
 
+        // Ports whose directory tree object is identical in both commits cannot have changed; only the manifests of
+        // the remaining ports are read.
+        const auto current_port_trees = read_port_trees_from_commit(paths, git_commit_id_for_current_snapshot);
+        const auto previous_port_trees = read_port_trees_from_commit(paths, git_commit_id_for_previous_snapshot);
+        std::vector<std::string> current_changed_trees;
+        for (auto&& port_tree : current_port_trees)
+        {
+            auto it = previous_port_trees.find(port_tree.first);
+            if (it == previous_port_trees.end() || it->second != port_tree.second)
+            {
+                current_changed_trees.push_back(port_tree.second);
+            }
+        }
+
+        std::vector<std::string> previous_changed_trees;
+        for (auto&& port_tree : previous_port_trees)
+        {
+            auto it = current_port_trees.find(port_tree.first);
+            if (it == current_port_trees.end() || it->second != port_tree.second)
+            {
+                previous_changed_trees.push_back(port_tree.second);
+            }
+        }
+
         const std::map<std::string, Version> current_names_and_versions =
-            read_ports_from_commit(paths, git_commit_id_for_current_snapshot);
+            read_ports_from_trees(paths, current_changed_trees);
         const std::map<std::string, Version> previous_names_and_versions =
-            read_ports_from_commit(paths, git_commit_id_for_previous_snapshot);
+            read_ports_from_trees(paths, previous_changed_trees);
 
         // Already sorted, so set_difference can work on std::vector too
         const std::vector<std::string> current_ports = Util::extract_keys(current_names_and_versions);
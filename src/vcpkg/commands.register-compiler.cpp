@@ -1,6 +1,7 @@
 #include <vcpkg/base/system.debug.h>
 #include <vcpkg/base/system.print.h>
 #include <vcpkg/base/system.process.h>
+#include <vcpkg/base/util.h>
 
 #include <vcpkg/commands.register-compiler.h>
 #include <vcpkg/compiler-info.h>
@@ -174,17 +175,14 @@ namespace vcpkg::Commands::RegisterCompiler
         auto compiler_info = details::parse_arguments(args);
         details::validate_compiler_info(compiler_info, fs);
 
-        auto compiler_info_filename = Strings::format("%s-%s.json", compiler_info.name, compiler_info.version);
-        auto compiler_info_path = paths.vcpkg_bin2sth_compiler_config_dir / compiler_info_filename;
-
-        if (fs.exists(compiler_info_path, VCPKG_LINE_INFO))
-            Checks::exit_with_message(VCPKG_LINE_INFO, Strings::format("Already exists: %s\n", compiler_info_path));
-
-        fs.create_directories(paths.vcpkg_bin2sth_compiler_config_dir, VCPKG_LINE_INFO);
-        CompilerInfo::dump(fs, compiler_info_path, compiler_info);
+        // compilers registered without a fingerprint, including those only in the legacy config directory, are
+        // upgraded in place
+        auto const nickname = compiler_info.nickname();
+        if (!CompilerIndex::add(fs, paths.vcpkg_bin2sth_compiler_index, std::move(compiler_info)))
+            Checks::exit_with_message(VCPKG_LINE_INFO, Strings::format("Already registered: %s\n", nickname));
 
         print2(Strings::format(
-            "Succeed to register compiler '%s' at path '%s'\n", compiler_info.nickname(), compiler_info_path));
+            "Succeed to register compiler '%s' in '%s'\n", nickname, paths.vcpkg_bin2sth_compiler_index));
         Checks::exit_success(VCPKG_LINE_INFO);
     }
 
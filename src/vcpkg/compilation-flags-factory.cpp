@@ -47,15 +47,15 @@ namespace vcpkg::bin2sth
 
     CompilationFlags CompilationFlagsFactory::interpret(const CompileTriplet& config) const
     {
-        auto const compiler_info_itr = m_compilers.find(config.compiler_tag);
+        auto const compiler_info_itr = m_compilers.find(config.compiler_tag());
 
         Checks::check_exit(VCPKG_LINE_INFO,
                            compiler_info_itr != m_compilers.end(),
-                           std::string("Invalid compiler nickname: ").append(config.compiler_tag));
+                           std::string("Invalid compiler nickname: ").append(config.compiler_tag()));
 
         auto const& compiler_info = compiler_info_itr->second;
-        auto optimization_flags = details::parse_optimization_flags(compiler_info, config.optimization_tag);
-        auto obfuscation_flags = details::parse_obfuscation_flags(compiler_info, config.obfuscation_tag);
+        auto optimization_flags = details::parse_optimization_flags(compiler_info, config.optimization_tag());
+        auto obfuscation_flags = details::parse_obfuscation_flags(compiler_info, config.obfuscation_tag());
 
         return CompilationFlags{compiler_info, std::move(optimization_flags), std::move(obfuscation_flags)};
     }
@@ -1,6 +1,13 @@
+#include <vcpkg/base/lockguarded.h>
+#include <vcpkg/base/strings.h>
+
 #include <vcpkg/compile-triplet.h>
 #include <vcpkg/vcpkgcmdarguments.h>
 
+#include <map>
+#include <tuple>
+#include <utility>
+
 namespace vcpkg::bin2sth
 {
     static std::string deref_or(std::unique_ptr<std::string> const& p, StringLiteral default_)
@@ -8,14 +15,83 @@ namespace vcpkg::bin2sth
         return p && p->size() ? *p : default_;
     }
 
+    CompileTripletInstance::CompileTripletInstance(std::string&& compiler_tag,
+                                                   std::string&& optimization_tag,
+                                                   std::string&& obfuscation_tag,
+                                                   Triplet triplet)
+        : compiler_tag(std::move(compiler_tag))
+        , optimization_tag(std::move(optimization_tag))
+        , obfuscation_tag(std::move(obfuscation_tag))
+        , triplet(triplet)
+        , canonical_name(Strings::format("%s_%s_%s", this->compiler_tag, this->optimization_tag, this->obfuscation_tag))
+        , hash([this] {
+            auto const fn_str_hash = std::hash<std::string>();
+            size_t hash = 17;
+            hash = hash * 31 + fn_str_hash(this->compiler_tag);
+            hash = hash * 31 + fn_str_hash(this->optimization_tag);
+            hash = hash * 31 + fn_str_hash(this->obfuscation_tag);
+            hash = hash * 31 + std::hash<Triplet>()(this->triplet);
+            return hash;
+        }())
+    {
+    }
+
+    namespace
+    {
+        using TagsKey = std::tuple<std::string, std::string, std::string, Triplet>;
+
+        struct CompileTripletRegistry
+        {
+            std::map<TagsKey, std::unique_ptr<CompileTripletInstance>> by_tags;
+            // every instance is also reachable by its canonical name, for from_canonical_name()
+            std::map<std::pair<StringView, Triplet>, const CompileTripletInstance*> by_name;
+        };
+
+        LockGuarded<CompileTripletRegistry>& registry_instance()
+        {
+            static LockGuarded<CompileTripletRegistry> registry;
+            return registry;
+        }
+
+        // whether the tags can be recovered from the canonical name by splitting it
+        bool is_unambiguous(const CompileTripletInstance& instance)
+        {
+            return !Strings::contains(instance.compiler_tag, '_') &&
+                   !Strings::contains(instance.optimization_tag, '_') &&
+                   !Strings::contains(instance.obfuscation_tag, '_');
+        }
+
+        const CompileTripletInstance* intern(std::string&& compiler_tag,
+                                             std::string&& optimization_tag,
+                                             std::string&& obfuscation_tag,
+                                             Triplet triplet)
+        {
+            LockGuardPtr<CompileTripletRegistry> registry(registry_instance());
+            TagsKey key{std::move(compiler_tag), std::move(optimization_tag), std::move(obfuscation_tag), triplet};
+            auto it = registry->by_tags.find(key);
+            if (it == registry->by_tags.end())
+            {
+                auto instance = std::make_unique<CompileTripletInstance>(std::string(std::get<0>(key)),
+                                                                         std::string(std::get<1>(key)),
+                                                                         std::string(std::get<2>(key)),
+                                                                         triplet);
+                if (is_unambiguous(*instance))
+                {
+                    registry->by_name.emplace(std::make_pair(StringView(instance->canonical_name), triplet),
+                                              instance.get());
+                }
+                it = registry->by_tags.emplace(std::move(key), std::move(instance)).first;
+            }
+
+            return it->second.get();
+        }
+    }
+
     CompileTriplet::CompileTriplet(std::string compiler_tag,
                                    std::string optimization_tag,
                                    std::string obfuscation_tag,
                                    Triplet triplet)
-        : compiler_tag(std::move(compiler_tag))
-        , optimization_tag(std::move(optimization_tag))
-        , obfuscation_tag(std::move(obfuscation_tag))
-        , triplet(std::move(triplet))
+        : m_instance(intern(std::move(compiler_tag), std::move(optimization_tag), std::move(obfuscation_tag), triplet))
     {
     }
 
@@ -23,16 +99,25 @@ namespace vcpkg::bin2sth
                                    std::unique_ptr<std::string> const& optimization_tag,
                                    std::unique_ptr<std::string> const& obfuscation_tag,
                                    Triplet triplet)
-        : compiler_tag(deref_or(compiler_tag, DEFAULT_COMPILER_TAG))
-        , optimization_tag(deref_or(optimization_tag, DEFAULT_OPTIMIZATION_TAG))
-        , obfuscation_tag(deref_or(obfuscation_tag, DEFAULT_OBFUSCATION_TAG))
-        , triplet(triplet)
+        : m_instance(intern(deref_or(compiler_tag, DEFAULT_COMPILER_TAG),
+                            deref_or(optimization_tag, DEFAULT_OPTIMIZATION_TAG),
+                            deref_or(obfuscation_tag, DEFAULT_OBFUSCATION_TAG),
+                            triplet))
     {
     }
 
     Optional<CompileTriplet> CompileTriplet::from_canonical_name(const std::string& canonical_name, Triplet triplet)
     {
         if (canonical_name.empty()) return nullopt;
+        {
+            LockGuardPtr<CompileTripletRegistry> registry(registry_instance());
+            auto it = registry->by_name.find(std::make_pair(StringView(canonical_name), triplet));
+            if (it != registry->by_name.end())
+            {
+                return CompileTriplet(it->second);
+            }
+        }
+
         auto parts = Strings::split(canonical_name, '_');
         Checks::check_exit(VCPKG_LINE_INFO, parts.size() == 3);
         return CompileTriplet{std::move(parts[0]), std::move(parts[1]), std::move(parts[2]), std::move(triplet)};
@@ -40,29 +125,12 @@ namespace vcpkg::bin2sth
 
     std::string CompileTriplet::to_string() const { return canonical_name(); }
 
-    void CompileTriplet::to_string(std::string& str) const { str.append(to_string()); }
-
-    std::string CompileTriplet::canonical_name() const
-    {
-        return Strings::format("%s_%s_%s", compiler_tag, optimization_tag, obfuscation_tag);
-    }
-
-    void CompileTriplet::with_triplet(Triplet new_triplet) { this->triplet = std::move(new_triplet); }
-
-    size_t CompileTriplet::hash_code() const
-    {
-        auto const fn_str_hash = std::hash<std::string>();
-        size_t hash = 17;
-        hash = hash * 31 + fn_str_hash(compiler_tag);
-        hash = hash * 31 + fn_str_hash(optimization_tag);
-        hash = hash * 31 + fn_str_hash(obfuscation_tag);
-        hash = hash * 31 + std::hash<Triplet>()(triplet);
-        return hash;
-    }
+    void CompileTriplet::to_string(std::string& str) const { str.append(canonical_name()); }
 
-    bool operator==(CompileTriplet const& left, CompileTriplet const& right)
+    void CompileTriplet::with_triplet(Triplet new_triplet)
     {
-        return left.hash_code() == right.hash_code();
+        m_instance = intern(
+            std::string(compiler_tag()), std::string(optimization_tag()), std::string(obfuscation_tag()), new_triplet);
     }
 
     Optional<CompileTriplet> default_compile_triplet(vcpkg::VcpkgCmdArguments const& args,
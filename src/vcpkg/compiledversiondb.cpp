@@ -0,0 +1,379 @@
+#include <vcpkg/base/checks.h>
+#include <vcpkg/base/strings.h>
+#include <vcpkg/base/system.debug.h>
+#include <vcpkg/base/util.h>
+
+#include <vcpkg/compiledversiondb.h>
+
+#include <algorithm>
+#include <limits>
+
+namespace
+{
+    using namespace vcpkg;
+
+    constexpr char MAGIC[] = {'v', 'c', 'p', 'k', 'g', 'v', 'd', 'b'};
+    constexpr uint32_t FORMAT_VERSION = 2;
+
+    constexpr size_t HEADER_SIZE = sizeof(MAGIC) + 6 * 4;
+    constexpr size_t PORT_RECORD_SIZE = 7 * 4;
+    constexpr size_t GIT_TREE_SIZE = 20;
+    constexpr size_t ENTRY_RECORD_SIZE = 3 * 4 + 4 + GIT_TREE_SIZE;
+
+    // offsets of the fields of a port record
+    constexpr size_t PORT_NAME = 0;
+    constexpr size_t PORT_FIRST_ENTRY = 8;
+    constexpr size_t PORT_ENTRY_COUNT = 12;
+    constexpr size_t PORT_BASELINE = 16;
+    constexpr size_t PORT_BASELINE_PORT_VERSION = 24;
+
+    // offsets of the fields of an entry record
+    constexpr size_t ENTRY_VERSION = 0;
+    constexpr size_t ENTRY_PORT_VERSION = 8;
+    constexpr size_t ENTRY_SCHEME = 12;
+    constexpr size_t ENTRY_GIT_TREE = 16;
+
+    void append_u32(std::string& out, uint32_t value)
+    {
+        for (int shift = 0; shift < 32; shift += 8)
+        {
+            out.push_back(static_cast<char>((value >> shift) & 0xFF));
+        }
+    }
+
+    void append_i32(std::string& out, int32_t value) { append_u32(out, static_cast<uint32_t>(value)); }
+
+    uint32_t read_u32(const char* data)
+    {
+        uint32_t result = 0;
+        for (int idx = 3; idx >= 0; --idx)
+        {
+            result = (result << 8) | static_cast<unsigned char>(data[idx]);
+        }
+
+        return result;
+    }
+
+    int32_t read_i32(const char* data) { return static_cast<int32_t>(read_u32(data)); }
+
+    int from_hex_digit(char ch) { return ch <= '9' ? ch - '0' : ch - 'a' + 10; }
+
+    struct StringTable
+    {
+        std::string data;
+
+        // appends the offset and size of `sv` in the table
+        bool append_reference(std::string& out, StringView sv)
+        {
+            if (data.size() + sv.size() > std::numeric_limits<uint32_t>::max())
+            {
+                return false;
+            }
+
+            append_u32(out, static_cast<uint32_t>(data.size()));
+            append_u32(out, static_cast<uint32_t>(sv.size()));
+            data.append(sv.data(), sv.size());
+            return true;
+        }
+    };
+}
+
+namespace vcpkg
+{
+    ExpectedS<std::string> CompiledVersionDb::compile(std::vector<PortVersions> ports,
+                                                      const std::map<std::string, Version, std::less<>>& baseline,
+                                                      StringView source_key)
+    {
+        const auto by_name = [](const PortVersions& lhs, const PortVersions& rhs) {
+            return lhs.port_name < rhs.port_name;
+        };
+
+        // ports that are only in the baseline get a record without entries
+        Util::sort(ports, by_name);
+        const auto ports_with_versions = ports.size();
+        for (auto&& baseline_entry : baseline)
+        {
+            PortVersions baseline_only{baseline_entry.first, {}};
+            if (!std::binary_search(ports.begin(), ports.begin() + ports_with_versions, baseline_only, by_name))
+            {
+                ports.push_back(std::move(baseline_only));
+            }
+        }
+
+        std::inplace_merge(ports.begin(), ports.begin() + ports_with_versions, ports.end(), by_name);
+        for (size_t idx = 1; idx < ports.size(); ++idx)
+        {
+            if (ports[idx - 1].port_name == ports[idx].port_name)
+            {
+                return {Strings::concat("Error: the port ", ports[idx].port_name, " is listed more than once"),
+                        expected_right_tag};
+            }
+        }
+
+        size_t entry_count = 0;
+        for (auto&& port : ports)
+        {
+            entry_count += port.entries.size();
+        }
+
+        if (ports.size() > std::numeric_limits<uint32_t>::max() || entry_count > std::numeric_limits<uint32_t>::max())
+        {
+            return {"Error: too many versions to compile", expected_right_tag};
+        }
+
+        StringTable strings;
+        std::string source_key_reference;
+        if (!strings.append_reference(source_key_reference, source_key))
+        {
+            return {"Error: too many versions to compile", expected_right_tag};
+        }
+
+        std::string port_records;
+        port_records.reserve(ports.size() * PORT_RECORD_SIZE);
+        std::string entry_records;
+        entry_records.reserve(entry_count * ENTRY_RECORD_SIZE);
+        uint32_t first_entry = 0;
+        for (auto&& port : ports)
+        {
+            if (!strings.append_reference(port_records, port.port_name))
+            {
+                return {"Error: too many versions to compile", expected_right_tag};
+            }
+
+            append_u32(port_records, first_entry);
+            append_u32(port_records, static_cast<uint32_t>(port.entries.size()));
+            first_entry += static_cast<uint32_t>(port.entries.size());
+
+            auto baseline_it = baseline.find(port.port_name);
+            if (baseline_it == baseline.end())
+            {
+                append_u32(port_records, 0);
+                append_u32(port_records, 0);
+                append_i32(port_records, -1);
+            }
+            else
+            {
+                if (!strings.append_reference(port_records, baseline_it->second.text()))
+                {
+                    return {"Error: too many versions to compile", expected_right_tag};
+                }
+
+                append_i32(port_records, baseline_it->second.port_version());
+            }
+
+            for (auto&& entry : port.entries)
+            {
+                if (!is_git_commit_sha(entry.git_tree))
+                {
+                    return {Strings::concat("Error: the version ",
+                                            entry.version.to_string(),
+                                            " of ",
+                                            port.port_name,
+                                            " has the git tree \"",
+                                            entry.git_tree,
+                                            "\", which is not a SHA-1 in lowercase hexadecimal"),
+                            expected_right_tag};
+                }
+
+                if (!strings.append_reference(entry_records, entry.version.text()))
+                {
+                    return {"Error: too many versions to compile", expected_right_tag};
+                }
+
+                append_i32(entry_records, entry.version.port_version());
+                entry_records.push_back(static_cast<char>(entry.scheme));
+                entry_records.append(3, '\0');
+                for (size_t idx = 0; idx < entry.git_tree.size(); idx += 2)
+                {
+                    entry_records.push_back(static_cast<char>((from_hex_digit(entry.git_tree[idx]) << 4) |
+                                                              from_hex_digit(entry.git_tree[idx + 1])));
+                }
+            }
+        }
+
+        std::string result(MAGIC, sizeof(MAGIC));
+        append_u32(result, FORMAT_VERSION);
+        append_u32(result, static_cast<uint32_t>(ports.size()));
+        append_u32(result, static_cast<uint32_t>(entry_count));
+        append_u32(result, static_cast<uint32_t>(strings.data.size()));
+        result.append(source_key_reference);
+        result.reserve(result.size() + port_records.size() + entry_records.size() + strings.data.size());
+        result.append(port_records);
+        result.append(entry_records);
+        result.append(strings.data);
+        return {std::move(result), expected_left_tag};
+    }
+
+    Optional<CompiledVersionDb> CompiledVersionDb::from_mapping(MappedFile&& file)
+    {
+        const auto contents = file.contents();
+        if (contents.size() < HEADER_SIZE || !std::equal(MAGIC, MAGIC + sizeof(MAGIC), contents.data()) ||
+            read_u32(contents.data() + 8) != FORMAT_VERSION)
+        {
+            return nullopt;
+        }
+
+        const uint64_t port_count = read_u32(contents.data() + 12);
+        const uint64_t entry_count = read_u32(contents.data() + 16);
+        const uint64_t strings_size = read_u32(contents.data() + 20);
+        if (contents.size() !=
+            HEADER_SIZE + port_count * PORT_RECORD_SIZE + entry_count * ENTRY_RECORD_SIZE + strings_size)
+        {
+            return nullopt;
+        }
+
+        CompiledVersionDb result(std::move(file));
+        result.m_port_count = static_cast<uint32_t>(port_count);
+        result.m_entry_count = static_cast<uint32_t>(entry_count);
+        result.m_ports = contents.data() + HEADER_SIZE;
+        result.m_entries = result.m_ports + port_count * PORT_RECORD_SIZE;
+        result.m_strings = StringView{result.m_entries + entry_count * ENTRY_RECORD_SIZE,
+                                      static_cast<size_t>(strings_size)};
+        result.m_source_key = result.string_at(contents.data() + 24);
+        return result;
+    }
+
+    // a reference outside of the string table reads as a truncated or empty string rather than out of bounds
+    StringView CompiledVersionDb::string_at(const char* offset_and_size) const
+    {
+        return m_strings.substr(read_u32(offset_and_size), read_u32(offset_and_size + 4));
+    }
+
+    const char* CompiledVersionDb::find_port(StringView port_name) const
+    {
+        uint32_t first = 0;
+        uint32_t count = m_port_count;
+        while (count > 0)
+        {
+            const auto step = count / 2;
+            const auto middle = first + step;
+            if (string_at(m_ports + middle * PORT_RECORD_SIZE + PORT_NAME) < port_name)
+            {
+                first = middle + 1;
+                count -= step + 1;
+            }
+            else
+            {
+                count = step;
+            }
+        }
+
+        if (first == m_port_count)
+        {
+            return nullptr;
+        }
+
+        const char* port = m_ports + first * PORT_RECORD_SIZE;
+        if (string_at(port + PORT_NAME) == port_name)
+        {
+            return port;
+        }
+
+        return nullptr;
+    }
+
+    Optional<std::vector<VersionDbEntry>> CompiledVersionDb::get_port_versions(StringView port_name) const
+    {
+        const char* port = find_port(port_name);
+        if (!port || read_u32(port + PORT_ENTRY_COUNT) == 0)
+        {
+            return nullopt;
+        }
+
+        static constexpr char HEX_DIGITS[] = "0123456789abcdef";
+        const auto first_entry = read_u32(port + PORT_FIRST_ENTRY);
+        const auto entry_count = read_u32(port + PORT_ENTRY_COUNT);
+        Checks::check_exit(VCPKG_LINE_INFO,
+                           uint64_t(first_entry) + entry_count <= m_entry_count,
+                           "Error: the compiled versions database is corrupt; delete it to use the versions files");
+        std::vector<VersionDbEntry> result(entry_count);
+        const char* entry = m_entries + uint64_t(first_entry) * ENTRY_RECORD_SIZE;
+        for (auto&& db_entry : result)
+        {
+            Checks::check_exit(
+                VCPKG_LINE_INFO,
+                static_cast<unsigned char>(entry[ENTRY_SCHEME]) <= static_cast<unsigned char>(VersionScheme::String),
+                "Error: the compiled versions database is corrupt; delete it to use the versions files");
+            db_entry.version =
+                Version{string_at(entry + ENTRY_VERSION).to_string(), read_i32(entry + ENTRY_PORT_VERSION)};
+            db_entry.scheme = static_cast<VersionScheme>(entry[ENTRY_SCHEME]);
+            db_entry.git_tree.reserve(GIT_TREE_SIZE * 2);
+            for (size_t idx = 0; idx < GIT_TREE_SIZE; ++idx)
+            {
+                const auto byte = static_cast<unsigned char>(entry[ENTRY_GIT_TREE + idx]);
+                db_entry.git_tree.push_back(HEX_DIGITS[byte >> 4]);
+                db_entry.git_tree.push_back(HEX_DIGITS[byte & 0xF]);
+            }
+
+            entry += ENTRY_RECORD_SIZE;
+        }
+
+        return result;
+    }
+
+    Optional<Version> CompiledVersionDb::get_baseline_version(StringView port_name) const
+    {
+        const char* port = find_port(port_name);
+        if (!port || read_i32(port + PORT_BASELINE_PORT_VERSION) < 0)
+        {
+            return nullopt;
+        }
+
+        return Version{string_at(port + PORT_BASELINE).to_string(), read_i32(port + PORT_BASELINE_PORT_VERSION)};
+    }
+
+    std::map<std::string, Version, std::less<>> CompiledVersionDb::get_baseline() const
+    {
+        std::map<std::string, Version, std::less<>> result;
+        for (uint32_t idx = 0; idx < m_port_count; ++idx)
+        {
+            const char* port = m_ports + idx * PORT_RECORD_SIZE;
+            if (read_i32(port + PORT_BASELINE_PORT_VERSION) >= 0)
+            {
+                // the ports are sorted, so each one goes at the end
+                result.emplace_hint(
+                    result.end(),
+                    string_at(port + PORT_NAME).to_string(),
+                    Version{string_at(port + PORT_BASELINE).to_string(), read_i32(port + PORT_BASELINE_PORT_VERSION)});
+            }
+        }
+
+        return result;
+    }
+
+    Optional<CompiledVersionDb> try_load_compiled_versions_db(const Filesystem& fs,
+                                                              const Path& db_path,
+                                                              StringView source_key)
+    {
+        std::error_code ec;
+        auto mapping = fs.map_for_read(db_path, ec);
+        if (ec)
+        {
+            Debug::print("Failed to map the compiled versions database ", db_path, ": ", ec.message(), '\n');
+            return nullopt;
+        }
+
+        auto maybe_db = CompiledVersionDb::from_mapping(std::move(mapping));
+        auto db = maybe_db.get();
+        if (!db)
+        {
+            Debug::print("Ignoring the compiled versions database ", db_path, " because it is not valid\n");
+            return nullopt;
+        }
+
+        if (db->source_key() != source_key)
+        {
+            Debug::print("Ignoring the compiled versions database ",
+                         db_path,
+                         " because it was compiled from ",
+                         db->source_key(),
+                         " rather than ",
+                         source_key,
+                         '\n');
+            return nullopt;
+        }
+
+        Debug::print("Using the compiled versions database ", db_path, '\n');
+        return maybe_db;
+    }
+}
@@ -1,3 +1,4 @@
+#include <vcpkg/base/hash.h>
 #include <vcpkg/base/json.h>
 #include <vcpkg/base/jsonreader.h>
 #include <vcpkg/base/lineinfo.h>
@@ -15,6 +16,12 @@ namespace vcpkg
             constexpr static StringLiteral NAME = "name";
             constexpr static StringLiteral C_FULL_PATH = "c";
             constexpr static StringLiteral CXX_FULL_PATH = "cxx";
+            constexpr static StringLiteral FINGERPRINT = "fingerprint";
+        }
+
+        namespace CompilerIndexFields
+        {
+            constexpr static StringLiteral COMPILERS = "compilers";
         }
 
         struct CompilerInfoDeserializer : Json::IDeserializer<CompilerInfo>
@@ -28,6 +35,7 @@ namespace vcpkg
                     CompilerInfoFields::NAME,
                     CompilerInfoFields::C_FULL_PATH,
                     CompilerInfoFields::CXX_FULL_PATH,
+                    CompilerInfoFields::FINGERPRINT,
                 };
                 return u;
             }
@@ -42,6 +50,7 @@ namespace vcpkg
                 r.optional_object_field(obj, NAME, compiler_info.name, string_deserializer);
                 r.optional_object_field(obj, C_FULL_PATH, compiler_info.c_full_path, PathDeserializer::instance);
                 r.optional_object_field(obj, CXX_FULL_PATH, compiler_info.cxx_full_path, PathDeserializer::instance);
+                r.optional_object_field(obj, FINGERPRINT, compiler_info.fingerprint, string_deserializer);
                 return compiler_info;
             }
 
@@ -58,38 +67,50 @@ namespace vcpkg
             json_obj.insert(NAME, Json::Value::string(compiler_info.name));
             json_obj.insert(C_FULL_PATH, Json::Value::string(compiler_info.c_full_path.generic_u8string()));
             json_obj.insert(CXX_FULL_PATH, Json::Value::string(compiler_info.cxx_full_path.generic_u8string()));
+            if (!compiler_info.fingerprint.empty())
+            {
+                json_obj.insert(FINGERPRINT, Json::Value::string(compiler_info.fingerprint));
+            }
             return json_obj;
         }
-    }
 
-    CompilerInfo CompilerInfo::load(const Filesystem& filesystem, const Path& path)
-    {
-        std::error_code ec;
-        auto compiler_config_opt = Json::parse_file(filesystem, path, ec);
-        if (ec || !compiler_config_opt.has_value())
+        static Json::Value parse_json_object_file(const Filesystem& filesystem, const Path& path, StringView what)
         {
-            Checks::exit_with_message(
-                VCPKG_LINE_INFO, "Failed to parse compiler config at %s:\n%s", path, ec.message());
-        }
+            std::error_code ec;
+            auto config_opt = Json::parse_file(filesystem, path, ec);
+            if (ec || !config_opt.has_value())
+            {
+                Checks::exit_with_message(VCPKG_LINE_INFO, "Failed to parse %s at %s:\n%s", what, path, ec.message());
+            }
 
-        auto compiler_config_value = std::move(compiler_config_opt).value_or_exit(VCPKG_LINE_INFO);
-        if (!compiler_config_value.first.is_object())
-        {
-            Checks::exit_with_message(
-                VCPKG_LINE_INFO,
-                "Failed to parse compiler config at %s:\nCompiler Config files must have a top-level object\n",
-                path);
+            auto config_value = std::move(config_opt).value_or_exit(VCPKG_LINE_INFO);
+            if (!config_value.first.is_object())
+            {
+                Checks::exit_with_message(
+                    VCPKG_LINE_INFO, "Failed to parse %s at %s:\nThe file must have a top-level object\n", what, path);
+            }
+
+            return std::move(config_value.first);
         }
 
-        Json::Reader reader;
-        auto compiler_info_opt = reader.visit(compiler_config_value.first, details::CompilerInfoDeserializer::instance);
-        if (reader.errors().size())
+        static void exit_on_reader_errors(const Json::Reader& reader)
         {
-            auto const err_message = Strings::join("\n", reader.errors());
-            Checks::exit_with_message(
-                VCPKG_LINE_INFO, "Failed to convert compiler info json to instance:\n%s", err_message);
+            if (reader.errors().size())
+            {
+                auto const err_message = Strings::join("\n", reader.errors());
+                Checks::exit_with_message(
+                    VCPKG_LINE_INFO, "Failed to convert compiler info json to instance:\n%s", err_message);
+            }
         }
+    }
 
+    CompilerInfo CompilerInfo::load(const Filesystem& filesystem, const Path& path)
+    {
+        auto compiler_config = details::parse_json_object_file(filesystem, path, "compiler config");
+
+        Json::Reader reader;
+        auto compiler_info_opt = reader.visit(compiler_config, details::CompilerInfoDeserializer::instance);
+        details::exit_on_reader_errors(reader);
         return std::move(*compiler_info_opt.get());
     }
 
@@ -99,6 +120,15 @@ namespace vcpkg
         Json::dump_file(filesystem, path, serialized, Json::JsonStyle::with_spaces(4), VCPKG_LINE_INFO);
     }
 
+    std::string CompilerInfo::compute_fingerprint(const Filesystem& filesystem,
+                                                  const Path& c_path,
+                                                  const Path& cxx_path)
+    {
+        auto const c_hash = Hash::get_file_hash(VCPKG_LINE_INFO, filesystem, c_path, Hash::Algorithm::Sha256);
+        auto const cxx_hash = Hash::get_file_hash(VCPKG_LINE_INFO, filesystem, cxx_path, Hash::Algorithm::Sha256);
+        return Hash::get_string_hash(Strings::concat(c_hash, ' ', cxx_hash), Hash::Algorithm::Sha256);
+    }
+
     size_t CompilerInfo::hash_code() const
     {
         auto const fn_str_hash = std::hash<std::string>();
@@ -107,7 +137,75 @@ namespace vcpkg
         hash = hash * 17 + fn_str_hash(version);
         hash = hash * 17 + fn_str_hash(c_full_path.generic_u8string());
         hash = hash * 17 + fn_str_hash(cxx_full_path.generic_u8string());
+        hash = hash * 17 + fn_str_hash(fingerprint);
         return hash;
     }
+}
+
+namespace vcpkg::CompilerIndex
+{
+    std::map<std::string, CompilerInfo> load(const Filesystem& filesystem, const Path& index_path)
+    {
+        std::map<std::string, CompilerInfo> compilers;
+        if (!filesystem.exists(index_path, IgnoreErrors{}))
+        {
+            return compilers;
+        }
+
+        auto index = details::parse_json_object_file(filesystem, index_path, "compiler index");
+        auto entries = index.object().get(details::CompilerIndexFields::COMPILERS);
+        if (!entries)
+        {
+            return compilers;
+        }
+
+        Checks::check_exit(VCPKG_LINE_INFO,
+                           entries->is_object(),
+                           "Failed to parse compiler index at %s:\n\"%s\" must be an object\n",
+                           index_path,
+                           details::CompilerIndexFields::COMPILERS);
+
+        Json::Reader reader;
+        for (auto&& entry : entries->object())
+        {
+            CompilerInfo compiler_info;
+            reader.visit_in_key(entry.second, entry.first, compiler_info, details::CompilerInfoDeserializer::instance);
+            compilers.emplace(entry.first.to_string(), std::move(compiler_info));
+        }
+
+        details::exit_on_reader_errors(reader);
+        return compilers;
+    }
+
+    void dump(Filesystem& filesystem, const Path& index_path, const std::map<std::string, CompilerInfo>& compilers)
+    {
+        Json::Object entries;
+        for (auto&& compiler : compilers)
+        {
+            entries.insert(compiler.first, details::serialize(compiler.second));
+        }
+
+        Json::Object index;
+        index.insert(details::CompilerIndexFields::COMPILERS, std::move(entries));
+        Json::dump_file(filesystem, index_path, index, Json::JsonStyle::with_spaces(4), VCPKG_LINE_INFO);
+    }
+
+    bool add(Filesystem& filesystem, const Path& index_path, CompilerInfo compiler_info)
+    {
+        auto compilers = load(filesystem, index_path);
+        auto nickname = compiler_info.nickname();
+        auto it = compilers.find(nickname);
+        if (it != compilers.end() && !it->second.fingerprint.empty())
+        {
+            return false;
+        }
+
+        compiler_info.fingerprint =
+            CompilerInfo::compute_fingerprint(filesystem, compiler_info.c_full_path, compiler_info.cxx_full_path);
+        compilers[std::move(nickname)] = std::move(compiler_info);
+        filesystem.create_directories(index_path.parent_path(), VCPKG_LINE_INFO);
+        dump(filesystem, index_path, compilers);
+        return true;
+    }
 
 }
\ No newline at end of file
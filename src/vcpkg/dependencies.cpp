@@ -1,6 +1,7 @@
 #include <vcpkg/base/files.h>
 #include <vcpkg/base/graphs.h>
 #include <vcpkg/base/strings.h>
+#include <vcpkg/base/tracing.h>
 #include <vcpkg/base/util.h>
 
 #include <vcpkg/cmakevars.h>
@@ -13,6 +14,9 @@
 #include <vcpkg/vcpkglib.h>
 #include <vcpkg/vcpkgpaths.h>
 
+#include <array>
+#include <tuple>
+
 using namespace vcpkg;
 
 namespace vcpkg::Dependencies
@@ -368,6 +372,32 @@ namespace vcpkg::Dependencies
         public:
             const Triplet m_host_triplet;
         };
+
+        // Hands out dense indices for package specs, in the order they are first seen, for the graph providers below.
+        struct PackageSpecIndex
+        {
+            size_t id_of(const PackageSpec& spec)
+            {
+                auto p = m_ids.emplace(spec, m_specs.size());
+                if (p.second)
+                {
+                    m_specs.push_back(spec);
+                }
+
+                return p.first->second;
+            }
+
+            std::vector<size_t> ids_of(const std::vector<PackageSpec>& specs)
+            {
+                return Util::fmap(specs, [this](const PackageSpec& spec) { return id_of(spec); });
+            }
+
+            const PackageSpec& operator[](size_t id) const { return m_specs[id]; }
+
+        private:
+            std::vector<PackageSpec> m_specs;
+            std::unordered_map<PackageSpec, size_t> m_ids;
+        };
     }
 
     static std::string to_output_string(RequestType request_type,
@@ -583,42 +613,49 @@ namespace vcpkg::Dependencies
     std::vector<RemovePlanAction> create_remove_plan(const std::vector<PackageSpec>& specs,
                                                      const StatusParagraphs& status_db)
     {
-        struct RemoveAdjacencyProvider final : Graphs::AdjacencyProvider<PackageSpec, RemovePlanAction>
+        struct RemoveAdjacencyProvider final : Graphs::AdjacencyProvider<RemovePlanAction>
         {
             const StatusParagraphs& status_db;
-            const std::vector<InstalledPackageView>& installed_ports;
             const std::unordered_set<PackageSpec>& specs_as_set;
+            PackageSpecIndex index;
+            // the dependents of each installed port; installed ports are numbered first
+            std::vector<std::vector<size_t>> dependents;
 
             RemoveAdjacencyProvider(const StatusParagraphs& status_db,
-                                    const std::vector<InstalledPackageView>& installed_ports,
                                     const std::unordered_set<PackageSpec>& specs_as_set)
-                : status_db(status_db), installed_ports(installed_ports), specs_as_set(specs_as_set)
+                : status_db(status_db), specs_as_set(specs_as_set)
             {
-            }
-
-            std::vector<PackageSpec> adjacency_list(const RemovePlanAction& plan) const override
-            {
-                if (plan.plan_type == RemovePlanType::NOT_INSTALLED)
+                const auto installed_ports = get_installed_ports(status_db);
+                for (auto&& ipv : installed_ports)
                 {
-                    return {};
+                    index.id_of(ipv.spec());
                 }
 
-                const PackageSpec& spec = plan.spec;
-                std::vector<PackageSpec> dependents;
-                for (auto&& ipv : installed_ports)
+                dependents.resize(installed_ports.size());
+                for (size_t id = 0; id < installed_ports.size(); ++id)
                 {
-                    auto deps = ipv.dependencies();
-
-                    if (std::find(deps.begin(), deps.end(), spec) == deps.end()) continue;
-
-                    dependents.push_back(ipv.spec());
+                    for (auto&& dep : installed_ports[id].dependencies())
+                    {
+                        const auto dep_id = index.id_of(dep);
+                        if (dep_id < dependents.size())
+                        {
+                            dependents[dep_id].push_back(id);
+                        }
+                    }
                 }
+            }
 
-                return dependents;
+            void append_adjacency_list(size_t vertex, std::vector<size_t>& out) const override
+            {
+                if (vertex < dependents.size())
+                {
+                    out.insert(out.end(), dependents[vertex].begin(), dependents[vertex].end());
+                }
             }
 
-            RemovePlanAction load_vertex_data(const PackageSpec& spec) const override
+            RemovePlanAction load_vertex_data(size_t vertex) const override
             {
+                const PackageSpec& spec = index[vertex];
                 const RequestType request_type = specs_as_set.find(spec) != specs_as_set.end()
                                                      ? RequestType::USER_REQUESTED
                                                      : RequestType::AUTO_SELECTED;
@@ -630,35 +667,56 @@ namespace vcpkg::Dependencies
                 return RemovePlanAction{spec, RemovePlanType::REMOVE, request_type};
             }
 
-            std::string to_string(const PackageSpec& spec) const override { return spec.to_string(); }
+            std::string to_string(size_t vertex) const override { return index[vertex].to_string(); }
         };
 
-        auto installed_ports = get_installed_ports(status_db);
         const std::unordered_set<PackageSpec> specs_as_set(specs.cbegin(), specs.cend());
-        return Graphs::topological_sort(
-            std::move(specs), RemoveAdjacencyProvider{status_db, installed_ports, specs_as_set}, {});
+        RemoveAdjacencyProvider provider{status_db, specs_as_set};
+        const auto starts = provider.index.ids_of(specs);
+        return Graphs::topological_sort(starts, provider, {});
     }
 
     std::vector<ExportPlanAction> create_export_plan(const std::vector<PackageSpec>& specs,
                                                      const StatusParagraphs& status_db)
     {
-        struct ExportAdjacencyProvider final : Graphs::AdjacencyProvider<PackageSpec, ExportPlanAction>
+        struct ExportAdjacencyProvider final : Graphs::AdjacencyProvider<ExportPlanAction>
         {
             const StatusParagraphs& status_db;
             const std::unordered_set<PackageSpec>& specs_as_set;
+            PackageSpecIndex index;
+            // the dependencies of each installed port; installed ports are numbered first
+            std::vector<std::vector<size_t>> dependencies;
 
             ExportAdjacencyProvider(const StatusParagraphs& s, const std::unordered_set<PackageSpec>& specs_as_set)
                 : status_db(s), specs_as_set(specs_as_set)
             {
+                const auto installed_ports = get_installed_ports(status_db);
+                for (auto&& ipv : installed_ports)
+                {
+                    index.id_of(ipv.spec());
+                }
+
+                dependencies.resize(installed_ports.size());
+                for (size_t id = 0; id < installed_ports.size(); ++id)
+                {
+                    for (auto&& dep : installed_ports[id].dependencies())
+                    {
+                        dependencies[id].push_back(index.id_of(dep));
+                    }
+                }
             }
 
-            std::vector<PackageSpec> adjacency_list(const ExportPlanAction& plan) const override
+            void append_adjacency_list(size_t vertex, std::vector<size_t>& out) const override
             {
-                return plan.dependencies();
+                if (vertex < dependencies.size())
+                {
+                    out.insert(out.end(), dependencies[vertex].begin(), dependencies[vertex].end());
+                }
             }
 
-            ExportPlanAction load_vertex_data(const PackageSpec& spec) const override
+            ExportPlanAction load_vertex_data(size_t vertex) const override
             {
+                const PackageSpec& spec = index[vertex];
                 const RequestType request_type = specs_as_set.find(spec) != specs_as_set.end()
                                                      ? RequestType::USER_REQUESTED
                                                      : RequestType::AUTO_SELECTED;
@@ -673,12 +731,13 @@ namespace vcpkg::Dependencies
                 return ExportPlanAction{spec, request_type};
             }
 
-            std::string to_string(const PackageSpec& spec) const override { return spec.to_string(); }
+            std::string to_string(size_t vertex) const override { return index[vertex].to_string(); }
         };
 
         const std::unordered_set<PackageSpec> specs_as_set(specs.cbegin(), specs.cend());
-        std::vector<ExportPlanAction> toposort =
-            Graphs::topological_sort(specs, ExportAdjacencyProvider{status_db, specs_as_set}, {});
+        ExportAdjacencyProvider provider{status_db, specs_as_set};
+        const auto starts = provider.index.ids_of(specs);
+        std::vector<ExportPlanAction> toposort = Graphs::topological_sort(starts, provider, {});
         return toposort;
     }
 
@@ -693,6 +752,7 @@ namespace vcpkg::Dependencies
                                            const StatusParagraphs& status_db,
                                            const CreateInstallPlanOptions& options)
     {
+        Tracing::TraceSpan span("plan", "create_feature_install_plan");
         PackageGraph pgraph(port_provider, var_provider, status_db, options.host_triplet);
 
         std::vector<FeatureSpec> feature_specs;
@@ -904,6 +964,7 @@ namespace vcpkg::Dependencies
                                    const StatusParagraphs& status_db,
                                    const CreateInstallPlanOptions& options)
     {
+        Tracing::TraceSpan span("plan", "create_upgrade_plan");
         PackageGraph pgraph(port_provider, var_provider, status_db, options.host_triplet);
 
         pgraph.upgrade(specs, options.unsupported_port_action);
@@ -913,64 +974,82 @@ namespace vcpkg::Dependencies
 
     ActionPlan PackageGraph::serialize(Graphs::Randomizer* randomizer) const
     {
-        struct BaseEdgeProvider : Graphs::AdjacencyProvider<PackageSpec, const Cluster*>
+        // m_graph is ordered by spec, so a cluster's index in `clusters` can be found by binary search
+        std::vector<const Cluster*> clusters;
+        std::vector<size_t> removed_vertices;
+        std::vector<size_t> installed_vertices;
+        for (auto&& kv : *m_graph)
         {
-            BaseEdgeProvider(const ClusterGraph& parent) : m_parent(parent) { }
+            const auto id = clusters.size();
+            clusters.push_back(&kv.second);
+            if (kv.second.m_install_info.has_value() && kv.second.m_installed.has_value())
+            {
+                removed_vertices.push_back(id);
+            }
+            if (kv.second.m_install_info.has_value() || kv.second.request_type == RequestType::USER_REQUESTED)
+            {
+                installed_vertices.push_back(id);
+            }
+        }
+
+        struct BaseEdgeProvider : Graphs::AdjacencyProvider<const Cluster*>
+        {
+            BaseEdgeProvider(const std::vector<const Cluster*>& clusters) : m_clusters(clusters) { }
 
-            std::string to_string(const PackageSpec& spec) const override { return spec.to_string(); }
-            const Cluster* load_vertex_data(const PackageSpec& spec) const override
+            std::string to_string(size_t vertex) const override { return m_clusters[vertex]->m_spec.to_string(); }
+            const Cluster* load_vertex_data(size_t vertex) const override { return m_clusters[vertex]; }
+
+            size_t id_of(const PackageSpec& spec) const
             {
-                return &m_parent.find_or_exit(spec, VCPKG_LINE_INFO);
+                auto it = std::lower_bound(
+                    m_clusters.begin(), m_clusters.end(), spec, [](const Cluster* cluster, const PackageSpec& spec) {
+                        return cluster->m_spec < spec;
+                    });
+                Checks::check_exit(VCPKG_LINE_INFO,
+                                   it != m_clusters.end() && (*it)->m_spec == spec,
+                                   "Failed to locate spec in graph: %s",
+                                   spec);
+                return static_cast<size_t>(it - m_clusters.begin());
             }
 
-            const ClusterGraph& m_parent;
+            const std::vector<const Cluster*>& m_clusters;
         };
 
         struct RemoveEdgeProvider final : BaseEdgeProvider
         {
             using BaseEdgeProvider::BaseEdgeProvider;
 
-            std::vector<PackageSpec> adjacency_list(const Cluster* const& vertex) const override
+            void append_adjacency_list(size_t vertex, std::vector<size_t>& out) const override
             {
-                auto&& set = vertex->m_installed.value_or_exit(VCPKG_LINE_INFO).remove_edges;
-                return {set.begin(), set.end()};
+                for (auto&& spec : m_clusters[vertex]->m_installed.value_or_exit(VCPKG_LINE_INFO).remove_edges)
+                {
+                    out.push_back(id_of(spec));
+                }
             }
-        } removeedgeprovider(*m_graph);
+        } removeedgeprovider(clusters);
 
         struct InstallEdgeProvider final : BaseEdgeProvider
         {
             using BaseEdgeProvider::BaseEdgeProvider;
 
-            std::vector<PackageSpec> adjacency_list(const Cluster* const& vertex) const override
+            void append_adjacency_list(size_t vertex, std::vector<size_t>& out) const override
             {
-                if (!vertex->m_install_info.has_value()) return {};
+                auto cluster = m_clusters[vertex];
+                if (!cluster->m_install_info.has_value()) return;
 
-                auto& info = vertex->m_install_info.value_or_exit(VCPKG_LINE_INFO);
-                std::vector<PackageSpec> deps;
+                auto& info = cluster->m_install_info.value_or_exit(VCPKG_LINE_INFO);
+                const auto first = out.size();
                 for (auto&& kv : info.build_edges)
                     for (auto&& e : kv.second)
                     {
-                        auto spec = e.spec();
-                        if (spec != vertex->m_spec) deps.push_back(std::move(spec));
+                        const auto id = id_of(e.spec());
+                        if (id != vertex) out.push_back(id);
                     }
-                Util::sort_unique_erase(deps);
-                return deps;
+                std::sort(out.begin() + first, out.end());
+                out.erase(std::unique(out.begin() + first, out.end()), out.end());
             }
-        } installedgeprovider(*m_graph);
+        } installedgeprovider(clusters);
 
-        std::vector<PackageSpec> removed_vertices;
-        std::vector<PackageSpec> installed_vertices;
-        for (auto&& kv : *m_graph)
-        {
-            if (kv.second.m_install_info.has_value() && kv.second.m_installed.has_value())
-            {
-                removed_vertices.push_back(kv.first);
-            }
-            if (kv.second.m_install_info.has_value() || kv.second.request_type == RequestType::USER_REQUESTED)
-            {
-                installed_vertices.push_back(kv.first);
-            }
-        }
         auto remove_toposort = Graphs::topological_sort(removed_vertices, removeedgeprovider, randomizer);
         auto insert_toposort = Graphs::topological_sort(installed_vertices, installedgeprovider, randomizer);
 
@@ -1190,6 +1269,47 @@ namespace vcpkg::Dependencies
 
     namespace
     {
+        // A version parsed according to its scheme. The solver compares the same handful of versions over and over as
+        // constraints are added, so each one is parsed once and the comparisons work on the parsed components.
+        struct ParsedVersion
+        {
+            VersionScheme scheme;
+            Version version;
+            Optional<DotVersion> dot_version;
+            Optional<DateVersion> date_version;
+        };
+
+        VerComp compare_parsed_versions(const ParsedVersion& a, const ParsedVersion& b)
+        {
+            VerComp inner_compare = VerComp::unk;
+            if (a.scheme == VersionScheme::String && b.scheme == VersionScheme::String)
+            {
+                inner_compare = int_to_vercomp(a.version.text().compare(b.version.text()));
+            }
+            else if (auto a_date = a.date_version.get())
+            {
+                if (auto b_date = b.date_version.get())
+                {
+                    inner_compare = compare(*a_date, *b_date);
+                }
+            }
+            else if (auto a_dot = a.dot_version.get())
+            {
+                if (auto b_dot = b.dot_version.get())
+                {
+                    inner_compare = compare(*a_dot, *b_dot);
+                }
+            }
+
+            if (inner_compare == VerComp::eq)
+            {
+                if (a.version.port_version() < b.version.port_version()) return VerComp::lt;
+                if (a.version.port_version() > b.version.port_version()) return VerComp::gt;
+            }
+
+            return inner_compare;
+        }
+
         struct VersionedPackageGraph
         {
         private:
@@ -1242,8 +1362,6 @@ namespace vcpkg::Dependencies
                 std::vector<std::string> origins;
                 // mapping from feature name -> dependencies of this feature
                 std::map<std::string, std::vector<FeatureSpec>> deps;
-
-                bool is_less_than(const Version& new_ver) const;
             };
 
             struct PackageNode
@@ -1309,6 +1427,23 @@ namespace vcpkg::Dependencies
             std::map<std::string, Version> m_overrides;
             // mapping from { package specifier -> node containing resolution information for that package }
             std::map<PackageSpec, PackageNode> m_graph;
+            // versions parsed so far, one map per VersionScheme
+            std::array<std::map<Version, ParsedVersion, VersionMapLess>, 4> m_parsed_versions;
+            // the dep-info vars of each package, lowered for evaluating platform expressions
+            std::map<PackageSpec, PlatformExpression::EvaluationContext> m_evaluation_contexts;
+            // mapping from { package, port version, feature } -> the dependencies of that feature which are active on
+            // the package's platform; nullopt if that version of the port doesn't have the feature
+            std::map<std::tuple<PackageSpec, const SourceControlFile*, std::string>,
+                     Optional<std::vector<const Dependency*>>>
+                m_active_dependencies;
+
+            const ParsedVersion& parse_version(VersionScheme scheme, const Version& version);
+            VerComp compare_versions(VersionScheme sa, const Version& a, VersionScheme sb, const Version& b);
+
+            const PlatformExpression::EvaluationContext& evaluation_context(const PackageSpec& spec);
+            const std::vector<const Dependency*>* active_dependencies(const PackageSpec& spec,
+                                                                      const SourceControlFile& scf,
+                                                                      const std::string& feature);
 
             std::pair<const PackageSpec, PackageNode>& emplace_package(const PackageSpec& spec);
 
@@ -1390,56 +1525,78 @@ namespace vcpkg::Dependencies
             return it == vermap.end() ? nullptr : it->second;
         }
 
-        static VerComp compare_version_texts(VersionScheme sa, const Version& a, VersionScheme sb, const Version& b)
+        const ParsedVersion& VersionedPackageGraph::parse_version(VersionScheme scheme, const Version& version)
         {
-            if (sa == VersionScheme::String && sb == VersionScheme::String)
-            {
-                return int_to_vercomp(a.text().compare(b.text()));
-            }
+            auto& parsed_versions = m_parsed_versions[static_cast<size_t>(scheme)];
+            auto it = parsed_versions.find(version);
+            if (it != parsed_versions.end()) return it->second;
 
-            if (sa == VersionScheme::Date && sb == VersionScheme::Date)
+            ParsedVersion parsed{scheme, version, nullopt, nullopt};
+            if (scheme == VersionScheme::Date)
             {
-                return compare(DateVersion::try_parse(a.text()).value_or_exit(VCPKG_LINE_INFO),
-                               DateVersion::try_parse(b.text()).value_or_exit(VCPKG_LINE_INFO));
+                parsed.date_version = DateVersion::try_parse(version.text()).value_or_exit(VCPKG_LINE_INFO);
             }
-
-            if ((sa == VersionScheme::Semver || sa == VersionScheme::Relaxed) &&
-                (sb == VersionScheme::Semver || sb == VersionScheme::Relaxed))
+            else if (scheme == VersionScheme::Relaxed || scheme == VersionScheme::Semver)
             {
-                return compare(DotVersion::try_parse(a.text(), sa).value_or_exit(VCPKG_LINE_INFO),
-                               DotVersion::try_parse(b.text(), sb).value_or_exit(VCPKG_LINE_INFO));
+                parsed.dot_version = DotVersion::try_parse(version.text(), scheme).value_or_exit(VCPKG_LINE_INFO);
             }
 
-            return VerComp::unk;
+            return parsed_versions.emplace(version, std::move(parsed)).first->second;
         }
 
-        static VerComp compare_versions(VersionScheme sa, const Version& a, VersionScheme sb, const Version& b)
+        VerComp VersionedPackageGraph::compare_versions(VersionScheme sa,
+                                                        const Version& a,
+                                                        VersionScheme sb,
+                                                        const Version& b)
         {
-            const auto inner_compare = compare_version_texts(sa, a, sb, b);
-            if (inner_compare == VerComp::eq)
+            return compare_parsed_versions(parse_version(sa, a), parse_version(sb, b));
+        }
+
+        const PlatformExpression::EvaluationContext& VersionedPackageGraph::evaluation_context(const PackageSpec& spec)
+        {
+            auto it = m_evaluation_contexts.find(spec);
+            if (it == m_evaluation_contexts.end())
             {
-                if (a.port_version() < b.port_version()) return VerComp::lt;
-                if (a.port_version() > b.port_version()) return VerComp::gt;
+                auto context = PlatformExpression::EvaluationContext::from_cmake_vars(
+                    m_var_provider.get_or_load_dep_info_vars(spec, m_host_triplet));
+                it = m_evaluation_contexts.emplace(spec, std::move(context)).first;
             }
 
-            return inner_compare;
+            return it->second;
         }
 
-        bool VersionedPackageGraph::VersionSchemeInfo::is_less_than(const Version& new_ver) const
+        const std::vector<const Dependency*>* VersionedPackageGraph::active_dependencies(const PackageSpec& spec,
+                                                                                         const SourceControlFile& scf,
+                                                                                         const std::string& feature)
         {
-            Checks::check_exit(VCPKG_LINE_INFO, scfl);
-            ASSUME(scfl != nullptr);
-            auto s = scfl->source_control_file->core_paragraph->version_scheme;
-            auto r = compare_versions(s, version, s, new_ver);
-            Checks::check_exit(VCPKG_LINE_INFO, r != VerComp::unk);
-            return r == VerComp::lt;
+            auto key = std::make_tuple(spec, &scf, feature);
+            auto it = m_active_dependencies.find(key);
+            if (it == m_active_dependencies.end())
+            {
+                Optional<std::vector<const Dependency*>> active;
+                if (auto deps = scf.find_dependencies_for_feature(feature).get())
+                {
+                    auto& filtered = active.emplace();
+                    for (auto&& dep : *deps)
+                    {
+                        if (dep.platform.is_empty() || dep.platform.evaluate(evaluation_context(spec)))
+                        {
+                            filtered.push_back(&dep);
+                        }
+                    }
+                }
+
+                it = m_active_dependencies.emplace(std::move(key), std::move(active)).first;
+            }
+
+            return it->second.get();
         }
 
         void VersionedPackageGraph::add_feature_to(std::pair<const PackageSpec, PackageNode>& ref,
                                                    VersionSchemeInfo& vsi,
                                                    const std::string& feature)
         {
-            auto deps = vsi.scfl->source_control_file->find_dependencies_for_feature(feature);
+            auto deps = active_dependencies(ref.first, *vsi.scfl->source_control_file, feature);
             if (!deps)
             {
                 // This version doesn't have this feature. This may result in an error during finalize if the
@@ -1453,27 +1610,13 @@ namespace vcpkg::Dependencies
                 return;
             }
 
-            for (auto&& dep : *deps.get())
+            for (auto pdep : *deps)
             {
+                const auto& dep = *pdep;
                 PackageSpec dep_spec(dep.name,
                                      dep.host ? m_host_triplet : ref.first.triplet(),
                                      dep.host ? nullopt : ref.first.compile_triplet());
 
-                if (!dep.platform.is_empty())
-                {
-                    auto maybe_vars = m_var_provider.get_dep_info_vars(ref.first);
-                    if (!maybe_vars)
-                    {
-                        m_var_provider.load_dep_info_vars({&ref.first, 1}, m_host_triplet);
-                        maybe_vars = m_var_provider.get_dep_info_vars(ref.first);
-                    }
-
-                    if (!dep.platform.evaluate(maybe_vars.value_or_exit(VCPKG_LINE_INFO)))
-                    {
-                        continue;
-                    }
-                }
-
                 auto& dep_node = emplace_package(dep_spec);
                 if (dep_spec == ref.first)
                 {
@@ -1583,7 +1726,10 @@ namespace vcpkg::Dependencies
                 }
                 else
                 {
-                    replace = versioned_graph_entry.is_less_than(version);
+                    const auto scheme = versioned_graph_entry.scfl->source_control_file->core_paragraph->version_scheme;
+                    const auto r = compare_versions(scheme, versioned_graph_entry.version, scheme, version);
+                    Checks::check_exit(VCPKG_LINE_INFO, r != VerComp::unk);
+                    replace = r == VerComp::lt;
                 }
 
                 if (replace)
@@ -1709,7 +1855,7 @@ namespace vcpkg::Dependencies
             specs.push_back(toplevel);
             Util::sort_unique_erase(specs);
             m_var_provider.load_dep_info_vars(specs, m_host_triplet);
-            const auto& vars = m_var_provider.get_dep_info_vars(toplevel).value_or_exit(VCPKG_LINE_INFO);
+            const auto& vars = evaluation_context(toplevel);
             std::vector<const Dependency*> active_deps;
 
             // First add all top level packages to ensure the default_features is set to false before recursing into the
@@ -1732,6 +1878,20 @@ namespace vcpkg::Dependencies
                 }
             }
 
+            // The baselines of the registries of these dependencies are needed below; load them all at once rather
+            // than one registry at a time.
+            std::vector<std::string> baseline_ports;
+            for (auto pdep : active_deps)
+            {
+                if (!m_o_provider.get_control_file(pdep->name).has_value() &&
+                    m_overrides.find(pdep->name) == m_overrides.end())
+                {
+                    baseline_ports.push_back(pdep->name);
+                }
+            }
+
+            m_base_provider.prefetch_baseline_versions(baseline_ports);
+
             for (auto pdep : active_deps)
             {
                 const auto& dep = *pdep;
@@ -1899,7 +2059,7 @@ namespace vcpkg::Dependencies
                     const auto& supports_expr = p_vnode->scfl->source_control_file->core_paragraph->supports_expression;
                     if (!supports_expr.is_empty())
                     {
-                        if (!supports_expr.evaluate(m_var_provider.get_or_load_dep_info_vars(spec, m_host_triplet)))
+                        if (!supports_expr.evaluate(evaluation_context(spec)))
                         {
                             const auto msg = Strings::concat(
                                 spec, "@", new_ver, " is only supported on '", to_string(supports_expr), "'\n");
@@ -1925,7 +2085,7 @@ namespace vcpkg::Dependencies
                     const auto& supports_expr = feature.get()->supports_expression;
                     if (!supports_expr.is_empty())
                     {
-                        if (!supports_expr.evaluate(m_var_provider.get_or_load_dep_info_vars(spec, m_host_triplet)))
+                        if (!supports_expr.evaluate(evaluation_context(spec)))
                         {
                             const auto msg = Strings::concat(spec,
                                                              "@",
@@ -1964,8 +2124,6 @@ namespace vcpkg::Dependencies
                     }
 
                     // -> Add stack frame
-                    auto maybe_vars = m_var_provider.get_dep_info_vars(spec);
-
                     InstallPlanAction ipa(spec,
                                           *p_vnode->scfl,
                                           node.user_requested ? RequestType::USER_REQUESTED
@@ -1975,21 +2133,16 @@ namespace vcpkg::Dependencies
                     std::vector<DepSpec> deps;
                     for (auto&& f : ipa.feature_list)
                     {
-                        if (auto maybe_deps =
-                                p_vnode->scfl->source_control_file->find_dependencies_for_feature(f).get())
+                        if (auto maybe_deps = active_dependencies(spec, *p_vnode->scfl->source_control_file, f))
                         {
-                            for (auto&& dep : *maybe_deps)
+                            for (auto pdep : *maybe_deps)
                             {
+                                const auto& dep = *pdep;
                                 PackageSpec dep_spec(dep.name,
                                                      dep.host ? m_host_triplet : spec.triplet(),
                                                      dep.host ? nullopt : spec.compile_triplet());
                                 if (dep_spec == spec) continue;
 
-                                if (!dep.platform.is_empty() &&
-                                    !dep.platform.evaluate(maybe_vars.value_or_exit(VCPKG_LINE_INFO)))
-                                {
-                                    continue;
-                                }
                                 auto maybe_cons = dep_to_version(dep.name, dep.constraint);
 
                                 if (auto cons = maybe_cons.get())
@@ -2071,6 +2224,7 @@ namespace vcpkg::Dependencies
                                                         Triplet host_triplet,
                                                         UnsupportedPortAction unsupported_port_action)
     {
+        Tracing::TraceSpan span("plan", "create_versioned_install_plan");
         VersionedPackageGraph vpg(provider, bprovider, oprovider, var_provider, host_triplet);
         for (auto&& o : overrides)
             vpg.add_override(o.name, {o.version, o.port_version});
@@ -1,3 +1,4 @@
+#include <vcpkg/base/removal.h>
 #include <vcpkg/base/stringliteral.h>
 #include <vcpkg/base/system.print.h>
 #include <vcpkg/base/system.process.h>
@@ -559,8 +560,10 @@ namespace vcpkg::Export
                     files.push_back(paths.installed().root() / suffix);
                 }
 
+                // Hard links spare copying every installed file just to archive it; a raw export shares its files
+                // with the installed tree as a result.
                 Install::install_files_and_write_listfile(
-                    fs, paths.installed().triplet_dir(action.spec), files, dirs);
+                    fs, paths.installed().triplet_dir(action.spec), files, dirs, Install::InstallFileMode::HardLink);
             }
         }
 
@@ -616,7 +619,7 @@ With a project open, go to Tools->NuGet Package Manager->Package Manager Console
 
         if (!opts.raw)
         {
-            fs.remove_all(raw_exported_dir_path, VCPKG_LINE_INFO);
+            Removal::remove_all_in_background(fs, raw_exported_dir_path, VCPKG_LINE_INFO);
         }
     }
 
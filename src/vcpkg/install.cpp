@@ -1,8 +1,11 @@
 #include <vcpkg/base/files.h>
 #include <vcpkg/base/hash.h>
 #include <vcpkg/base/messages.h>
+#include <vcpkg/base/parallel-algorithms.h>
+#include <vcpkg/base/removal.h>
 #include <vcpkg/base/system.debug.h>
 #include <vcpkg/base/system.print.h>
+#include <vcpkg/base/tracing.h>
 #include <vcpkg/base/util.h>
 
 #include <vcpkg/binarycaching.h>
@@ -57,9 +60,11 @@ namespace vcpkg::Install
     void install_files_and_write_listfile(Filesystem& fs,
                                           const Path& source_dir,
                                           const std::vector<Path>& files,
-                                          const InstallDir& destination_dir)
+                                          const InstallDir& destination_dir,
+                                          InstallFileMode mode)
     {
         std::vector<std::string> output;
+        std::vector<std::pair<const Path*, Path>> regular_files;
         std::error_code ec;
 
         const size_t prefix_length = source_dir.native().size();
@@ -92,7 +97,7 @@ namespace vcpkg::Install
             }
 
             const auto suffix = file.generic_u8string().substr(prefix_length + 1);
-            const auto target = destination / suffix;
+            auto target = destination / suffix;
 
             auto this_output = Strings::concat(destination_subdirectory, "/", suffix);
             switch (status)
@@ -115,14 +120,14 @@ namespace vcpkg::Install
                     if (fs.exists(target, IgnoreErrors{}))
                     {
                         print2(Color::warning, "File ", target, " was already present and will be overwritten\n");
+                        if (mode == InstallFileMode::HardLink)
+                        {
+                            // links can't overwrite
+                            fs.remove(target, IgnoreErrors{});
+                        }
                     }
 
-                    fs.copy_file(file, target, CopyOptions::overwrite_existing, ec);
-                    if (ec)
-                    {
-                        vcpkg::printf(Color::error, "failed: %s: %s\n", target, ec.message());
-                    }
-
+                    regular_files.emplace_back(&file, std::move(target));
                     output.push_back(std::move(this_output));
                     break;
                 }
@@ -147,6 +152,27 @@ namespace vcpkg::Install
             }
         }
 
+        parallel_for_each_n(
+            regular_files.begin(), regular_files.size(), [&](const std::pair<const Path*, Path>& regular_file) {
+                const auto& source = *regular_file.first;
+                const auto& target = regular_file.second;
+                std::error_code file_ec;
+                if (mode == InstallFileMode::HardLink)
+                {
+                    fs.create_hard_link(target, source, file_ec);
+                    if (!file_ec)
+                    {
+                        return;
+                    }
+                }
+
+                fs.copy_file(source, target, CopyOptions::overwrite_existing, file_ec);
+                if (file_ec)
+                {
+                    vcpkg::printf(Color::error, "failed: %s: %s\n", target, file_ec.message());
+                }
+            });
+
         std::sort(output.begin(), output.end());
         fs.write_lines(listfile, output, VCPKG_LINE_INFO);
     }
@@ -201,6 +227,7 @@ namespace vcpkg::Install
 
     InstallResult install_package(const VcpkgPaths& paths, const BinaryControlFile& bcf, StatusParagraphs* status_db)
     {
+        Tracing::TraceSpan span("install", Strings::concat("install ", bcf.core_paragraph.spec));
         auto& fs = paths.get_filesystem();
         const auto& installed = paths.installed();
         const auto package_dir = paths.package_dir(bcf.core_paragraph.spec);
@@ -305,6 +332,42 @@ namespace vcpkg::Install
     using Build::BuildResult;
     using Build::ExtendedBuildResult;
 
+    static ExtendedBuildResult install_built_package(const VcpkgPaths& paths,
+                                                     const InstallPlanAction& action,
+                                                     std::unique_ptr<BinaryControlFile>&& bcf,
+                                                     StatusParagraphs& status_db)
+    {
+        auto& fs = paths.get_filesystem();
+
+        // Build or restore succeeded and `bcf` is populated with the control file.
+        Checks::check_exit(VCPKG_LINE_INFO, bcf != nullptr);
+
+        vcpkg::printf("Installing package %s...\n", action.displayname());
+        const auto install_result = install_package(paths, *bcf, &status_db);
+        BuildResult code;
+        switch (install_result)
+        {
+            case InstallResult::SUCCESS: code = BuildResult::SUCCEEDED; break;
+            case InstallResult::FILE_CONFLICTS: code = BuildResult::FILE_CONFLICTS; break;
+            default: Checks::unreachable(VCPKG_LINE_INFO);
+        }
+
+        if (action.build_options.clean_packages == Build::CleanPackages::YES)
+        {
+            Removal::remove_all_in_background(fs, paths.package_dir(action.spec), VCPKG_LINE_INFO);
+        }
+
+        if (action.build_options.clean_downloads == Build::CleanDownloads::YES)
+        {
+            for (auto& p : fs.get_regular_files_non_recursive(paths.downloads, IgnoreErrors{}))
+            {
+                fs.remove(p, VCPKG_LINE_INFO);
+            }
+        }
+
+        return {code, std::move(bcf)};
+    }
+
     static ExtendedBuildResult perform_install_plan_action(const VcpkgCmdArguments& args,
                                                            const VcpkgPaths& paths,
                                                            InstallPlanAction& action,
@@ -366,43 +429,177 @@ namespace vcpkg::Install
 
                 bcf = std::move(result.binary_control_file);
             }
-            // Build or restore succeeded and `bcf` is populated with the control file.
-            Checks::check_exit(VCPKG_LINE_INFO, bcf != nullptr);
 
-            vcpkg::printf("Installing package %s...\n", display_name_with_features);
-            const auto install_result = install_package(paths, *bcf, &status_db);
-            BuildResult code;
-            switch (install_result)
+            return install_built_package(paths, action, std::move(bcf), status_db);
+        }
+
+        if (plan_type == InstallPlanType::EXCLUDED)
+        {
+            vcpkg::printf(Color::warning, "Package %s is excluded\n", display_name);
+            return BuildResult::EXCLUDED;
+        }
+
+        Checks::unreachable(VCPKG_LINE_INFO);
+    }
+
+    // Installs the compile triplet variants of one port. The variants that can't be restored from the binary cache are
+    // built concurrently; restoring and installing stay serial because they update shared state.
+    // Stores the time spent on each variant to `timings`.
+    static std::vector<ExtendedBuildResult> perform_install_plan_variants(const VcpkgCmdArguments& args,
+                                                                          const VcpkgPaths& paths,
+                                                                          View<InstallPlanAction*> variants,
+                                                                          StatusParagraphs& status_db,
+                                                                          BinaryCache& binary_cache,
+                                                                          const Build::IBuildLogsRecorder& recorder,
+                                                                          std::vector<ElapsedTime>& timings)
+    {
+        auto& fs = paths.get_filesystem();
+        std::vector<ExtendedBuildResult> results;
+        results.reserve(variants.size());
+        std::vector<ElapsedTime::duration> elapsed(variants.size());
+        std::vector<size_t> to_build;
+        for (size_t idx = 0; idx < variants.size(); ++idx)
+        {
+            auto variant = variants[idx];
+            const auto restore_timer = ElapsedTimer::create_started();
+            if (binary_cache.try_restore(*variant) == RestoreResult::restored)
             {
-                case InstallResult::SUCCESS: code = BuildResult::SUCCEEDED; break;
-                case InstallResult::FILE_CONFLICTS: code = BuildResult::FILE_CONFLICTS; break;
-                default: Checks::unreachable(VCPKG_LINE_INFO);
+                auto maybe_bcf =
+                    Paragraphs::try_load_cached_package(fs, paths.package_dir(variant->spec), variant->spec);
+                results.emplace_back(BuildResult::SUCCEEDED,
+                                     std::make_unique<BinaryControlFile>(
+                                         std::move(maybe_bcf).value_or_exit(VCPKG_LINE_INFO)));
             }
+            else if (variant->build_options.build_missing == Build::BuildMissing::NO)
+            {
+                results.emplace_back(BuildResult::CACHE_MISSING);
+            }
+            else
+            {
+                vcpkg::printf("Building package %s...\n", variant->displayname());
+                to_build.push_back(idx);
+                results.emplace_back(BuildResult::NULLVALUE);
+            }
+
+            elapsed[idx] = restore_timer.elapsed().as<ElapsedTime::duration>();
+        }
+
+        std::vector<ElapsedTime> build_timings;
+        auto built = Build::build_package_variants(
+            args,
+            paths,
+            Util::fmap(to_build, [&](size_t idx) -> const InstallPlanAction* { return variants[idx]; }),
+            binary_cache,
+            recorder,
+            status_db,
+            build_timings);
+        for (size_t i = 0; i < to_build.size(); ++i)
+        {
+            results[to_build[i]] = std::move(built[i]);
+            elapsed[to_build[i]] += build_timings[i].as<ElapsedTime::duration>();
+        }
 
-            if (action.build_options.clean_packages == Build::CleanPackages::YES)
+        for (size_t idx = 0; idx < variants.size(); ++idx)
+        {
+            auto& variant = *variants[idx];
+            auto& result = results[idx];
+            if (result.code == BuildResult::DOWNLOADED)
+            {
+                print2(Color::success, "Downloaded sources for package ", variant.displayname(), "\n");
+            }
+            else if (result.code != BuildResult::SUCCEEDED)
+            {
+                print2(Color::error, Build::create_error_message(result.code, variant.spec), "\n");
+            }
+            else
             {
-                fs.remove_all(paths.package_dir(action.spec), VCPKG_LINE_INFO);
+                const auto install_timer = ElapsedTimer::create_started();
+                result = install_built_package(paths, variant, std::move(result.binary_control_file), status_db);
+                elapsed[idx] += install_timer.elapsed().as<ElapsedTime::duration>();
             }
+        }
+
+        timings = Util::fmap(elapsed, [](ElapsedTime::duration d) { return ElapsedTime(d); });
+        return results;
+    }
 
-            if (action.build_options.clean_downloads == Build::CleanDownloads::YES)
+    std::vector<std::vector<InstallPlanAction*>> batch_install_actions(std::vector<InstallPlanAction>& actions)
+    {
+        const auto variant_key = [](const InstallPlanAction& action) -> Optional<std::pair<std::string, Triplet>> {
+            if (action.plan_type != InstallPlanType::BUILD_AND_INSTALL || !action.spec.compile_triplet())
             {
-                std::error_code ec;
-                for (auto& p : fs.get_regular_files_non_recursive(paths.downloads, IgnoreErrors{}))
+                return nullopt;
+            }
+
+            return std::make_pair(action.spec.name(), action.spec.triplet());
+        };
+
+        std::vector<std::vector<InstallPlanAction*>> batches;
+        std::set<std::pair<std::string, Triplet>> variant_keys;
+        bool has_variants = false;
+        for (auto&& action : actions)
+        {
+            if (auto key = variant_key(action).get())
+            {
+                has_variants |= !variant_keys.insert(*key).second;
+            }
+        }
+
+        if (!has_variants)
+        {
+            for (auto&& action : actions)
+            {
+                batches.push_back({&action});
+            }
+
+            return batches;
+        }
+
+        // the plan is topologically sorted, so every dependency's depth is known before it is needed
+        std::unordered_map<PackageSpec, size_t> depths;
+        std::vector<std::vector<InstallPlanAction*>> actions_by_depth;
+        for (auto&& action : actions)
+        {
+            size_t depth = 0;
+            for (auto&& dependency : action.package_dependencies)
+            {
+                auto it = depths.find(dependency);
+                if (dependency != action.spec && it != depths.end())
                 {
-                    fs.remove(p, VCPKG_LINE_INFO);
+                    depth = std::max(depth, it->second + 1);
                 }
             }
 
-            return {code, std::move(bcf)};
+            depths.emplace(action.spec, depth);
+            if (actions_by_depth.size() <= depth)
+            {
+                actions_by_depth.resize(depth + 1);
+            }
+
+            actions_by_depth[depth].push_back(&action);
         }
 
-        if (plan_type == InstallPlanType::EXCLUDED)
+        for (auto&& same_depth : actions_by_depth)
         {
-            vcpkg::printf(Color::warning, "Package %s is excluded\n", display_name);
-            return BuildResult::EXCLUDED;
+            std::map<std::pair<std::string, Triplet>, size_t> variant_batches;
+            for (auto action : same_depth)
+            {
+                auto maybe_key = variant_key(*action);
+                if (auto key = maybe_key.get())
+                {
+                    auto it = variant_batches.emplace(std::move(*key), batches.size()).first;
+                    if (it->second != batches.size())
+                    {
+                        batches[it->second].push_back(action);
+                        continue;
+                    }
+                }
+
+                batches.push_back({action});
+            }
         }
 
-        Checks::unreachable(VCPKG_LINE_INFO);
+        return batches;
     }
 
     void InstallSummary::print() const
@@ -432,10 +629,17 @@ namespace vcpkg::Install
         }
     }
 
+    DECLARE_AND_REGISTER_MESSAGE(ElapsedTimeForPackage,
+                                 (msg::value, msg::elapsed),
+                                 "",
+                                 "Elapsed time for package {value}: {elapsed}");
+
     struct TrackedPackageInstallGuard
     {
         SpecSummary* current_summary = nullptr;
         ElapsedTimer build_timer = ElapsedTimer::create_started();
+        // Replaces the guard's own timer, for packages that are timed apart from the others built with them.
+        Optional<ElapsedTime> measured_time;
 
         TrackedPackageInstallGuard(const size_t action_index,
                                    const size_t action_count,
@@ -449,15 +653,21 @@ namespace vcpkg::Install
 
         ~TrackedPackageInstallGuard()
         {
-            current_summary->timing = build_timer.elapsed();
-            vcpkg::printf(
-                "Elapsed time for package %s: %s\n", current_summary->spec.to_string(), current_summary->timing);
+            current_summary->timing = measured_time.value_or(build_timer.elapsed());
+            msg::println(msgElapsedTimeForPackage,
+                         msg::value = current_summary->spec.to_string(),
+                         msg::elapsed = current_summary->timing.to_string());
         }
 
         TrackedPackageInstallGuard(const TrackedPackageInstallGuard&) = delete;
         TrackedPackageInstallGuard& operator=(const TrackedPackageInstallGuard&) = delete;
     };
 
+    DECLARE_AND_REGISTER_MESSAGE(RemovedPackages,
+                                 (msg::value, msg::elapsed),
+                                 "",
+                                 "Removed {value} packages in {elapsed}.");
+
     InstallSummary perform(const VcpkgCmdArguments& args,
                            ActionPlan& action_plan,
                            const KeepGoing keep_going,
@@ -471,10 +681,23 @@ namespace vcpkg::Install
         const size_t action_count = action_plan.remove_actions.size() + action_plan.install_actions.size();
         size_t action_index = 1;
 
-        for (auto&& action : action_plan.remove_actions)
+        if (!action_plan.remove_actions.empty())
         {
-            TrackedPackageInstallGuard this_install(action_index++, action_count, results, action.spec);
-            Remove::perform_remove_plan_action(paths, action, Remove::Purge::YES, &status_db);
+            // Packages being rebuilt are removed as one batch so their files are deleted concurrently and the status
+            // database is updated once.
+            const auto remove_timer = ElapsedTimer::create_started();
+            const auto remove_timings =
+                Remove::perform_remove_plan(paths, action_plan.remove_actions, Remove::Purge::YES, &status_db);
+            for (size_t i = 0; i < action_plan.remove_actions.size(); ++i)
+            {
+                results.emplace_back(action_plan.remove_actions[i].spec, nullptr);
+                results.back().timing = remove_timings[i];
+            }
+
+            action_index += action_plan.remove_actions.size();
+            msg::println(msgRemovedPackages,
+                         msg::value = action_plan.remove_actions.size(),
+                         msg::elapsed = remove_timer.elapsed().to_string());
         }
 
         for (auto&& action : action_plan.already_installed)
@@ -486,19 +709,52 @@ namespace vcpkg::Install
 
         Build::compute_all_abis(paths, action_plan, var_provider, status_db);
         binary_cache.prefetch(action_plan.install_actions);
-        for (auto&& action : action_plan.install_actions)
+        for (auto&& batch : batch_install_actions(action_plan.install_actions))
         {
-            TrackedPackageInstallGuard this_install(action_index++, action_count, results, action.spec);
-            auto result =
-                perform_install_plan_action(args, paths, action, status_db, binary_cache, build_logs_recorder);
-            if (result.code != BuildResult::SUCCEEDED && keep_going == KeepGoing::NO)
+            if (batch.size() == 1)
             {
-                print2(Build::create_user_troubleshooting_message(action, paths), '\n');
-                Checks::exit_fail(VCPKG_LINE_INFO);
+                auto& action = *batch[0];
+                TrackedPackageInstallGuard this_install(action_index++, action_count, results, action.spec);
+                auto result =
+                    perform_install_plan_action(args, paths, action, status_db, binary_cache, build_logs_recorder);
+                if (result.code != BuildResult::SUCCEEDED && keep_going == KeepGoing::NO)
+                {
+                    print2(Build::create_user_troubleshooting_message(action, paths), '\n');
+                    Checks::exit_fail(VCPKG_LINE_INFO);
+                }
+
+                this_install.current_summary->action = &action;
+                this_install.current_summary->build_result = std::move(result);
+                continue;
+            }
+
+            // the guards keep pointers into results, so it must not reallocate while they are alive
+            results.reserve(results.size() + batch.size());
+            std::vector<std::unique_ptr<TrackedPackageInstallGuard>> variant_installs;
+            for (auto action : batch)
+            {
+                variant_installs.push_back(
+                    std::make_unique<TrackedPackageInstallGuard>(action_index++, action_count, results, action->spec));
             }
 
-            this_install.current_summary->action = &action;
-            this_install.current_summary->build_result = std::move(result);
+            std::vector<ElapsedTime> batch_timings;
+            auto batch_results = perform_install_plan_variants(
+                args, paths, batch, status_db, binary_cache, build_logs_recorder, batch_timings);
+            for (size_t i = 0; i < batch.size(); ++i)
+            {
+                auto& action = *batch[i];
+                auto& this_install = *variant_installs[i];
+                this_install.measured_time = batch_timings[i];
+                if (batch_results[i].code != BuildResult::SUCCEEDED && keep_going == KeepGoing::NO)
+                {
+                    print2(Build::create_user_troubleshooting_message(action, paths), '\n');
+                    Checks::exit_fail(VCPKG_LINE_INFO);
+                }
+
+                this_install.current_summary->action = &action;
+                this_install.current_summary->build_result = std::move(batch_results[i]);
+                variant_installs[i].reset();
+            }
         }
 
         return InstallSummary{std::move(results)};
@@ -524,6 +780,7 @@ namespace vcpkg::Install
     static constexpr StringLiteral OPTION_PROHIBIT_BACKCOMPAT_FEATURES = "x-prohibit-backcompat-features";
     static constexpr StringLiteral OPTION_ENFORCE_PORT_CHECKS = "enforce-port-checks";
     static constexpr StringLiteral OPTION_ALLOW_UNSUPPORTED_PORT = "allow-unsupported";
+    static constexpr StringLiteral OPTION_COMPILE_TRIPLETS = "x-compile-triplets";
 
     static constexpr std::array<CommandSwitch, 17> INSTALL_SWITCHES = {{
         {OPTION_DRY_RUN, "Do not actually build or install"},
@@ -550,11 +807,14 @@ namespace vcpkg::Install
         {OPTION_ALLOW_UNSUPPORTED_PORT, "Instead of erroring on an unsupported port, continue with a warning."},
     }};
 
-    static constexpr std::array<CommandSetting, 2> INSTALL_SETTINGS = {{
+    static constexpr std::array<CommandSetting, 3> INSTALL_SETTINGS = {{
         {OPTION_XUNIT, ""}, // internal use
         {OPTION_WRITE_PACKAGES_CONFIG,
          "Writes out a NuGet packages.config-formatted file for use with external binary caching.\nSee `vcpkg help "
          "binarycaching` for more information."},
+        {OPTION_COMPILE_TRIPLETS,
+         "Comma-separated compile triplets to install each package on the command line with; the variants of a port "
+         "are built concurrently (classic mode)"},
     }};
 
     static constexpr std::array<CommandMultiSetting, 1> INSTALL_MULTISETTINGS = {{
@@ -853,6 +1113,13 @@ namespace vcpkg::Install
                              msg::value = Strings::concat("--", OPTION_EDITABLE));
                 failure = true;
             }
+            if (Util::Sets::contains(options.settings, OPTION_COMPILE_TRIPLETS))
+            {
+                msg::println(Color::error,
+                             msgErrorInvalidManifestModeOption,
+                             msg::value = Strings::concat("--", OPTION_COMPILE_TRIPLETS));
+                failure = true;
+            }
             if (failure)
             {
                 msg::println(msgUsingManifestAt, msg::path = paths.get_manifest_path().value_or_exit(VCPKG_LINE_INFO));
@@ -1054,11 +1321,36 @@ namespace vcpkg::Install
 
         PortFileProvider::PathsPortFileProvider provider(paths, args.overlay_ports);
 
-        const std::vector<FullPackageSpec> specs = Util::fmap(args.command_arguments, [&](auto&& arg) {
+        std::vector<FullPackageSpec> specs = Util::fmap(args.command_arguments, [&](auto&& arg) {
             return Input::check_and_get_full_package_spec(
                 std::string(arg), default_triplet, default_compile_triplet, COMMAND_STRUCTURE.example_text, paths);
         });
 
+        auto compile_triplets_it = options.settings.find(OPTION_COMPILE_TRIPLETS);
+        if (compile_triplets_it != options.settings.end())
+        {
+            Checks::check_exit(VCPKG_LINE_INFO,
+                               args.bin2sth_enabled(),
+                               "Error: --%s requires bin2sth mode",
+                               OPTION_COMPILE_TRIPLETS);
+            const auto compile_triplet_names = Strings::split(compile_triplets_it->second, ',');
+            std::vector<FullPackageSpec> variants;
+            for (auto&& spec : specs)
+            {
+                for (auto&& name : compile_triplet_names)
+                {
+                    const Triplet triplet = spec.package_spec.triplet();
+                    auto compile_triplet = bin2sth::CompileTriplet::from_canonical_name(name, triplet);
+                    Checks::check_exit(
+                        VCPKG_LINE_INFO, compile_triplet.has_value(), "Error: invalid compile triplet %s", name);
+                    variants.emplace_back(PackageSpec(spec.package_spec.name(), triplet, compile_triplet),
+                                          spec.features);
+                }
+            }
+
+            specs = std::move(variants);
+        }
+
         // create the plan
         print2("Computing installation plan...\n");
         StatusParagraphs status_db = database_load_check(fs, paths.installed());
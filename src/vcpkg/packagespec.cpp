@@ -30,31 +30,35 @@ namespace vcpkg
         }
     }
 
-    const std::string& PackageSpec::name() const { return this->m_name; }
-
-    Optional<bin2sth::CompileTriplet> const& PackageSpec::compile_triplet() const { return this->m_compile_triplet; }
-
-    Triplet PackageSpec::triplet() const { return this->m_triplet; }
-
     std::string PackageSpec::qualifier() const
     {
         std::string qualifier = this->triplet().canonical_name();
-        if (auto const p_compile_triplet = this->m_compile_triplet.get())
+        if (auto const p_compile_triplet = this->compile_triplet().get())
         {
             qualifier.append(SEP_TRIPLET_COMPILE_TRIPLET).append(p_compile_triplet->canonical_name());
         }
         return qualifier;
     }
 
-    std::string PackageSpec::dir() const { return Strings::format("%s_%s", this->m_name, this->qualifier()); }
+    std::string PackageSpec::dir() const { return Strings::format("%s_%s", this->name(), this->qualifier()); }
 
     std::string PackageSpec::to_string() const { return Strings::format("%s:%s", this->name(), this->qualifier()); }
     void PackageSpec::to_string(std::string& s) const { Strings::append(s, this->name(), ':', this->qualifier()); }
 
-    bool operator==(const PackageSpec& left, const PackageSpec& right)
+    size_t PackageSpec::hash_code() const
     {
-        return left.name() == right.name() && left.triplet() == right.triplet() &&
-               left.compile_triplet() == right.compile_triplet();
+        size_t hash = 17;
+        hash = hash * 31 + m_name.hash_code();
+        hash = hash * 31 + m_triplet.hash_code();
+        if (auto const p_compile_triplet = this->compile_triplet().get())
+        {
+            hash = hash * 31 + p_compile_triplet->hash_code();
+        }
+        else
+        {
+            hash = hash * 31;
+        }
+        return hash;
     }
 
     DECLARE_AND_REGISTER_MESSAGE(IllegalPlatformSpec,
@@ -336,7 +340,7 @@ namespace vcpkg
                                              Optional<bin2sth::CompileTriplet> compile_triplet,
                                              ImplicitDefault id) const
     {
-        return FullPackageSpec{{name, host ? host_triplet : target, host ? compile_triplet : nullopt},
+        return FullPackageSpec{{name, host ? host_triplet : target, host ? nullopt : compile_triplet},
                                normalize_feature_list(features, id)};
     }
 
@@ -77,6 +77,88 @@ namespace vcpkg::Parse
         return nullptr;
     }
 
+    std::string ParagraphFieldView::value() const
+    {
+        std::string result;
+        result.reserve(raw_value.size());
+        for (auto it = raw_value.begin(); it != raw_value.end(); ++it)
+        {
+            if (*it != '\r')
+            {
+                result.push_back(*it);
+            }
+            else if (it + 1 == raw_value.end() || it[1] != '\n')
+            {
+                result.push_back('\n');
+            }
+        }
+
+        return result;
+    }
+
+    std::vector<ParagraphFieldView> to_field_views(const Paragraph& fields)
+    {
+        return Util::fmap(fields, [](const auto& field) {
+            return ParagraphFieldView{field.first, field.second.first};
+        });
+    }
+
+    const ParagraphFieldView* ParagraphViewParser::find_field(StringView fieldname)
+    {
+        for (size_t i = 0; i < fields.size(); ++i)
+        {
+            if (!used[i] && fields[i].name == fieldname)
+            {
+                used[i] = true;
+                return &fields[i];
+            }
+        }
+
+        return nullptr;
+    }
+
+    void ParagraphViewParser::required_field(StringView fieldname, std::string& out)
+    {
+        if (auto field = find_field(fieldname))
+            out = field->value();
+        else
+            missing_fields.push_back(fieldname.to_string());
+    }
+    std::string ParagraphViewParser::required_field(StringView fieldname)
+    {
+        std::string out;
+        required_field(fieldname, out);
+        return out;
+    }
+    std::string ParagraphViewParser::optional_field(StringView fieldname)
+    {
+        if (auto field = find_field(fieldname)) return field->value();
+        return std::string();
+    }
+
+    std::unique_ptr<ParseControlErrorInfo> ParagraphViewParser::error_info(StringView name) const
+    {
+        std::vector<std::string> extra_fields;
+        for (size_t i = 0; i < fields.size(); ++i)
+        {
+            if (!used[i])
+            {
+                extra_fields.push_back(fields[i].name.to_string());
+            }
+        }
+
+        if (!extra_fields.empty() || !missing_fields.empty())
+        {
+            auto err = std::make_unique<ParseControlErrorInfo>();
+            err->name = name.to_string();
+            err->extra_fields["CONTROL"] = std::move(extra_fields);
+            err->missing_fields["CONTROL"] = missing_fields;
+            err->expected_types = expected_types;
+            return err;
+        }
+        return nullptr;
+    }
+
     template<class T, class F>
     static Optional<std::vector<T>> parse_list_until_eof(StringLiteral plural_item_name, Parse::ParserBase& parser, F f)
     {
@@ -216,6 +298,146 @@ namespace vcpkg::Paragraphs
         }
     };
 
+    // Whether each code point of `text` is decoded by Utf8Decoder without an error or a surrogate, which would make
+    // PghParser stop early.
+    static bool is_plain_utf8(StringView text)
+    {
+        if (std::all_of(text.begin(), text.end(), [](char ch) { return static_cast<unsigned char>(ch) < 0x80; }))
+        {
+            return true;
+        }
+
+        const char* it = text.begin();
+        while (it != text.end())
+        {
+            char32_t code_point;
+            auto decoded = Unicode::utf8_decode_code_point(it, text.end(), code_point);
+            if (decoded.second != Unicode::utf8_errc::NoError || Unicode::utf16_is_surrogate_code_point(code_point))
+            {
+                return false;
+            }
+
+            it = decoded.first;
+        }
+
+        return true;
+    }
+
+    static constexpr bool is_lineend_byte(char ch) { return ch == '\r' || ch == '\n'; }
+    static constexpr bool is_tab_or_space_byte(char ch) { return ch == ' ' || ch == '\t'; }
+    static constexpr bool is_whitespace_byte(char ch) { return is_tab_or_space_byte(ch) || is_lineend_byte(ch); }
+    static constexpr bool is_alphanumdash_byte(char ch) { return Parse::ParserBase::is_alphanumdash(ch); }
+
+    ParagraphTokenizer::ParagraphTokenizer(StringView text, StringView origin)
+        : m_text(text), m_origin(origin), m_it(text.begin())
+    {
+        if (!is_plain_utf8(text))
+        {
+            // let PghParser deal with the encoding, exactly as parse_paragraphs would
+            auto pghs = PghParser(text, origin).get_paragraphs();
+            if (auto p = pghs.get())
+            {
+                m_decoded_paragraphs = std::move(*p);
+            }
+            else
+            {
+                m_error = std::move(pghs).error();
+            }
+
+            return;
+        }
+
+        while (m_it != m_text.end() && is_whitespace_byte(*m_it))
+        {
+            ++m_it;
+        }
+    }
+
+    bool ParagraphTokenizer::next(std::vector<Parse::ParagraphFieldView>& fields)
+    {
+        fields.clear();
+        if (!m_error.empty())
+        {
+            return false;
+        }
+
+        if (auto decoded_paragraphs = m_decoded_paragraphs.get())
+        {
+            if (m_next_decoded_paragraph == decoded_paragraphs->size())
+            {
+                return false;
+            }
+
+            fields = Parse::to_field_views((*decoded_paragraphs)[m_next_decoded_paragraph++]);
+            return true;
+        }
+
+        const char* const end = m_text.end();
+        const char* it = m_it;
+        if (it == end)
+        {
+            return false;
+        }
+
+        // mirrors PghParser::get_paragraph; see set_error()
+        do
+        {
+            if (*it == '#')
+            {
+                it = std::find_if(it, end, is_lineend_byte);
+                if (it != end && *it == '\r') ++it;
+                if (it != end && *it == '\n') ++it;
+                continue;
+            }
+
+            const char* const name_first = it;
+            it = std::find_if_not(it, end, is_alphanumdash_byte);
+            const StringView name{name_first, it};
+            if (name.empty() || it == end || *it != ':' ||
+                Util::any_of(fields, [name](const Parse::ParagraphFieldView& field) { return field.name == name; }))
+            {
+                return set_error();
+            }
+
+            it = std::find_if_not(it + 1, end, is_tab_or_space_byte);
+            const char* const value_first = it;
+            const char* value_last;
+            for (;;)
+            {
+                it = std::find_if(it, end, is_lineend_byte);
+                value_last = it;
+                if (it != end && *it == '\r') ++it;
+                if (it != end && *it == '\n') ++it;
+                if (it == end || *it != ' ')
+                {
+                    break;
+                }
+
+                it = std::find_if_not(it, end, is_tab_or_space_byte);
+                if (it == end || is_lineend_byte(*it))
+                {
+                    return set_error();
+                }
+            }
+
+            fields.push_back({name, StringView{value_first, value_last}});
+        } while (it != end && !is_lineend_byte(*it));
+
+        m_it = std::find_if_not(it, end, is_lineend_byte);
+        return true;
+    }
+
+    bool ParagraphTokenizer::set_error()
+    {
+        // Finding the row and column of the problem requires decoding the text up to it, so this is only done here,
+        // by PghParser, which accepts exactly the same text.
+        auto pghs = PghParser(m_text, m_origin).get_paragraphs();
+        Checks::check_exit(
+            VCPKG_LINE_INFO, !pghs.has_value(), "PghParser accepted a paragraph that ParagraphTokenizer did not");
+        m_error = std::move(pghs).error();
+        return false;
+    }
+
     ExpectedS<Paragraph> parse_single_paragraph(StringView str, StringView origin)
     {
         auto pghs = PghParser(str, origin).get_paragraphs();
@@ -271,7 +493,9 @@ namespace vcpkg::Paragraphs
                fs.exists(maybe_directory / "vcpkg.json", IgnoreErrors{});
     }
 
-    static ParseExpected<SourceControlFile> try_load_manifest_text(const std::string& text, StringView origin)
+    // Port is either SourceControlFile or PortIdentity
+    template<class Port>
+    static ParseExpected<Port> try_load_manifest_text(const std::string& text, StringView origin)
     {
         auto res = Json::parse(text);
 
@@ -280,7 +504,7 @@ namespace vcpkg::Paragraphs
         {
             if (val->first.is_object())
             {
-                return SourceControlFile::parse_manifest_object(origin, val->first.object());
+                return Port::parse_manifest_object(origin, val->first.object());
             }
 
             error = "Manifest files must have a top-level object";
@@ -295,19 +519,20 @@ namespace vcpkg::Paragraphs
         return error_info;
     }
 
-    ParseExpected<SourceControlFile> try_load_port_text(const std::string& text, StringView origin, bool is_manifest)
+    template<class Port>
+    static ParseExpected<Port> try_load_port_text_as(const std::string& text, StringView origin, bool is_manifest)
     {
         StatsTimer timer(g_load_ports_stats);
 
         if (is_manifest)
         {
-            return try_load_manifest_text(text, origin);
+            return try_load_manifest_text<Port>(text, origin);
         }
 
         ExpectedS<std::vector<Paragraph>> pghs = get_paragraphs_text(text, origin);
         if (auto vector_pghs = pghs.get())
         {
-            return SourceControlFile::parse_control_file(origin, std::move(*vector_pghs));
+            return Port::parse_control_file(origin, std::move(*vector_pghs));
         }
         auto error_info = std::make_unique<ParseControlErrorInfo>();
         error_info->name = origin.to_string();
@@ -315,7 +540,8 @@ namespace vcpkg::Paragraphs
         return error_info;
     }
 
-    ParseExpected<SourceControlFile> try_load_port(const Filesystem& fs, const Path& port_directory)
+    template<class Port>
+    static ParseExpected<Port> try_load_port_as(const Filesystem& fs, const Path& port_directory)
     {
         StatsTimer timer(g_load_ports_stats);
 
@@ -342,7 +568,7 @@ namespace vcpkg::Paragraphs
                                       "Found both manifest and CONTROL file in port %s; please rename one or the other",
                                       port_directory);
 
-            return try_load_manifest_text(manifest_contents, manifest_path);
+            return try_load_manifest_text<Port>(manifest_contents, manifest_path);
         }
 
         if (fs.exists(control_path, IgnoreErrors{}))
@@ -350,7 +576,7 @@ namespace vcpkg::Paragraphs
             ExpectedS<std::vector<Paragraph>> pghs = get_paragraphs(fs, control_path);
             if (auto vector_pghs = pghs.get())
             {
-                return SourceControlFile::parse_control_file(control_path, std::move(*vector_pghs));
+                return Port::parse_control_file(control_path, std::move(*vector_pghs));
             }
             auto error_info = std::make_unique<ParseControlErrorInfo>();
             error_info->name = port_name;
@@ -372,43 +598,77 @@ namespace vcpkg::Paragraphs
         return error_info;
     }
 
+    ParseExpected<SourceControlFile> try_load_port_text(const std::string& text, StringView origin, bool is_manifest)
+    {
+        return try_load_port_text_as<SourceControlFile>(text, origin, is_manifest);
+    }
+
+    ParseExpected<SourceControlFile> try_load_port(const Filesystem& fs, const Path& port_directory)
+    {
+        return try_load_port_as<SourceControlFile>(fs, port_directory);
+    }
+
+    ParseExpected<PortIdentity> try_load_port_identity_text(const std::string& text,
+                                                            StringView origin,
+                                                            bool is_manifest)
+    {
+        return try_load_port_text_as<PortIdentity>(text, origin, is_manifest);
+    }
+
+    ParseExpected<PortIdentity> try_load_port_identity(const Filesystem& fs, const Path& port_directory)
+    {
+        return try_load_port_as<PortIdentity>(fs, port_directory);
+    }
+
     ExpectedS<BinaryControlFile> try_load_cached_package(const Filesystem& fs,
                                                          const Path& package_dir,
                                                          const PackageSpec& spec)
     {
         StatsTimer timer(g_load_ports_stats);
 
-        ExpectedS<std::vector<Paragraph>> pghs = get_paragraphs(fs, package_dir / "CONTROL");
+        const auto control_path = package_dir / "CONTROL";
+        std::error_code ec;
+        const std::string contents = fs.read_contents(control_path, ec);
+        if (ec)
+        {
+            return ec.message();
+        }
 
-        if (auto p = pghs.get())
+        ParagraphTokenizer tokenizer(contents, control_path);
+        std::vector<Parse::ParagraphFieldView> fields;
+        if (!tokenizer.next(fields))
         {
-            BinaryControlFile bcf;
-            bcf.core_paragraph = BinaryParagraph(p->front());
-            p->erase(p->begin());
+            if (auto error = tokenizer.error()) return *error;
+            return Strings::concat("Missing package paragraph in ", control_path);
+        }
 
-            bcf.features =
-                Util::fmap(*p, [&](auto&& raw_feature) -> BinaryParagraph { return BinaryParagraph(raw_feature); });
+        BinaryControlFile bcf;
+        bcf.core_paragraph = BinaryParagraph(fields);
+        while (tokenizer.next(fields))
+        {
+            bcf.features.emplace_back(fields);
+        }
 
-            if (bcf.core_paragraph.spec != spec)
-            {
-                return Strings::concat("Mismatched spec in package at ",
-                                       package_dir,
-                                       ": expected ",
-                                       spec,
-                                       ", actual ",
-                                       bcf.core_paragraph.spec);
-            }
+        if (auto error = tokenizer.error())
+        {
+            return *error;
+        }
 
-            return bcf;
+        if (bcf.core_paragraph.spec != spec)
+        {
+            return Strings::concat("Mismatched spec in package at ",
+                                   package_dir,
+                                   ": expected ",
+                                   spec,
+                                   ", actual ",
+                                   bcf.core_paragraph.spec);
         }
 
-        return pghs.error();
+        return bcf;
     }
 
-    LoadResults try_load_all_registry_ports(const Filesystem& fs, const RegistrySet& registries)
+    std::vector<Path> get_all_registry_port_directories(const RegistrySet& registries)
     {
-        LoadResults ret;
-
         std::vector<std::string> ports;
 
         for (const auto& registry : registries.registries())
@@ -423,6 +683,7 @@ namespace vcpkg::Paragraphs
 
         Util::sort_unique_erase(ports);
 
+        std::vector<Path> port_directories;
         for (const auto& port_name : ports)
         {
             auto impl = registries.registry_for_port(port_name);
@@ -436,15 +697,7 @@ namespace vcpkg::Paragraphs
 
             if (auto p = impl->get_path_to_baseline_version(port_name))
             {
-                auto maybe_spgh = try_load_port(fs, *p.get());
-                if (const auto spgh = maybe_spgh.get())
-                {
-                    ret.paragraphs.push_back({std::move(*spgh), std::move(*p.get())});
-                }
-                else
-                {
-                    ret.errors.emplace_back(std::move(maybe_spgh).error());
-                }
+                port_directories.push_back(std::move(*p.get()));
             }
             else
             {
@@ -454,10 +707,29 @@ namespace vcpkg::Paragraphs
             }
         }
 
+        return port_directories;
+    }
+
+    LoadResults try_load_all_registry_ports(const Filesystem& fs, const RegistrySet& registries)
+    {
+        LoadResults ret;
+        for (auto&& port_directory : get_all_registry_port_directories(registries))
+        {
+            auto maybe_spgh = try_load_port(fs, port_directory);
+            if (const auto spgh = maybe_spgh.get())
+            {
+                ret.paragraphs.push_back({std::move(*spgh), std::move(port_directory)});
+            }
+            else
+            {
+                ret.errors.emplace_back(std::move(maybe_spgh).error());
+            }
+        }
+
         return ret;
     }
 
-    static void load_results_print_error(const LoadResults& results)
+    void load_results_print_error(const LoadResults& results)
     {
         if (!results.errors.empty())
         {
@@ -484,17 +756,21 @@ namespace vcpkg::Paragraphs
         return std::move(results.paragraphs);
     }
 
-    std::vector<SourceControlFileAndLocation> load_overlay_ports(const Filesystem& fs, const Path& directory)
+    std::vector<Path> get_overlay_port_directories(const Filesystem& fs, const Path& directory)
     {
-        LoadResults ret;
-
         auto port_dirs = fs.get_directories_non_recursive(directory, VCPKG_LINE_INFO);
         Util::sort(port_dirs);
 
         Util::erase_remove_if(port_dirs,
                               [&](auto&& port_dir_entry) { return port_dir_entry.filename() == ".DS_Store"; });
+        return port_dirs;
+    }
+
+    std::vector<SourceControlFileAndLocation> load_overlay_ports(const Filesystem& fs, const Path& directory)
+    {
+        LoadResults ret;
 
-        for (auto&& path : port_dirs)
+        for (auto&& path : get_overlay_port_directories(fs, directory))
         {
             auto maybe_spgh = try_load_port(fs, path);
             if (const auto spgh = maybe_spgh.get())
@@ -5,6 +5,7 @@
 
 #include <vcpkg/platform-expression.h>
 
+#include <algorithm>
 #include <numeric>
 #include <string>
 #include <vector>
@@ -415,7 +416,7 @@ namespace vcpkg::PlatformExpression
     Expr::Expr(Expr&& other) = default;
     Expr& Expr::operator=(Expr&& other) = default;
 
-    Expr::Expr(const Expr& other)
+    Expr::Expr(const Expr& other) : program_(other.program_), custom_identifiers_(other.custom_identifiers_)
     {
         if (other.underlying_)
         {
@@ -433,10 +434,101 @@ namespace vcpkg::PlatformExpression
             this->underlying_.reset();
         }
 
+        this->program_ = other.program_;
+        this->custom_identifiers_ = other.custom_identifiers_;
         return *this;
     }
 
-    Expr::Expr(std::unique_ptr<ExprImpl>&& e) : underlying_(std::move(e)) { }
+    namespace
+    {
+        enum class Opcode : uint8_t
+        {
+            push_constant,   // operand: 0 or 1
+            push_identifier, // operand: Identifier
+            push_custom,     // operand: index into custom_identifiers_
+            op_not,
+            op_and, // pops two values
+            op_or,  // pops two values
+            invalid,
+        };
+
+        constexpr uint32_t make_instruction(Opcode op, uint32_t operand = 0)
+        {
+            return static_cast<uint32_t>(op) | (operand << 8);
+        }
+
+        constexpr Opcode opcode_of(uint32_t instruction) { return static_cast<Opcode>(instruction & 0xFF); }
+        constexpr uint32_t operand_of(uint32_t instruction) { return instruction >> 8; }
+
+        constexpr uint32_t identifier_bit(Identifier id) { return uint32_t(1) << static_cast<int>(id); }
+        constexpr bool is_native(uint32_t operand) { return operand == static_cast<uint32_t>(Identifier::native); }
+        static_assert(static_cast<int>(Identifier::native) < 32, "identifiers must fit in EvaluationContext");
+
+        struct Compiler
+        {
+            std::vector<uint32_t>& program;
+            std::vector<std::string>& custom_identifiers;
+
+            void compile(const ExprImpl& expr)
+            {
+                switch (expr.kind)
+                {
+                    case ExprKind::identifier:
+                    {
+                        auto id = string2identifier(expr.identifier);
+                        if (id != Identifier::invalid)
+                        {
+                            program.push_back(make_instruction(Opcode::push_identifier, static_cast<uint32_t>(id)));
+                            return;
+                        }
+
+                        auto it = std::find(custom_identifiers.begin(), custom_identifiers.end(), expr.identifier);
+                        if (it == custom_identifiers.end())
+                        {
+                            it = custom_identifiers.insert(it, expr.identifier);
+                        }
+
+                        program.push_back(make_instruction(
+                            Opcode::push_custom, static_cast<uint32_t>(it - custom_identifiers.begin())));
+                        return;
+                    }
+                    case ExprKind::op_not:
+                        compile(*expr.exprs.at(0));
+                        program.push_back(make_instruction(Opcode::op_not));
+                        return;
+                    case ExprKind::op_and: return compile_fold(expr, Opcode::op_and, 1);
+                    case ExprKind::op_or:
+                    case ExprKind::op_list: return compile_fold(expr, Opcode::op_or, 0);
+                    default: program.push_back(make_instruction(Opcode::invalid)); return;
+                }
+            }
+
+            // operands are never skipped, so that errors are printed for all of them
+            void compile_fold(const ExprImpl& expr, Opcode op, uint32_t identity)
+            {
+                if (expr.exprs.empty())
+                {
+                    program.push_back(make_instruction(Opcode::push_constant, identity));
+                    return;
+                }
+
+                compile(*expr.exprs[0]);
+                for (size_t i = 1; i < expr.exprs.size(); ++i)
+                {
+                    compile(*expr.exprs[i]);
+                    program.push_back(make_instruction(op));
+                }
+            }
+        };
+    }
+
+    Expr::Expr(std::unique_ptr<ExprImpl>&& e) : underlying_(std::move(e))
+    {
+        if (underlying_)
+        {
+            Compiler{program_, custom_identifiers_}.compile(*underlying_);
+        }
+    }
     Expr::~Expr() = default;
 
     Expr Expr::Identifier(StringView id)
@@ -455,154 +547,174 @@ namespace vcpkg::PlatformExpression
             ExprKind::op_or, Util::fmap(exprs, [](Expr& expr) { return std::move(expr.underlying_); })));
     }
 
-    bool Expr::evaluate(const Context& context) const
+    EvaluationContext EvaluationContext::from_cmake_vars(const Context& context)
     {
-        if (!this->underlying_)
+        EvaluationContext result;
+        const auto variable = [&](const char* name) -> const std::string* {
+            auto it = context.find(name);
+            return it == context.end() ? nullptr : &it->second;
+        };
+
+        const auto set = [&](Identifier id, bool value) {
+            if (value) result.m_identifiers |= identifier_bit(id);
+        };
+
+        if (auto arch = variable("VCPKG_TARGET_ARCHITECTURE"))
         {
-            return true; // empty expression is always true
+            set(Identifier::x64, *arch == "x64");
+            set(Identifier::x86, *arch == "x86");
+            // For backwards compatability arm is also true for arm64.
+            // This is because it previously was only checking for a substring.
+            set(Identifier::arm, *arch == "arm" || *arch == "arm64");
+            set(Identifier::arm32, *arch == "arm");
+            set(Identifier::arm64, *arch == "arm64");
+            set(Identifier::wasm32, *arch == "wasm32");
         }
 
-        std::map<std::string, bool> override_ctxt;
+        if (auto system = variable("VCPKG_CMAKE_SYSTEM_NAME"))
         {
-            auto override_vars = context.find("VCPKG_DEP_INFO_OVERRIDE_VARS");
-            if (override_vars != context.end())
-            {
-                auto cmake_list = Strings::split(override_vars->second, ';');
-                for (auto& override_id : cmake_list)
-                {
-                    if (!override_id.empty())
-                    {
-                        if (override_id[0] == '!')
-                        {
-                            override_ctxt.insert({override_id.substr(1), false});
-                        }
-                        else
-                        {
-                            override_ctxt.insert({override_id, true});
-                        }
-                    }
-                }
-            }
+            set(Identifier::windows, system->empty() || *system == "WindowsStore" || *system == "MinGW");
+            set(Identifier::mingw, *system == "MinGW");
+            set(Identifier::linux, *system == "Linux");
+            set(Identifier::freebsd, *system == "FreeBSD");
+            set(Identifier::openbsd, *system == "OpenBSD");
+            set(Identifier::osx, *system == "Darwin");
+            set(Identifier::uwp, *system == "WindowsStore");
+            set(Identifier::android, *system == "Android");
+            set(Identifier::emscripten, *system == "Emscripten");
+            set(Identifier::ios, *system == "iOS");
         }
 
-        struct Visitor
+        if (auto linkage = variable("VCPKG_LIBRARY_LINKAGE"))
         {
-            const Context& context;
-            const std::map<std::string, bool>& override_ctxt;
+            set(Identifier::static_link, *linkage == "static");
+        }
+
+        if (auto crt_linkage = variable("VCPKG_CRT_LINKAGE"))
+        {
+            set(Identifier::static_crt, *crt_linkage == "static");
+        }
 
-            bool true_if_exists_and_equal(const std::string& variable_name, const std::string& value) const
+        if (auto is_native = variable("Z_VCPKG_IS_NATIVE"))
+        {
+            result.m_has_native = true;
+            set(Identifier::native, *is_native == "1");
+        }
+
+        if (auto override_vars = variable("VCPKG_DEP_INFO_OVERRIDE_VARS"))
+        {
+            // the first override of an identifier wins
+            uint32_t overridden = 0;
+            for (auto& override_id : Strings::split(*override_vars, ';'))
             {
-                auto iter = context.find(variable_name);
-                if (iter == context.end())
+                if (override_id.empty())
                 {
-                    return false;
+                    continue;
                 }
-                return iter->second == value;
-            }
 
-            bool visit(const ExprImpl& expr) const
-            {
-                if (expr.kind == ExprKind::identifier)
+                const bool negated = override_id[0] == '!';
+                auto name = StringView(override_id).substr(negated ? 1 : 0);
+                auto id = string2identifier(name);
+                if (id == Identifier::invalid)
                 {
-                    if (!override_ctxt.empty())
-                    {
-                        auto override_id = override_ctxt.find(expr.identifier);
-                        if (override_id != override_ctxt.end())
-                        {
-                            return override_id->second;
-                        }
-                        // Fall through to use the cmake logic if the id does not have an override
-                    }
-
-                    auto id = string2identifier(expr.identifier);
-                    switch (id)
-                    {
-                        case Identifier::invalid:
-                            // Point out in the diagnostic that they should add to the override list because that is
-                            // what most users should do, however it is also valid to update the built in identifiers to
-                            // recognize the name.
-                            vcpkg::printf(
-                                Color::error,
-                                "Error: Unrecognized identifer name %s. Add to override list in triplet file.\n",
-                                expr.identifier);
-                            return false;
-                        case Identifier::x64: return true_if_exists_and_equal("VCPKG_TARGET_ARCHITECTURE", "x64");
-                        case Identifier::x86: return true_if_exists_and_equal("VCPKG_TARGET_ARCHITECTURE", "x86");
-                        case Identifier::arm:
-                            // For backwards compatability arm is also true for arm64.
-                            // This is because it previously was only checking for a substring.
-                            return true_if_exists_and_equal("VCPKG_TARGET_ARCHITECTURE", "arm") ||
-                                   true_if_exists_and_equal("VCPKG_TARGET_ARCHITECTURE", "arm64");
-                        case Identifier::arm32: return true_if_exists_and_equal("VCPKG_TARGET_ARCHITECTURE", "arm");
-                        case Identifier::arm64: return true_if_exists_and_equal("VCPKG_TARGET_ARCHITECTURE", "arm64");
-                        case Identifier::windows:
-                            return true_if_exists_and_equal("VCPKG_CMAKE_SYSTEM_NAME", "") ||
-                                   true_if_exists_and_equal("VCPKG_CMAKE_SYSTEM_NAME", "WindowsStore") ||
-                                   true_if_exists_and_equal("VCPKG_CMAKE_SYSTEM_NAME", "MinGW");
-                        case Identifier::mingw: return true_if_exists_and_equal("VCPKG_CMAKE_SYSTEM_NAME", "MinGW");
-                        case Identifier::linux: return true_if_exists_and_equal("VCPKG_CMAKE_SYSTEM_NAME", "Linux");
-                        case Identifier::freebsd: return true_if_exists_and_equal("VCPKG_CMAKE_SYSTEM_NAME", "FreeBSD");
-                        case Identifier::openbsd: return true_if_exists_and_equal("VCPKG_CMAKE_SYSTEM_NAME", "OpenBSD");
-                        case Identifier::osx: return true_if_exists_and_equal("VCPKG_CMAKE_SYSTEM_NAME", "Darwin");
-                        case Identifier::uwp:
-                            return true_if_exists_and_equal("VCPKG_CMAKE_SYSTEM_NAME", "WindowsStore");
-                        case Identifier::android: return true_if_exists_and_equal("VCPKG_CMAKE_SYSTEM_NAME", "Android");
-                        case Identifier::emscripten:
-                            return true_if_exists_and_equal("VCPKG_CMAKE_SYSTEM_NAME", "Emscripten");
-                        case Identifier::ios: return true_if_exists_and_equal("VCPKG_CMAKE_SYSTEM_NAME", "iOS");
-                        case Identifier::wasm32: return true_if_exists_and_equal("VCPKG_TARGET_ARCHITECTURE", "wasm32");
-                        case Identifier::static_link:
-                            return true_if_exists_and_equal("VCPKG_LIBRARY_LINKAGE", "static");
-                        case Identifier::static_crt: return true_if_exists_and_equal("VCPKG_CRT_LINKAGE", "static");
-                        case Identifier::native:
-                        {
-                            auto is_native = context.find("Z_VCPKG_IS_NATIVE");
-                            if (is_native == context.end())
-                            {
-                                Checks::unreachable(VCPKG_LINE_INFO);
-                            }
-
-                            return is_native->second == "1";
-                        }
-                        default: Checks::unreachable(VCPKG_LINE_INFO);
-                    }
+                    result.m_custom_identifiers.emplace(name.to_string(), !negated);
+                    continue;
                 }
-                else if (expr.kind == ExprKind::op_not)
+
+                const auto bit = identifier_bit(id);
+                if (overridden & bit)
                 {
-                    return !visit(*expr.exprs.at(0));
+                    continue;
                 }
-                else if (expr.kind == ExprKind::op_and)
+
+                overridden |= bit;
+                result.m_identifiers = negated ? (result.m_identifiers & ~bit) : (result.m_identifiers | bit);
+                if (id == Identifier::native)
                 {
-                    bool valid = true;
+                    result.m_has_native = true;
+                }
+            }
+        }
 
-                    // we want to print errors in all expressions, so we check all of the expressions all the time
-                    for (const auto& e : expr.exprs)
-                    {
-                        valid &= visit(*e);
-                    }
+        return result;
+    }
 
-                    return valid;
-                }
-                else if ((expr.kind == ExprKind::op_or) || (expr.kind == ExprKind::op_list))
-                {
-                    bool valid = false;
+    bool Expr::evaluate(const Context& context) const
+    {
+        if (!this->underlying_)
+        {
+            return true; // empty expression is always true
+        }
+
+        return evaluate(EvaluationContext::from_cmake_vars(context));
+    }
+
+    bool Expr::evaluate(const EvaluationContext& context) const
+    {
+        if (!this->underlying_)
+        {
+            return true; // empty expression is always true
+        }
 
-                    // we want to print errors in all expressions, so we check all of the expressions all the time
-                    for (const auto& e : expr.exprs)
+        // the stack can't be deeper than the program is long
+        bool small_stack[64];
+        std::unique_ptr<bool[]> large_stack;
+        bool* stack = small_stack;
+        if (program_.size() > 64)
+        {
+            large_stack = std::make_unique<bool[]>(program_.size());
+            stack = large_stack.get();
+        }
+
+        size_t depth = 0;
+        for (auto instruction : program_)
+        {
+            const auto operand = operand_of(instruction);
+            switch (opcode_of(instruction))
+            {
+                case Opcode::push_constant: stack[depth++] = operand != 0; break;
+                case Opcode::push_identifier:
+                    if (is_native(operand) && !context.m_has_native)
                     {
-                        valid |= visit(*e);
+                        Checks::unreachable(VCPKG_LINE_INFO);
                     }
 
-                    return valid;
-                }
-                else
+                    stack[depth++] = (context.m_identifiers & (uint32_t(1) << operand)) != 0;
+                    break;
+                case Opcode::push_custom:
                 {
-                    Checks::unreachable(VCPKG_LINE_INFO);
+                    const auto& name = custom_identifiers_[operand];
+                    auto it = context.m_custom_identifiers.find(name);
+                    if (it == context.m_custom_identifiers.end())
+                    {
+                        // Point out in the diagnostic that they should add to the override list because that is
+                        // what most users should do, however it is also valid to update the built in identifiers to
+                        // recognize the name.
+                        vcpkg::printf(Color::error,
+                                      "Error: Unrecognized identifer name %s. Add to override list in triplet file.\n",
+                                      name);
+                        stack[depth++] = false;
+                    }
+                    else
+                    {
+                        stack[depth++] = it->second;
+                    }
+                    break;
                 }
+                case Opcode::op_not: stack[depth - 1] = !stack[depth - 1]; break;
+                case Opcode::op_and:
+                    --depth;
+                    stack[depth - 1] = stack[depth - 1] && stack[depth];
+                    break;
+                case Opcode::op_or:
+                    --depth;
+                    stack[depth - 1] = stack[depth - 1] || stack[depth];
+                    break;
+                default: Checks::unreachable(VCPKG_LINE_INFO);
             }
-        };
+        }
 
-        return Visitor{context, override_ctxt}.visit(*this->underlying_);
+        return stack[0];
     }
 
     int Expr::complexity() const
@@ -37,6 +37,17 @@ namespace
 
 namespace vcpkg::PortFileProvider
 {
+    ExpectedS<Version> PortFileProvider::get_port_version(const std::string& src_name) const
+    {
+        auto maybe_scfl = get_control_file(src_name);
+        if (auto scfl = maybe_scfl.get())
+        {
+            return scfl->to_version();
+        }
+
+        return maybe_scfl.error();
+    }
+
     MapPortFileProvider::MapPortFileProvider(const std::unordered_map<std::string, SourceControlFileAndLocation>& map)
         : ports(map)
     {
@@ -80,6 +91,24 @@ namespace vcpkg::PortFileProvider
         }
     }
 
+    ExpectedS<Version> PathsPortFileProvider::get_port_version(const std::string& spec) const
+    {
+        auto maybe_overlay_version = m_overlay->get_port_version(spec);
+        if (auto overlay_version = maybe_overlay_version.get())
+        {
+            return std::move(*overlay_version);
+        }
+
+        // the versioned provider checks that the port matches its baseline entry, so there is no need to load it
+        auto maybe_baseline = m_baseline->get_baseline_version(spec);
+        if (auto baseline = maybe_baseline.get())
+        {
+            return std::move(*baseline);
+        }
+
+        return Strings::concat("Error: unable to get baseline for port ", spec);
+    }
+
     std::vector<const SourceControlFileAndLocation*> PathsPortFileProvider::load_all_control_files() const
     {
         std::map<std::string, const SourceControlFileAndLocation*> m;
@@ -117,6 +146,11 @@ namespace vcpkg::PortFileProvider
                 }
             }
 
+            virtual void prefetch_baseline_versions(View<std::string> port_names) const override
+            {
+                paths.get_registry_set().prefetch_baselines(port_names);
+            }
+
         private:
             const VcpkgPaths& paths;
             mutable std::map<std::string, Optional<Version>, std::less<>> m_baseline_cache;
@@ -271,7 +305,25 @@ namespace vcpkg::PortFileProvider
             OverlayProviderImpl(const OverlayProviderImpl&) = delete;
             OverlayProviderImpl& operator=(const OverlayProviderImpl&) = delete;
 
-            Optional<SourceControlFileAndLocation> load_port(StringView port_name) const
+            static const std::string& name_of(const SourceControlFile& scf) { return scf.core_paragraph->name; }
+            static const std::string& name_of(const PortIdentity& identity) { return identity.name; }
+
+            // Port is either SourceControlFile, to load the whole port, or PortIdentity, to load only its version
+            template<class Port>
+            static Parse::ParseExpected<Port> try_load_port_as(const Filesystem& fs, const Path& port_directory)
+            {
+                if constexpr (std::is_same_v<Port, SourceControlFile>)
+                {
+                    return Paragraphs::try_load_port(fs, port_directory);
+                }
+                else
+                {
+                    return Paragraphs::try_load_port_identity(fs, port_directory);
+                }
+            }
+
+            template<class Port>
+            Optional<std::pair<std::unique_ptr<Port>, Path>> find_port(StringView port_name) const
             {
                 auto s_port_name = port_name.to_string();
 
@@ -280,13 +332,13 @@ namespace vcpkg::PortFileProvider
                     // Try loading individual port
                     if (Paragraphs::is_port_directory(m_fs, ports_dir))
                     {
-                        auto maybe_scf = Paragraphs::try_load_port(m_fs, ports_dir);
+                        auto maybe_scf = try_load_port_as<Port>(m_fs, ports_dir);
                         if (auto scfp = maybe_scf.get())
                         {
                             auto& scf = *scfp;
-                            if (scf->core_paragraph->name == port_name)
+                            if (name_of(*scf) == port_name)
                             {
-                                return SourceControlFileAndLocation{std::move(scf), ports_dir};
+                                return std::make_pair(std::move(scf), ports_dir);
                             }
                         }
                         else
@@ -302,20 +354,20 @@ namespace vcpkg::PortFileProvider
                     auto ports_spec = ports_dir / port_name;
                     if (Paragraphs::is_port_directory(m_fs, ports_spec))
                     {
-                        auto found_scf = Paragraphs::try_load_port(m_fs, ports_spec);
+                        auto found_scf = try_load_port_as<Port>(m_fs, ports_spec);
                         if (auto scfp = found_scf.get())
                         {
                             auto& scf = *scfp;
-                            if (scf->core_paragraph->name == port_name)
+                            if (name_of(*scf) == port_name)
                             {
-                                return SourceControlFileAndLocation{std::move(scf), std::move(ports_spec)};
+                                return std::make_pair(std::move(scf), std::move(ports_spec));
                             }
                             Checks::exit_maybe_upgrade(
                                 VCPKG_LINE_INFO,
                                 "Error: Failed to load port from %s: names did not match: '%s' != '%s'",
                                 ports_spec,
                                 port_name,
-                                scf->core_paragraph->name);
+                                name_of(*scf));
                         }
                         else
                         {
@@ -328,6 +380,17 @@ namespace vcpkg::PortFileProvider
                 return nullopt;
             }
 
+            Optional<SourceControlFileAndLocation> load_port(StringView port_name) const
+            {
+                auto maybe_port = find_port<SourceControlFile>(port_name);
+                if (auto port = maybe_port.get())
+                {
+                    return SourceControlFileAndLocation{std::move(port->first), std::move(port->second)};
+                }
+
+                return nullopt;
+            }
+
             virtual Optional<const SourceControlFileAndLocation&> get_control_file(StringView port_name) const override
             {
                 auto it = m_overlay_cache.find(port_name);
@@ -338,6 +401,30 @@ namespace vcpkg::PortFileProvider
                 return it->second;
             }
 
+            virtual Optional<Version> get_port_version(StringView port_name) const override
+            {
+                auto it = m_overlay_cache.find(port_name);
+                if (it != m_overlay_cache.end())
+                {
+                    return it->second.map([](const SourceControlFileAndLocation& scfl) { return scfl.to_version(); });
+                }
+
+                auto version_it = m_version_cache.find(port_name);
+                if (version_it == m_version_cache.end())
+                {
+                    auto maybe_identity = find_port<PortIdentity>(port_name);
+                    Optional<Version> version;
+                    if (auto identity = maybe_identity.get())
+                    {
+                        version = identity->first->to_version();
+                    }
+
+                    version_it = m_version_cache.emplace(port_name.to_string(), std::move(version)).first;
+                }
+
+                return version_it->second;
+            }
+
             virtual void load_all_control_files(
                 std::map<std::string, const SourceControlFileAndLocation*>& out) const override
             {
@@ -381,6 +468,7 @@ namespace vcpkg::PortFileProvider
             const Filesystem& m_fs;
             const std::vector<Path> m_overlay_ports;
             mutable std::map<std::string, Optional<SourceControlFileAndLocation>, std::less<>> m_overlay_cache;
+            mutable std::map<std::string, Optional<Version>, std::less<>> m_version_cache;
         };
     }
 
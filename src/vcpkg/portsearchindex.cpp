@@ -0,0 +1,479 @@
+#include <vcpkg/base/checks.h>
+#include <vcpkg/base/json.h>
+#include <vcpkg/base/strings.h>
+#include <vcpkg/base/system.debug.h>
+#include <vcpkg/base/util.h>
+
+#include <vcpkg/paragraphs.h>
+#include <vcpkg/portsearchindex.h>
+#include <vcpkg/sourceparagraph.h>
+#include <vcpkg/vcpkgpaths.h>
+
+#include <algorithm>
+#include <unordered_set>
+
+namespace
+{
+    using namespace vcpkg;
+
+    // bump this whenever the format of the index file changes, so that old indexes are rebuilt
+    constexpr int64_t INDEX_FORMAT_VERSION = 1;
+
+    namespace Fields
+    {
+        constexpr StringLiteral FORMAT_VERSION = "format-version";
+        constexpr StringLiteral PORTS = "ports";
+        constexpr StringLiteral NAME = "name";
+        constexpr StringLiteral VERSION = "version";
+        constexpr StringLiteral PORT_VERSION = "port-version";
+        constexpr StringLiteral DESCRIPTION = "description";
+        constexpr StringLiteral FEATURES = "features";
+        constexpr StringLiteral LOCATION = "location";
+        constexpr StringLiteral MANIFEST = "manifest";
+        constexpr StringLiteral MANIFEST_TIME = "manifest-time";
+    }
+
+    struct ManifestStamp
+    {
+        std::string manifest;
+        int64_t time;
+    };
+
+    // the same manifest Paragraphs::try_load_port would read
+    Optional<ManifestStamp> stamp_manifest(const Filesystem& fs, const Path& port_directory)
+    {
+        static constexpr StringLiteral MANIFESTS[] = {"vcpkg.json", "CONTROL"};
+        for (auto&& manifest : MANIFESTS)
+        {
+            std::error_code ec;
+            const auto time = fs.last_write_time(port_directory / manifest, ec);
+            if (!ec)
+            {
+                return ManifestStamp{manifest.to_string(), time};
+            }
+        }
+
+        return nullopt;
+    }
+
+    Json::Array lines_to_json(const std::vector<std::string>& lines)
+    {
+        Json::Array arr;
+        for (auto&& line : lines)
+        {
+            arr.push_back(Json::Value::string(line));
+        }
+
+        return arr;
+    }
+
+    bool lines_from_json(const Json::Object& obj, StringView field, std::vector<std::string>& out)
+    {
+        auto value = obj.get(field);
+        if (!value || !value->is_array()) return false;
+        for (auto&& line : value->array())
+        {
+            if (!line.is_string()) return false;
+            out.push_back(line.string().to_string());
+        }
+
+        return true;
+    }
+
+    bool string_from_json(const Json::Object& obj, StringView field, std::string& out)
+    {
+        auto value = obj.get(field);
+        if (!value || !value->is_string()) return false;
+        out = value->string().to_string();
+        return true;
+    }
+
+    bool integer_from_json(const Json::Object& obj, StringView field, int64_t& out)
+    {
+        auto value = obj.get(field);
+        if (!value || !value->is_integer()) return false;
+        out = value->integer();
+        return true;
+    }
+
+    Json::Object port_to_json(const IndexedPort& port)
+    {
+        Json::Object obj;
+        obj.insert(Fields::NAME, Json::Value::string(port.name));
+        obj.insert(Fields::VERSION, Json::Value::string(port.version));
+        obj.insert(Fields::PORT_VERSION, Json::Value::integer(port.port_version));
+        obj.insert(Fields::DESCRIPTION, lines_to_json(port.description));
+        auto& features = obj.insert(Fields::FEATURES, Json::Array());
+        for (auto&& feature : port.features)
+        {
+            auto& feature_obj = features.push_back(Json::Object());
+            feature_obj.insert(Fields::NAME, Json::Value::string(feature.name));
+            feature_obj.insert(Fields::DESCRIPTION, lines_to_json(feature.description));
+        }
+
+        obj.insert(Fields::LOCATION, Json::Value::string(port.location.native()));
+        obj.insert(Fields::MANIFEST, Json::Value::string(port.manifest));
+        obj.insert(Fields::MANIFEST_TIME, Json::Value::integer(port.manifest_time));
+        return obj;
+    }
+
+    Optional<IndexedPort> port_from_json(const Json::Value& value)
+    {
+        if (!value.is_object()) return nullopt;
+        const auto& obj = value.object();
+
+        IndexedPort port;
+        int64_t port_version;
+        std::string location;
+        if (!string_from_json(obj, Fields::NAME, port.name) || !string_from_json(obj, Fields::VERSION, port.version) ||
+            !integer_from_json(obj, Fields::PORT_VERSION, port_version) ||
+            !lines_from_json(obj, Fields::DESCRIPTION, port.description) ||
+            !string_from_json(obj, Fields::LOCATION, location) ||
+            !string_from_json(obj, Fields::MANIFEST, port.manifest) ||
+            !integer_from_json(obj, Fields::MANIFEST_TIME, port.manifest_time))
+        {
+            return nullopt;
+        }
+
+        port.port_version = static_cast<int>(port_version);
+        port.location = std::move(location);
+
+        auto features = obj.get(Fields::FEATURES);
+        if (!features || !features->is_array()) return nullopt;
+        for (auto&& feature : features->array())
+        {
+            if (!feature.is_object()) return nullopt;
+            auto& indexed_feature = port.features.emplace_back();
+            if (!string_from_json(feature.object(), Fields::NAME, indexed_feature.name) ||
+                !lines_from_json(feature.object(), Fields::DESCRIPTION, indexed_feature.description))
+            {
+                return nullopt;
+            }
+        }
+
+        return port;
+    }
+
+    uint32_t lowercase_byte(char c)
+    {
+        return c >= 'A' && c <= 'Z' ? static_cast<uint32_t>(c - 'A' + 'a') : static_cast<unsigned char>(c);
+    }
+
+    // appends the trigrams of the lowercased text to out
+    void append_trigrams(std::vector<uint32_t>& out, StringView text)
+    {
+        const char* const data = text.data();
+        for (size_t i = 0; i + 3 <= text.size(); ++i)
+        {
+            out.push_back(lowercase_byte(data[i]) << 16 | lowercase_byte(data[i + 1]) << 8 |
+                          lowercase_byte(data[i + 2]));
+        }
+    }
+}
+
+namespace vcpkg
+{
+    IndexedPort IndexedPort::from_source_control_file(const SourceControlFile& scf)
+    {
+        IndexedPort port;
+        port.name = scf.core_paragraph->name;
+        port.version = scf.core_paragraph->raw_version;
+        port.port_version = scf.core_paragraph->port_version;
+        port.description = scf.core_paragraph->description;
+        for (auto&& feature_paragraph : scf.feature_paragraphs)
+        {
+            port.features.push_back({feature_paragraph->name, feature_paragraph->description});
+        }
+
+        return port;
+    }
+
+    PortSearchIndex PortSearchIndex::load(const Filesystem& fs, const Path& index_path)
+    {
+        PortSearchIndex index;
+        if (!fs.exists(index_path, IgnoreErrors{})) return index;
+
+        std::error_code ec;
+        auto maybe_json = Json::parse_file(fs, index_path, ec);
+        auto json = maybe_json.get();
+        if (ec || !json || !json->first.is_object())
+        {
+            Debug::print("Ignoring the unreadable port search index ", index_path, '\n');
+            return index;
+        }
+
+        const auto& obj = json->first.object();
+        int64_t format_version;
+        auto ports = obj.get(Fields::PORTS);
+        if (!integer_from_json(obj, Fields::FORMAT_VERSION, format_version) ||
+            format_version != INDEX_FORMAT_VERSION || !ports || !ports->is_array())
+        {
+            Debug::print("Ignoring the outdated port search index ", index_path, '\n');
+            return index;
+        }
+
+        for (auto&& port : ports->array())
+        {
+            auto maybe_indexed_port = port_from_json(port);
+            if (auto indexed_port = maybe_indexed_port.get())
+            {
+                index.m_ports.push_back(std::move(*indexed_port));
+            }
+        }
+
+        index.build();
+        return index;
+    }
+
+    void PortSearchIndex::save(Filesystem& fs, const Path& index_path, std::error_code& ec) const
+    {
+        Json::Object obj;
+        obj.insert(Fields::FORMAT_VERSION, Json::Value::integer(INDEX_FORMAT_VERSION));
+        auto& ports = obj.insert(Fields::PORTS, Json::Array());
+        for (auto&& port : m_ports)
+        {
+            ports.push_back(port_to_json(port));
+        }
+
+        fs.create_directories(index_path.parent_path(), ec);
+        if (ec) return;
+        Json::dump_file(fs, index_path, obj, Json::JsonStyle{}, ec);
+    }
+
+    bool PortSearchIndex::refresh(const Filesystem& fs, View<Path> port_directories)
+    {
+        std::unordered_map<std::string, IndexedPort*> indexed;
+        for (auto&& port : m_ports)
+        {
+            indexed.emplace(port.location.native(), &port);
+        }
+
+        bool changed = false;
+        size_t reused = 0;
+        std::vector<IndexedPort> ports;
+        Paragraphs::LoadResults load_results;
+        for (auto&& port_directory : port_directories)
+        {
+            const auto maybe_stamp = stamp_manifest(fs, port_directory);
+            auto it = indexed.find(port_directory.native());
+            if (auto stamp = maybe_stamp.get())
+            {
+                if (it != indexed.end() && it->second->manifest == stamp->manifest &&
+                    it->second->manifest_time == stamp->time)
+                {
+                    ports.push_back(std::move(*it->second));
+                    indexed.erase(it);
+                    ++reused;
+                    continue;
+                }
+            }
+
+            changed = true;
+            auto maybe_scf = Paragraphs::try_load_port(fs, port_directory);
+            if (auto scf = maybe_scf.get())
+            {
+                auto& port = ports.emplace_back(IndexedPort::from_source_control_file(**scf));
+                port.location = port_directory;
+                if (auto stamp = maybe_stamp.get())
+                {
+                    port.manifest = stamp->manifest;
+                    port.manifest_time = stamp->time;
+                }
+            }
+            else
+            {
+                load_results.errors.push_back(std::move(maybe_scf).error());
+            }
+        }
+
+        Paragraphs::load_results_print_error(load_results);
+        if (reused != m_ports.size())
+        {
+            // some ports are no longer visible
+            changed = true;
+        }
+
+        m_ports = std::move(ports);
+        build();
+        return changed;
+    }
+
+    std::vector<const IndexedPort*> PortSearchIndex::ports() const
+    {
+        return Util::fmap(m_visible, [this](uint32_t id) { return &m_ports[id]; });
+    }
+
+    void PortSearchIndex::build()
+    {
+        m_visible.clear();
+        m_trigrams.clear();
+
+        std::unordered_set<std::string> names;
+        for (uint32_t id = 0; id < m_ports.size(); ++id)
+        {
+            if (names.insert(m_ports[id].name).second)
+            {
+                m_visible.push_back(id);
+            }
+        }
+
+        Util::sort(m_visible, [this](uint32_t lhs, uint32_t rhs) { return m_ports[lhs].name < m_ports[rhs].name; });
+
+        std::vector<uint32_t> port_trigrams;
+        for (auto id : m_visible)
+        {
+            const auto& port = m_ports[id];
+            port_trigrams.clear();
+            append_trigrams(port_trigrams, port.name);
+            for (auto&& line : port.description)
+            {
+                append_trigrams(port_trigrams, line);
+            }
+
+            for (auto&& feature : port.features)
+            {
+                append_trigrams(port_trigrams, feature.name);
+                for (auto&& line : feature.description)
+                {
+                    append_trigrams(port_trigrams, line);
+                }
+            }
+
+            Util::sort_unique_erase(port_trigrams);
+            for (auto trigram : port_trigrams)
+            {
+                m_trigrams[trigram].push_back(id);
+            }
+        }
+
+        // the posting lists are intersected by merging, so they must be ascending
+        for (auto&& posting : m_trigrams)
+        {
+            Util::sort(posting.second);
+        }
+    }
+
+    std::vector<SearchResult> PortSearchIndex::search(StringView query) const
+    {
+        std::vector<uint32_t> query_trigrams;
+        append_trigrams(query_trigrams, query);
+        Util::sort_unique_erase(query_trigrams);
+
+        std::vector<uint32_t> candidates;
+        if (query_trigrams.empty())
+        {
+            candidates = m_visible;
+        }
+        else
+        {
+            std::vector<const std::vector<uint32_t>*> postings;
+            for (auto trigram : query_trigrams)
+            {
+                auto it = m_trigrams.find(trigram);
+                if (it == m_trigrams.end()) return {};
+                postings.push_back(&it->second);
+            }
+
+            // intersect the shortest lists first, so that the candidate set shrinks as fast as possible
+            Util::sort(postings, [](auto lhs, auto rhs) { return lhs->size() < rhs->size(); });
+            candidates = *postings[0];
+            std::vector<uint32_t> intersection;
+            for (size_t i = 1; i < postings.size() && !candidates.empty(); ++i)
+            {
+                intersection.clear();
+                std::set_intersection(candidates.begin(),
+                                      candidates.end(),
+                                      postings[i]->begin(),
+                                      postings[i]->end(),
+                                      std::back_inserter(intersection));
+                candidates.swap(intersection);
+            }
+        }
+
+        // a port contains every trigram of the query without necessarily containing the query, so check each one
+        const auto contained_in = [query](StringView haystack) {
+            return Strings::case_insensitive_ascii_contains(haystack, query);
+        };
+
+        std::vector<SearchResult> results;
+        for (auto id : candidates)
+        {
+            const auto& port = m_ports[id];
+            SearchResult result{&port, SearchMatch::Feature, {}};
+            if (Strings::case_insensitive_ascii_equals(port.name, query))
+            {
+                result.match = SearchMatch::ExactName;
+            }
+            else if (Strings::case_insensitive_ascii_starts_with(port.name, query))
+            {
+                result.match = SearchMatch::NamePrefix;
+            }
+            else if (contained_in(port.name))
+            {
+                result.match = SearchMatch::Name;
+            }
+            else if (std::any_of(port.description.begin(), port.description.end(), contained_in))
+            {
+                result.match = SearchMatch::Description;
+            }
+
+            const bool port_matched = result.match != SearchMatch::Feature;
+            for (auto&& feature : port.features)
+            {
+                if (port_matched || contained_in(feature.name) ||
+                    std::any_of(feature.description.begin(), feature.description.end(), contained_in))
+                {
+                    result.features.push_back(&feature);
+                }
+            }
+
+            if (port_matched || !result.features.empty())
+            {
+                results.push_back(std::move(result));
+            }
+        }
+
+        Util::sort(results, [](const SearchResult& lhs, const SearchResult& rhs) {
+            if (lhs.match != rhs.match) return lhs.match < rhs.match;
+            return lhs.port->name < rhs.port->name;
+        });
+        return results;
+    }
+
+    Optional<Path> port_search_index_path(const VcpkgPaths& paths)
+    {
+        if (auto buildtrees = paths.maybe_buildtrees().get())
+        {
+            return *buildtrees / "search-index.json";
+        }
+
+        return nullopt;
+    }
+
+    std::vector<Path> get_searchable_port_directories(const VcpkgPaths& paths, View<std::string> overlay_ports)
+    {
+        auto& fs = paths.get_filesystem();
+        std::vector<Path> port_directories;
+        for (auto&& overlay_port : overlay_ports)
+        {
+            auto overlay = paths.original_cwd / overlay_port;
+            Checks::check_exit(VCPKG_LINE_INFO,
+                               vcpkg::is_directory(fs.status(overlay, VCPKG_LINE_INFO)),
+                               "Error: Overlay path \"%s\" must exist and must be a directory",
+                               overlay);
+            if (Paragraphs::is_port_directory(fs, overlay))
+            {
+                port_directories.push_back(std::move(overlay));
+            }
+            else
+            {
+                auto overlay_directories = Paragraphs::get_overlay_port_directories(fs, overlay);
+                Util::Vectors::append(&port_directories, std::move(overlay_directories));
+            }
+        }
+
+        Util::Vectors::append(&port_directories,
+                              Paragraphs::get_all_registry_port_directories(paths.get_registry_set()));
+        return port_directories;
+    }
+}
@@ -1,7 +1,9 @@
 #include <vcpkg/base/cofffilereader.h>
 #include <vcpkg/base/files.h>
+#include <vcpkg/base/parallel-algorithms.h>
 #include <vcpkg/base/system.print.h>
 #include <vcpkg/base/system.process.h>
+#include <vcpkg/base/tracing.h>
 #include <vcpkg/base/util.h>
 
 #include <vcpkg/build.h>
@@ -71,6 +73,94 @@ namespace vcpkg::PostBuildLint
         return V_NO_MSVCRT;
     }
 
+    // Normalized with '/' separators, so that looking up a directory matches its files however the path was spelled.
+    // Lowercase on Windows, where the filesystem ignores case.
+    static std::string package_file_index_key(const Path& path)
+    {
+#if defined(_WIN32)
+        auto key = Strings::ascii_to_lowercase(path.lexically_normal().generic_u8string());
+#else
+        auto key = path.lexically_normal().generic_u8string();
+#endif
+        while (!key.empty() && key.back() == '/')
+        {
+            key.pop_back();
+        }
+
+        return key;
+    }
+
+    PackageFileIndex::PackageFileIndex(const Filesystem& fs, const Path& package_dir)
+    {
+        std::error_code ec;
+        std::vector<std::pair<std::string, Path>> keyed_files;
+        fs.visit_recursive(
+            package_dir,
+            [&](const Path& path, FileType type) {
+                if (is_directory(type))
+                {
+                    directories.push_back(path);
+                }
+                else if (is_regular_file(type))
+                {
+                    keyed_files.emplace_back(package_file_index_key(path), path);
+                }
+            },
+            ec);
+
+        std::sort(directories.begin(), directories.end(), [](const Path& lhs, const Path& rhs) {
+            return lhs.native() < rhs.native();
+        });
+        std::sort(keyed_files.begin(), keyed_files.end());
+        for (auto&& keyed_file : keyed_files)
+        {
+            regular_file_keys.push_back(std::move(keyed_file.first));
+            regular_files.push_back(std::move(keyed_file.second));
+        }
+
+        for (auto&& dir : directories)
+        {
+            non_empty_directories.emplace(dir.parent_path().to_string());
+        }
+
+        for (auto&& file : regular_files)
+        {
+            non_empty_directories.emplace(file.parent_path().to_string());
+        }
+    }
+
+    std::vector<Path> PackageFileIndex::regular_files_under(const Path& dir) const
+    {
+        return files_under(dir, false);
+    }
+
+    std::vector<Path> PackageFileIndex::regular_files_in(const Path& dir) const { return files_under(dir, true); }
+
+    std::vector<Path> PackageFileIndex::empty_directories(const Filesystem& fs) const
+    {
+        return Util::filter(directories, [&](const Path& dir) {
+            return !Util::Sets::contains(non_empty_directories, dir.native()) && fs.is_empty(dir, IgnoreErrors{});
+        });
+    }
+
+    std::vector<Path> PackageFileIndex::files_under(const Path& dir, bool direct_children_only) const
+    {
+        const auto prefix = package_file_index_key(dir) + '/';
+        const auto first = std::lower_bound(regular_file_keys.begin(), regular_file_keys.end(), prefix);
+        std::vector<Path> ret;
+        for (auto it = first; it != regular_file_keys.end() && Strings::starts_with(*it, prefix); ++it)
+        {
+            if (direct_children_only && it->find('/', prefix.size()) != std::string::npos)
+            {
+                continue;
+            }
+
+            ret.push_back(regular_files[it - regular_file_keys.begin()]);
+        }
+
+        return ret;
+    }
+
     static LintStatus check_for_files_in_include_directory(const Filesystem& fs,
                                                            const Build::BuildPolicies& policies,
                                                            const Path& package_dir)
@@ -199,11 +289,12 @@ namespace vcpkg::PostBuildLint
         return LintStatus::SUCCESS;
     }
 
-    static LintStatus check_for_files_in_debug_include_directory(const Filesystem& fs, const Path& package_dir)
+    static LintStatus check_for_files_in_debug_include_directory(const PackageFileIndex& index,
+                                                                 const Path& package_dir)
     {
         const auto debug_include_dir = package_dir / "debug" / "include";
 
-        std::vector<Path> files_found = fs.get_regular_files_recursive(debug_include_dir, IgnoreErrors{});
+        std::vector<Path> files_found = index.regular_files_under(debug_include_dir);
 
         Util::erase_remove_if(files_found, [](const Path& target) { return target.extension() == ".ifc"; });
 
@@ -271,7 +362,7 @@ namespace vcpkg::PostBuildLint
         return LintStatus::SUCCESS;
     }
 
-    static LintStatus check_for_misplaced_cmake_files(const Filesystem& fs,
+    static LintStatus check_for_misplaced_cmake_files(const PackageFileIndex& index,
                                                       const Path& package_dir,
                                                       const PackageSpec& spec)
     {
@@ -285,7 +376,7 @@ namespace vcpkg::PostBuildLint
         std::vector<Path> misplaced_cmake_files;
         for (auto&& dir : dirs)
         {
-            for (auto&& file : fs.get_regular_files_recursive(dir, IgnoreErrors{}))
+            for (auto&& file : index.regular_files_under(dir))
             {
                 if (Strings::case_insensitive_ascii_equals(file.extension(), ".cmake"))
                 {
@@ -324,9 +415,9 @@ namespace vcpkg::PostBuildLint
         return LintStatus::SUCCESS;
     }
 
-    static LintStatus check_for_dlls_in_lib_dir(const Filesystem& fs, const Path& package_dir)
+    static LintStatus check_for_dlls_in_lib_dir(const PackageFileIndex& index, const Path& package_dir)
     {
-        std::vector<Path> dlls = fs.get_regular_files_recursive(package_dir / "lib", IgnoreErrors{});
+        std::vector<Path> dlls = index.regular_files_under(package_dir / "lib");
         Util::erase_remove_if(dlls, NotExtensionCaseInsensitive{".dll"});
 
         if (!dlls.empty())
@@ -394,9 +485,9 @@ namespace vcpkg::PostBuildLint
         return LintStatus::PROBLEM_DETECTED;
     }
 
-    static LintStatus check_for_exes(const Filesystem& fs, const Path& package_dir)
+    static LintStatus check_for_exes(const PackageFileIndex& index, const Path& package_dir)
     {
-        std::vector<Path> exes = fs.get_regular_files_recursive(package_dir / "bin", IgnoreErrors{});
+        std::vector<Path> exes = index.regular_files_under(package_dir / "bin");
         Util::erase_remove_if(exes, NotExtensionCaseInsensitive{".exe"});
 
         if (!exes.empty())
@@ -410,6 +501,26 @@ namespace vcpkg::PostBuildLint
         return LintStatus::SUCCESS;
     }
 
+    // Runs `dumpbin <option> <file>` for each of `files` concurrently; exits if any invocation fails.
+    static std::vector<std::string> run_dumpbin_in_parallel(const Path& dumpbin_exe,
+                                                            StringLiteral option,
+                                                            const std::vector<Path>& files)
+    {
+        const auto cmd_lines =
+            Util::fmap(files, [&](const Path& file) { return Command(dumpbin_exe).string_arg(option).path_arg(file); });
+        auto results = cmd_execute_and_capture_output_parallel(cmd_lines);
+        for (size_t i = 0; i < results.size(); ++i)
+        {
+            Checks::check_exit(VCPKG_LINE_INFO,
+                               results[i].exit_code == 0,
+                               "Running command:\n   %s\n failed with message:\n%s",
+                               cmd_lines[i].command_line(),
+                               results[i].output);
+        }
+
+        return Util::fmap(results, [](ExitCodeAndOutput& result) { return std::move(result.output); });
+    }
+
     static LintStatus check_exports_of_dlls(const Build::BuildPolicies& policies,
                                             const std::vector<Path>& dlls,
                                             const Path& dumpbin_exe)
@@ -417,16 +528,12 @@ namespace vcpkg::PostBuildLint
         if (policies.is_enabled(BuildPolicy::DLLS_WITHOUT_EXPORTS)) return LintStatus::SUCCESS;
 
         std::vector<Path> dlls_with_no_exports;
-        for (const Path& dll : dlls)
+        const auto outputs = run_dumpbin_in_parallel(dumpbin_exe, "/exports", dlls);
+        for (size_t i = 0; i < dlls.size(); ++i)
         {
-            auto cmd_line = Command(dumpbin_exe).string_arg("/exports").path_arg(dll);
-            ExitCodeAndOutput ec_data = cmd_execute_and_capture_output(cmd_line);
-            Checks::check_exit(
-                VCPKG_LINE_INFO, ec_data.exit_code == 0, "Running command:\n   %s\n failed", cmd_line.command_line());
-
-            if (ec_data.output.find("ordinal hint RVA      name") == std::string::npos)
+            if (outputs[i].find("ordinal hint RVA      name") == std::string::npos)
             {
-                dlls_with_no_exports.push_back(dll);
+                dlls_with_no_exports.push_back(dlls[i]);
             }
         }
 
@@ -455,16 +562,12 @@ namespace vcpkg::PostBuildLint
         }
 
         std::vector<Path> dlls_with_improper_uwp_bit;
-        for (const Path& dll : dlls)
+        const auto outputs = run_dumpbin_in_parallel(dumpbin_exe, "/headers", dlls);
+        for (size_t i = 0; i < dlls.size(); ++i)
         {
-            auto cmd_line = Command(dumpbin_exe).string_arg("/headers").path_arg(dll);
-            ExitCodeAndOutput ec_data = cmd_execute_and_capture_output(cmd_line);
-            Checks::check_exit(
-                VCPKG_LINE_INFO, ec_data.exit_code == 0, "Running command:\n   %s\n failed", cmd_line.command_line());
-
-            if (ec_data.output.find("App Container") == std::string::npos)
+            if (outputs[i].find("App Container") == std::string::npos)
             {
-                dlls_with_improper_uwp_bit.push_back(dll);
+                dlls_with_improper_uwp_bit.push_back(dlls[i]);
             }
         }
 
@@ -532,12 +635,19 @@ namespace vcpkg::PostBuildLint
                                Strings::case_insensitive_ascii_equals(file.extension(), ".dll"),
                                "The file extension was not .dll: %s",
                                file);
-            const auto machine_type = read_dll_machine_type(fs.open_for_read(file, VCPKG_LINE_INFO));
-            const std::string actual_architecture = get_actual_architecture(machine_type);
+        }
+
+        std::vector<MachineType> machine_types(files.size());
+        parallel_transform(files.begin(), files.size(), machine_types.begin(), [&](const Path& file) {
+            return read_dll_machine_type(fs.map_for_read(file, VCPKG_LINE_INFO).contents());
+        });
 
+        for (size_t i = 0; i < files.size(); ++i)
+        {
+            const std::string actual_architecture = get_actual_architecture(machine_types[i]);
             if (expected_architecture != actual_architecture)
             {
-                binaries_with_invalid_architecture.push_back({file, actual_architecture});
+                binaries_with_invalid_architecture.push_back({files[i], actual_architecture});
             }
         }
 
@@ -564,7 +674,17 @@ namespace vcpkg::PostBuildLint
                                Strings::case_insensitive_ascii_equals(file.extension(), ".lib"),
                                "The file extension was not .lib: %s",
                                file);
-            const auto machine_types = read_lib_machine_types(fs.open_for_read(file, VCPKG_LINE_INFO));
+        }
+
+        std::vector<std::vector<MachineType>> machine_types_per_file(files.size());
+        parallel_transform(files.begin(), files.size(), machine_types_per_file.begin(), [&](const Path& file) {
+            return read_lib_machine_types(fs.map_for_read(file, VCPKG_LINE_INFO).contents());
+        });
+
+        for (size_t i = 0; i < files.size(); ++i)
+        {
+            const auto& file = files[i];
+            const auto& machine_types = machine_types_per_file[i];
 
             // This is zero for folly's debug library
             // TODO: Why?
@@ -705,11 +825,9 @@ namespace vcpkg::PostBuildLint
         return LintStatus::PROBLEM_DETECTED;
     }
 
-    static LintStatus check_no_empty_folders(const Filesystem& fs, const Path& dir)
+    static LintStatus check_no_empty_folders(const Filesystem& fs, const PackageFileIndex& index, const Path& dir)
     {
-        std::vector<Path> empty_directories = fs.get_directories_recursive(dir, IgnoreErrors{});
-        Util::erase_remove_if(empty_directories,
-                              [&fs](const Path& current) { return !fs.is_empty(current, IgnoreErrors{}); });
+        std::vector<Path> empty_directories = index.empty_directories(fs);
 
         if (!empty_directories.empty())
         {
@@ -738,7 +856,9 @@ namespace vcpkg::PostBuildLint
         return LintStatus::SUCCESS;
     }
 
-    static LintStatus check_pkgconfig_dir_only_in_lib_dir(const Filesystem& fs, const Path& dir_raw)
+    static LintStatus check_pkgconfig_dir_only_in_lib_dir(const Filesystem& fs,
+                                                          const PackageFileIndex& index,
+                                                          const Path& dir_raw)
     {
         struct MisplacedFile
         {
@@ -756,9 +876,10 @@ namespace vcpkg::PostBuildLint
         bool contains_share = false;
 
         auto dir = dir_raw.lexically_normal().generic_u8string(); // force /s
-        for (Path& path : fs.get_regular_files_recursive(dir, IgnoreErrors{}))
+        for (auto&& indexed_path : index.regular_files)
         {
-            if (!Strings::ends_with(path, ".pc")) continue;
+            if (!Strings::ends_with(indexed_path, ".pc")) continue;
+            Path path = indexed_path.lexically_normal().generic_u8string();
             // Always forbid .pc files not in a "pkgconfig" directory:
             const auto parent_path = Path(path.parent_path());
             if (parent_path.filename() != "pkgconfig") continue;
@@ -868,22 +989,14 @@ namespace vcpkg::PostBuildLint
                               bad_build_types.end());
 
         std::vector<BuildTypeAndFile> libs_with_invalid_crt;
-
-        for (const Path& lib : libs)
+        const auto outputs = run_dumpbin_in_parallel(dumpbin_exe, "/directives", libs);
+        for (size_t i = 0; i < libs.size(); ++i)
         {
-            auto cmd_line = Command(dumpbin_exe).string_arg("/directives").path_arg(lib);
-            ExitCodeAndOutput ec_data = cmd_execute_and_capture_output(cmd_line);
-            Checks::check_exit(VCPKG_LINE_INFO,
-                               ec_data.exit_code == 0,
-                               "Running command:\n   %s\n failed with message:\n%s",
-                               cmd_line.command_line(),
-                               ec_data.output);
-
             for (const BuildType& bad_build_type : bad_build_types)
             {
-                if (std::regex_search(ec_data.output.cbegin(), ec_data.output.cend(), bad_build_type.crt_regex()))
+                if (std::regex_search(outputs[i].cbegin(), outputs[i].cend(), bad_build_type.crt_regex()))
                 {
-                    libs_with_invalid_crt.push_back({lib, bad_build_type});
+                    libs_with_invalid_crt.push_back({libs[i], bad_build_type});
                     break;
                 }
             }
@@ -921,19 +1034,14 @@ namespace vcpkg::PostBuildLint
         if (build_info.policies.is_enabled(BuildPolicy::ALLOW_OBSOLETE_MSVCRT)) return LintStatus::SUCCESS;
 
         std::vector<OutdatedDynamicCrtAndFile> dlls_with_outdated_crt;
-
-        for (const Path& dll : dlls)
+        const auto outputs = run_dumpbin_in_parallel(dumpbin_exe, "/dependents", dlls);
+        for (size_t i = 0; i < dlls.size(); ++i)
         {
-            auto cmd_line = Command(dumpbin_exe).string_arg("/dependents").path_arg(dll);
-            ExitCodeAndOutput ec_data = cmd_execute_and_capture_output(cmd_line);
-            Checks::check_exit(
-                VCPKG_LINE_INFO, ec_data.exit_code == 0, "Running command:\n   %s\n failed", cmd_line.command_line());
-
             for (const OutdatedDynamicCrt& outdated_crt : get_outdated_dynamic_crts(pre_build_info.platform_toolset))
             {
-                if (std::regex_search(ec_data.output.cbegin(), ec_data.output.cend(), outdated_crt.regex))
+                if (std::regex_search(outputs[i].cbegin(), outputs[i].cend(), outdated_crt.regex))
                 {
-                    dlls_with_outdated_crt.push_back({dll, outdated_crt});
+                    dlls_with_outdated_crt.push_back({dlls[i], outdated_crt});
                     break;
                 }
             }
@@ -955,9 +1063,9 @@ namespace vcpkg::PostBuildLint
         return LintStatus::SUCCESS;
     }
 
-    static LintStatus check_no_files_in_dir(const Filesystem& fs, const Path& dir)
+    static LintStatus check_no_files_in_dir(const PackageFileIndex& index, const Path& dir)
     {
-        std::vector<Path> misplaced_files = fs.get_regular_files_non_recursive(dir, IgnoreErrors{});
+        std::vector<Path> misplaced_files = index.regular_files_in(dir);
         Util::erase_remove_if(misplaced_files, [](const Path& target) {
             const auto filename = target.filename();
             return filename == "CONTROL" || filename == "BUILD_INFO";
@@ -999,28 +1107,30 @@ namespace vcpkg::PostBuildLint
 
         auto const& ignore = LintStatus::SUCCESS;
 
+        const PackageFileIndex index(fs, package_dir);
+
         error_count += is_dbg ? ignore : check_for_files_in_include_directory(fs, build_info.policies, package_dir);
         error_count += is_dbg ? ignore : check_for_restricted_include_files(fs, build_info.policies, package_dir);
-        error_count += is_rel ? ignore : check_for_files_in_debug_include_directory(fs, package_dir);
+        error_count += is_rel ? ignore : check_for_files_in_debug_include_directory(index, package_dir);
         error_count += is_rel ? ignore : check_for_files_in_debug_share_directory(fs, package_dir);
         error_count += check_for_vcpkg_port_config(fs, build_info.policies, package_dir, spec);
         error_count += check_folder_lib_cmake(fs, package_dir, spec);
-        error_count += check_for_misplaced_cmake_files(fs, package_dir, spec);
+        error_count += check_for_misplaced_cmake_files(index, package_dir, spec);
         error_count += is_rel ? ignore : check_folder_debug_lib_cmake(fs, package_dir, spec);
-        error_count += is_dbg ? ignore : check_for_dlls_in_lib_dir(fs, package_dir);
-        error_count += is_rel ? ignore : check_for_dlls_in_lib_dir(fs, package_dir / "debug");
+        error_count += is_dbg ? ignore : check_for_dlls_in_lib_dir(index, package_dir);
+        error_count += is_rel ? ignore : check_for_dlls_in_lib_dir(index, package_dir / "debug");
         error_count += check_for_copyright_file(fs, spec, paths);
-        error_count += is_dbg ? ignore : check_for_exes(fs, package_dir);
-        error_count += is_rel ? ignore : check_for_exes(fs, package_dir / "debug");
+        error_count += is_dbg ? ignore : check_for_exes(index, package_dir);
+        error_count += is_rel ? ignore : check_for_exes(index, package_dir / "debug");
 
         const auto debug_lib_dir = package_dir / "debug" / "lib";
         const auto release_lib_dir = package_dir / "lib";
         const auto debug_bin_dir = package_dir / "debug" / "bin";
         const auto release_bin_dir = package_dir / "bin";
 
-        std::vector<Path> debug_libs = fs.get_regular_files_recursive(debug_lib_dir, IgnoreErrors{});
+        std::vector<Path> debug_libs = index.regular_files_under(debug_lib_dir);
         Util::erase_remove_if(debug_libs, NotExtensionCaseInsensitive{".lib"});
-        std::vector<Path> release_libs = fs.get_regular_files_recursive(release_lib_dir, IgnoreErrors{});
+        std::vector<Path> release_libs = index.regular_files_under(release_lib_dir);
         Util::erase_remove_if(release_libs, NotExtensionCaseInsensitive{".lib"});
 
         if (!pre_build_info.build_type && !build_info.policies.is_enabled(BuildPolicy::MISMATCHED_NUMBER_OF_BINARIES))
@@ -1034,9 +1144,9 @@ namespace vcpkg::PostBuildLint
             error_count += check_lib_architecture(pre_build_info.target_architecture, libs, fs);
         }
 
-        std::vector<Path> debug_dlls = fs.get_regular_files_recursive(debug_bin_dir, IgnoreErrors{});
+        std::vector<Path> debug_dlls = index.regular_files_under(debug_bin_dir);
         Util::erase_remove_if(debug_dlls, NotExtensionCaseInsensitive{".dll"});
-        std::vector<Path> release_dlls = fs.get_regular_files_recursive(release_bin_dir, IgnoreErrors{});
+        std::vector<Path> release_dlls = index.regular_files_under(release_bin_dir);
         Util::erase_remove_if(release_dlls, NotExtensionCaseInsensitive{".dll"});
 
         switch (build_info.library_linkage)
@@ -1096,10 +1206,10 @@ namespace vcpkg::PostBuildLint
             default: Checks::unreachable(VCPKG_LINE_INFO);
         }
 
-        error_count += check_no_empty_folders(fs, package_dir);
-        error_count += check_no_files_in_dir(fs, package_dir);
-        error_count += check_no_files_in_dir(fs, package_dir / "debug");
-        error_count += check_pkgconfig_dir_only_in_lib_dir(fs, package_dir);
+        error_count += check_no_empty_folders(fs, index, package_dir);
+        error_count += check_no_files_in_dir(index, package_dir);
+        error_count += check_no_files_in_dir(index, package_dir / "debug");
+        error_count += check_pkgconfig_dir_only_in_lib_dir(fs, index, package_dir);
 
         return error_count;
     }
@@ -1111,6 +1221,7 @@ namespace vcpkg::PostBuildLint
                               const Path& port_dir)
     {
         print2("-- Performing post-build validation\n");
+        Tracing::TraceSpan span("postbuildlint", Strings::concat("post-build checks ", spec));
         const size_t error_count = perform_all_checks_and_return_error_count(spec, paths, pre_build_info, build_info);
 
         if (error_count != 0)
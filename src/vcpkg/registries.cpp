@@ -2,9 +2,12 @@
 #include <vcpkg/base/json.h>
 #include <vcpkg/base/jsonreader.h>
 #include <vcpkg/base/messages.h>
+#include <vcpkg/base/parallel-algorithms.h>
 #include <vcpkg/base/system.debug.h>
+#include <vcpkg/base/system.h>
 #include <vcpkg/base/system.print.h>
 
+#include <vcpkg/compiledversiondb.h>
 #include <vcpkg/metrics.h>
 #include <vcpkg/paragraphs.h>
 #include <vcpkg/registries.h>
@@ -14,7 +17,9 @@
 #include <vcpkg/versiondeserializers.h>
 #include <vcpkg/versions.h>
 
+#include <atomic>
 #include <map>
+#include <mutex>
 
 namespace
 {
@@ -24,6 +29,13 @@ namespace
 
     static constexpr StringLiteral registry_versions_dir_name = "versions";
 
+    // Guards the installed lockfile, whose entries registries fetch on first use; see RegistrySet::prefetch_baselines.
+    std::mutex& lockfile_mutex()
+    {
+        static std::mutex mtx;
+        return mtx;
+    }
+
     struct GitRegistry;
 
     struct GitRegistryEntry final : RegistryEntry
@@ -67,13 +79,28 @@ namespace
 
         Optional<Version> get_baseline_version(StringView) const override;
 
+        void prefetch_baseline() const override { (void)get_baseline(); }
+
     private:
         friend struct GitRegistryEntry;
 
+        const Baseline& get_baseline() const;
+
         LockFile::Entry get_lock_entry() const
         {
-            return m_lock_entry.get(
-                [this]() { return m_paths.get_installed_lockfile().get_or_fetch(m_paths, m_repo, m_reference); });
+            return m_lock_entry.get([this]() {
+                if (auto entry = find_lock_entry().get())
+                {
+                    return *entry;
+                }
+
+                // fetch without holding the lock, so that registries in other repos can be fetched at the same time
+                print2("Fetching registry information from ", m_repo, " (", m_reference, ")...\n");
+                auto commit_id =
+                    m_paths.git_fetch_from_remote_registry(m_repo, m_reference).value_or_exit(VCPKG_LINE_INFO);
+                std::lock_guard<std::mutex> lock(lockfile_mutex());
+                return m_paths.get_installed_lockfile().insert(m_repo, m_reference, std::move(commit_id));
+            });
         }
 
         Path get_versions_tree_path() const
@@ -112,17 +139,41 @@ namespace
             bool stale;
         };
 
+        Optional<LockFile::Entry> find_lock_entry() const
+        {
+            std::lock_guard<std::mutex> lock(lockfile_mutex());
+            return m_paths.get_installed_lockfile().find(m_repo, m_reference);
+        }
+
+        // Returns the versions tree of the locked commit or, when nothing is locked yet, of the baseline commit, if it
+        // is in the local object store. Using it doesn't fetch anything; GitRegistryEntry only fetches the current
+        // versions when a version it is asked for isn't in it.
         VersionsTreePathResult get_stale_versions_tree_path() const
         {
-            auto e = get_lock_entry();
-            if (!e.stale())
+            auto maybe_entry = find_lock_entry();
+            auto entry = maybe_entry.get();
+            if (entry && !entry->stale())
             {
                 return {get_versions_tree_path(), false};
             }
             if (!m_stale_versions_tree.has_value())
             {
+                StringView stale_commit;
+                if (entry)
+                {
+                    stale_commit = entry->commit_id();
+                }
+                else if (is_git_commit_sha(m_baseline_identifier))
+                {
+                    stale_commit = m_baseline_identifier;
+                }
+                else
+                {
+                    return {get_versions_tree_path(), false};
+                }
+
                 auto maybe_tree = m_paths.git_find_object_id_for_remote_registry_path(
-                    e.commit_id(), registry_versions_dir_name.to_string());
+                    stale_commit, registry_versions_dir_name.to_string());
                 if (!maybe_tree)
                 {
                     // This could be caused by git gc or otherwise -- fall back to full fetch
@@ -284,12 +335,16 @@ namespace
 
         Optional<Version> get_baseline_version(StringView port_name) const override;
 
+        void prefetch_baseline() const override { (void)get_baseline(); }
+
         ~BuiltinGitRegistry() = default;
 
         std::string m_baseline_identifier;
         DelayedInit<Baseline> m_baseline;
 
     private:
+        const Baseline& get_baseline() const;
+
         std::unique_ptr<BuiltinFilesRegistry> m_files_impl;
 
         const VcpkgPaths& m_paths;
@@ -344,7 +399,11 @@ namespace
 
         Optional<Version> get_baseline_version(StringView) const override;
 
+        void prefetch_baseline() const override { (void)get_baseline(); }
+
     private:
+        const Baseline& get_baseline() const;
+
         const Filesystem& m_fs;
 
         Path m_path;
@@ -395,6 +454,13 @@ namespace
         }
     }
 
+    // baselines are checked out concurrently, and several registries may share one
+    Path baseline_tmp_path(const Path& destination_parent)
+    {
+        static std::atomic<size_t> next_tmp{0};
+        return destination_parent / Strings::concat("baseline.json.", get_process_id(), '-', next_tmp++, ".tmp");
+    }
+
     static ExpectedS<Path> git_checkout_baseline(const VcpkgPaths& paths, StringView commit_sha)
     {
         Filesystem& fs = paths.get_filesystem();
@@ -403,7 +469,7 @@ namespace
 
         if (!fs.exists(destination, IgnoreErrors{}))
         {
-            const auto destination_tmp = destination_parent / "baseline.json.tmp";
+            const auto destination_tmp = baseline_tmp_path(destination_parent);
             auto treeish = Strings::concat(commit_sha, ":versions/baseline.json");
             auto maybe_contents = paths.git_show(treeish, paths.root / ".git");
             if (auto contents = maybe_contents.get())
@@ -452,6 +518,55 @@ namespace
         return destination;
     }
 
+    // The baseline of a registry commit never changes, so git registries cache it by commit SHA next to the baselines
+    // that git_checkout_baseline checks out of the builtin registry.
+    Optional<std::string> read_cached_baseline(const VcpkgPaths& paths, StringView commit_sha)
+    {
+        if (!paths.maybe_buildtrees().has_value())
+        {
+            return nullopt;
+        }
+
+        std::error_code ec;
+        auto contents =
+            paths.get_filesystem().read_contents(paths.baselines_output() / commit_sha / "baseline.json", ec);
+        if (ec)
+        {
+            return nullopt;
+        }
+
+        return contents;
+    }
+
+    void write_cached_baseline(const VcpkgPaths& paths, StringView commit_sha, const std::string& contents)
+    {
+        if (!paths.maybe_buildtrees().has_value())
+        {
+            return;
+        }
+
+        auto& fs = paths.get_filesystem();
+        const auto destination_parent = paths.baselines_output() / commit_sha;
+        const auto destination_tmp = baseline_tmp_path(destination_parent);
+        std::error_code ec;
+        fs.create_directories(destination_parent, ec);
+        if (!ec)
+        {
+            fs.write_contents(destination_tmp, contents, ec);
+        }
+
+        if (!ec)
+        {
+            fs.rename(destination_tmp, destination_parent / "baseline.json", ec);
+        }
+
+        if (ec)
+        {
+            Debug::print("Failed to cache the baseline of commit ", commit_sha, ": ", ec.message(), '\n');
+            fs.remove(destination_tmp, IgnoreErrors{});
+        }
+    }
+
     // { RegistryImplementation
 
     // { BuiltinFilesRegistry::RegistryImplementation
@@ -517,6 +632,24 @@ namespace
     {
         const auto& fs = m_paths.get_filesystem();
 
+        if (auto db = m_paths.get_compiled_versions_db())
+        {
+            auto maybe_version_entries = db->get_port_versions(port_name);
+            if (auto version_entries = maybe_version_entries.get())
+            {
+                auto res = std::make_unique<BuiltinGitRegistryEntry>(m_paths);
+                res->port_name = port_name.to_string();
+                for (auto&& version_entry : *version_entries)
+                {
+                    res->port_versions.push_back(std::move(version_entry.version));
+                    res->git_trees.push_back(std::move(version_entry.git_tree));
+                }
+                return res;
+            }
+
+            return m_files_impl->get_port_entry(port_name);
+        }
+
         auto versions_path = m_paths.builtin_registry_versions / relative_path_to_versions(port_name);
         if (fs.exists(versions_path, IgnoreErrors{}))
         {
@@ -539,9 +672,9 @@ namespace
         return m_files_impl->get_port_entry(port_name);
     }
 
-    Optional<Version> BuiltinGitRegistry::get_baseline_version(StringView port_name) const
+    const Baseline& BuiltinGitRegistry::get_baseline() const
     {
-        const auto& baseline = m_baseline.get([this]() -> Baseline {
+        return m_baseline.get([this]() -> Baseline {
             auto maybe_path = git_checkout_baseline(m_paths, m_baseline_identifier);
             if (!maybe_path.has_value())
             {
@@ -557,6 +690,11 @@ namespace
                                       "Error: The baseline file at commit %s was invalid (no \"default\" field)",
                                       m_baseline_identifier);
         });
+    }
+
+    Optional<Version> BuiltinGitRegistry::get_baseline_version(StringView port_name) const
+    {
+        const auto& baseline = get_baseline();
 
         auto it = baseline.find(port_name);
         if (it != baseline.end())
@@ -580,9 +718,9 @@ namespace
     // } BuiltinGitRegistry::RegistryImplementation
 
     // { FilesystemRegistry::RegistryImplementation
-    Optional<Version> FilesystemRegistry::get_baseline_version(StringView port_name) const
+    const Baseline& FilesystemRegistry::get_baseline() const
     {
-        const auto& baseline = m_baseline.get([this]() -> Baseline {
+        return m_baseline.get([this]() -> Baseline {
             auto path_to_baseline = m_path / registry_versions_dir_name / "baseline.json";
             auto res_baseline = load_baseline_versions(m_fs, path_to_baseline, m_baseline_identifier);
             if (auto opt_baseline = res_baseline.get())
@@ -606,6 +744,11 @@ namespace
 
             Checks::exit_maybe_upgrade(VCPKG_LINE_INFO, res_baseline.error());
         });
+    }
+
+    Optional<Version> FilesystemRegistry::get_baseline_version(StringView port_name) const
+    {
+        const auto& baseline = get_baseline();
 
         auto it = baseline.find(port_name);
         if (it != baseline.end())
@@ -655,9 +798,9 @@ namespace
         fill_data_from_path(parent.m_paths.get_filesystem(), vtp.p);
     }
 
-    Optional<Version> GitRegistry::get_baseline_version(StringView port_name) const
+    const Baseline& GitRegistry::get_baseline() const
     {
-        const auto& baseline = m_baseline.get([this]() -> Baseline {
+        return m_baseline.get([this]() -> Baseline {
             // We delay baseline validation until here to give better error messages and suggestions
             if (!is_git_commit_sha(m_baseline_identifier))
             {
@@ -673,6 +816,20 @@ namespace
             }
 
             auto path_to_baseline = Path(registry_versions_dir_name.to_string()) / "baseline.json";
+            if (auto cached_contents = read_cached_baseline(m_paths, m_baseline_identifier))
+            {
+                auto res_baseline = parse_baseline_versions(*cached_contents.get(), "default", path_to_baseline);
+                if (auto opt_baseline = res_baseline.get())
+                {
+                    if (auto p = opt_baseline->get())
+                    {
+                        return std::move(*p);
+                    }
+                }
+
+                Debug::print("Ignoring the invalid cached baseline of commit ", m_baseline_identifier, '\n');
+            }
+
             auto maybe_contents = m_paths.git_show_from_remote_registry(m_baseline_identifier, path_to_baseline);
             if (!maybe_contents.has_value())
             {
@@ -714,6 +871,7 @@ namespace
             {
                 if (auto p = opt_baseline->get())
                 {
+                    write_cached_baseline(m_paths, m_baseline_identifier, *contents);
                     return std::move(*p);
                 }
                 else
@@ -736,6 +894,11 @@ namespace
                                           res_baseline.error());
             }
         });
+    }
+
+    Optional<Version> GitRegistry::get_baseline_version(StringView port_name) const
+    {
+        const auto& baseline = get_baseline();
 
         auto it = baseline.find(port_name);
         if (it != baseline.end())
@@ -837,6 +1000,9 @@ namespace
             VCPKG_LINE_INFO, maybe_version_entries.has_value(), "Error: " + maybe_version_entries.error());
         auto version_entries = std::move(maybe_version_entries).value_or_exit(VCPKG_LINE_INFO);
 
+        // replaces the stale data, if any
+        port_versions.clear();
+        git_trees.clear();
         for (auto&& version_entry : version_entries)
         {
             port_versions.push_back(version_entry.version);
@@ -1138,7 +1304,19 @@ namespace vcpkg
         return r.array_elements(arr, underlying);
     }
 
-    LockFile::Entry LockFile::get_or_fetch(const VcpkgPaths& paths, StringView repo, StringView reference)
+    LockFile::Entry LockFile::insert(StringView repo, StringView reference, std::string&& commit_id)
+    {
+        if (auto entry = find(repo, reference))
+        {
+            return *entry.get();
+        }
+
+        auto it = lockdata.emplace(repo.to_string(), EntryData{reference.to_string(), std::move(commit_id), false});
+        modified = true;
+        return {this, it};
+    }
+
+    Optional<LockFile::Entry> LockFile::find(StringView repo, StringView reference)
     {
         auto range = lockdata.equal_range(repo);
         auto it = std::find_if(range.first, range.second, [&reference](const LockDataType::value_type& repo2entry) {
@@ -1147,25 +1325,25 @@ namespace vcpkg
 
         if (it == range.second)
         {
-            print2("Fetching registry information from ", repo, " (", reference, ")...\n");
-            auto x = paths.git_fetch_from_remote_registry(repo, reference);
-            it = lockdata.emplace(repo.to_string(),
-                                  EntryData{reference.to_string(), x.value_or_exit(VCPKG_LINE_INFO), false});
-            modified = true;
+            return nullopt;
         }
 
-        return {this, it};
+        return Entry{this, it};
     }
     void LockFile::Entry::ensure_up_to_date(const VcpkgPaths& paths) const
     {
+        std::unique_lock<std::mutex> lock(lockfile_mutex());
         if (data->second.stale)
         {
+            // the key and reference of an entry never change, so they can be read without the lock
             StringView repo(data->first);
             StringView reference(data->second.reference);
+            lock.unlock();
             print2("Fetching registry information from ", repo, " (", reference, ")...\n");
+            auto commit_id = paths.git_fetch_from_remote_registry(repo, reference).value_or_exit(VCPKG_LINE_INFO);
 
-            data->second.commit_id =
-                paths.git_fetch_from_remote_registry(repo, reference).value_or_exit(VCPKG_LINE_INFO);
+            lock.lock();
+            data->second.commit_id = std::move(commit_id);
             data->second.stale = false;
             lockfile->modified = true;
         }
@@ -1198,6 +1376,23 @@ namespace vcpkg
         return impl->get_baseline_version(port_name);
     }
 
+    void RegistrySet::prefetch_baselines(View<std::string> port_names) const
+    {
+        std::vector<const RegistryImplementation*> implementations;
+        for (auto&& port_name : port_names)
+        {
+            if (auto implementation = registry_for_port(port_name))
+            {
+                implementations.push_back(implementation);
+            }
+        }
+
+        Util::sort_unique_erase(implementations);
+        parallel_for_each_n(implementations.begin(),
+                            implementations.size(),
+                            [](const RegistryImplementation* implementation) { implementation->prefetch_baseline(); });
+    }
+
     bool RegistrySet::is_default_builtin_registry() const
     {
         return default_registry_ && default_registry_->kind() == BuiltinFilesRegistry::s_kind;
@@ -1207,6 +1402,21 @@ namespace vcpkg
     ExpectedS<std::vector<std::pair<SchemedVersion, std::string>>> get_builtin_versions(const VcpkgPaths& paths,
                                                                                         StringView port_name)
     {
+        if (auto db = paths.get_compiled_versions_db())
+        {
+            auto maybe_entries = db->get_port_versions(port_name);
+            if (auto entries = maybe_entries.get())
+            {
+                return Util::fmap(*entries, [](VersionDbEntry& entry) {
+                    return std::make_pair(SchemedVersion{entry.scheme, std::move(entry.version)},
+                                          std::move(entry.git_tree));
+                });
+            }
+
+            return Strings::format("Couldn't find the versions database file: %s",
+                                   paths.builtin_registry_versions / relative_path_to_versions(port_name));
+        }
+
         auto maybe_versions =
             load_versions_file(paths.get_filesystem(), VersionDbType::Git, paths.builtin_registry_versions, port_name);
         if (auto pversions = maybe_versions.get())
@@ -1222,6 +1432,11 @@ namespace vcpkg
 
     ExpectedS<Baseline> get_builtin_baseline(const VcpkgPaths& paths)
     {
+        if (auto db = paths.get_compiled_versions_db())
+        {
+            return db->get_baseline();
+        }
+
         return load_baseline_versions(paths.get_filesystem(), paths.builtin_registry_versions / "baseline.json")
             .then([&](Optional<Baseline>&& b) -> ExpectedS<Baseline> {
                 if (auto p = b.get())
@@ -1233,6 +1448,36 @@ namespace vcpkg
             });
     }
 
+    ExpectedS<std::string> compile_versions_db(const Filesystem& fs,
+                                               const Path& registry_versions,
+                                               StringView source_key)
+    {
+        std::vector<std::string> port_names;
+        load_all_port_names_from_registry_versions(port_names, fs, registry_versions);
+        std::vector<CompiledVersionDb::PortVersions> ports;
+        ports.reserve(port_names.size());
+        for (auto&& port_name : port_names)
+        {
+            auto maybe_entries = load_versions_file(fs, VersionDbType::Git, registry_versions, port_name);
+            if (auto entries = maybe_entries.get())
+            {
+                ports.push_back({std::move(port_name), std::move(*entries)});
+            }
+            else
+            {
+                return {maybe_entries.error(), expected_right_tag};
+            }
+        }
+
+        auto maybe_baseline = load_baseline_versions(fs, registry_versions / "baseline.json");
+        if (auto baseline = maybe_baseline.get())
+        {
+            return CompiledVersionDb::compile(std::move(ports), baseline->value_or(Baseline{}), source_key);
+        }
+
+        return {maybe_baseline.error(), expected_right_tag};
+    }
+
     bool is_git_commit_sha(StringView sv)
     {
         static constexpr struct
@@ -1,3 +1,4 @@
+#include <vcpkg/base/parallel-algorithms.h>
 #include <vcpkg/base/system.print.h>
 #include <vcpkg/base/util.h>
 
@@ -13,6 +14,8 @@
 #include <vcpkg/vcpkglib.h>
 #include <vcpkg/vcpkgpaths.h>
 
+#include <numeric>
+
 namespace vcpkg::Remove
 {
     using Dependencies::RemovePlanAction;
@@ -20,77 +23,143 @@ namespace vcpkg::Remove
     using Dependencies::RequestType;
     using Update::OutdatedPackage;
 
-    static void remove_package(Filesystem& fs,
-                               const InstalledPaths& installed,
-                               const PackageSpec& spec,
-                               StatusParagraphs* status_db)
+    namespace
     {
-        auto maybe_ipv = status_db->get_installed_package_view(spec);
-
-        Checks::check_exit(
-            VCPKG_LINE_INFO, maybe_ipv.has_value(), "unable to remove package %s: already removed", spec);
-
-        auto&& ipv = maybe_ipv.value_or_exit(VCPKG_LINE_INFO);
+        struct PackageRemoval
+        {
+            std::vector<StatusParagraph> spghs;
+            Path listfile;
+        };
 
-        std::vector<StatusParagraph> spghs;
-        spghs.emplace_back(*ipv.core);
-        for (auto&& feature : ipv.features)
+        enum class RemovedEntryKind
         {
-            spghs.emplace_back(*feature);
-        }
+            FILE,
+            DIRECTORY,
+        };
 
-        for (auto&& spgh : spghs)
+        struct RemovedEntry
         {
-            spgh.want = Want::PURGE;
-            spgh.state = InstallState::HALF_INSTALLED;
-            write_update(fs, installed, spgh);
+            Path target;
+            // index of the package that listed this entry
+            size_t removal = 0;
+            ElapsedTime::duration elapsed{};
+            RemovedEntryKind kind = RemovedEntryKind::FILE;
+            std::string error;
+            Color error_color = Color::error;
+        };
+
+        PackageRemoval begin_package_removal(const InstalledPaths& installed,
+                                            const PackageSpec& spec,
+                                            StatusParagraphs* status_db)
+        {
+            auto maybe_ipv = status_db->get_installed_package_view(spec);
+
+            Checks::check_exit(
+                VCPKG_LINE_INFO, maybe_ipv.has_value(), "unable to remove package %s: already removed", spec);
+
+            auto&& ipv = maybe_ipv.value_or_exit(VCPKG_LINE_INFO);
+
+            PackageRemoval removal;
+            removal.listfile = installed.listfile_path(ipv.core->package);
+            removal.spghs.emplace_back(*ipv.core);
+            for (auto&& feature : ipv.features)
+            {
+                removal.spghs.emplace_back(*feature);
+            }
+
+            for (auto&& spgh : removal.spghs)
+            {
+                spgh.want = Want::PURGE;
+                spgh.state = InstallState::HALF_INSTALLED;
+            }
+
+            return removal;
         }
 
-        std::error_code ec;
-        auto lines = fs.read_lines(installed.listfile_path(ipv.core->package), ec);
-        if (!ec)
+        void remove_listed_entry(Filesystem& fs, RemovedEntry& entry)
         {
-            std::vector<Path> dirs_touched;
-            for (auto&& suffix : lines)
+            std::error_code ec;
+            const auto status = fs.symlink_status(entry.target, ec);
+            if (ec)
             {
-                auto target = installed.root() / suffix;
+                entry.error = Strings::concat("failed: symlink_status(", entry.target, "): ", ec.message(), "\n");
+                return;
+            }
 
-                const auto status = fs.symlink_status(target, ec);
+            if (vcpkg::is_directory(status))
+            {
+                entry.kind = RemovedEntryKind::DIRECTORY;
+            }
+            else if (vcpkg::is_regular_file(status) || vcpkg::is_symlink(status))
+            {
+                fs.remove(entry.target, ec);
                 if (ec)
                 {
-                    print2(Color::error, "failed: symlink_status(", target, "): ", ec.message(), "\n");
-                    continue;
+                    entry.error = Strings::format("failed: remove(%s): %s\n", entry.target, ec.message());
                 }
+            }
+            else if (vcpkg::exists(status))
+            {
+                entry.error = Strings::format("Warning: %s: cannot handle file type\n", entry.target);
+                entry.error_color = Color::warning;
+            }
+            else
+            {
+                entry.error = Strings::format("Warning: %s: file not found\n", entry.target);
+                entry.error_color = Color::warning;
+            }
+        }
 
-                if (vcpkg::is_directory(status))
-                {
-                    dirs_touched.push_back(target);
-                }
-                else if (vcpkg::is_regular_file(status) || vcpkg::is_symlink(status))
+        // Removes the files of all packages concurrently, then the directories they leave empty, deepest first.
+        // Returns the time spent removing the files of each package.
+        std::vector<ElapsedTime> remove_installed_files(Filesystem& fs,
+                                                        const InstalledPaths& installed,
+                                                        View<PackageRemoval> removals)
+        {
+            std::vector<RemovedEntry> entries;
+            for (size_t idx = 0; idx < removals.size(); ++idx)
+            {
+                std::error_code ec;
+                auto lines = fs.read_lines(removals[idx].listfile, ec);
+                if (ec) continue;
+                for (auto&& suffix : lines)
                 {
-                    fs.remove(target, ec);
-                    if (ec)
-                    {
-                        vcpkg::printf(Color::error, "failed: remove(%s): %s\n", target, ec.message());
-                    }
+                    entries.push_back(RemovedEntry{installed.root() / suffix, idx});
                 }
-                else if (vcpkg::exists(status))
+            }
+
+            parallel_for_each_n(entries.begin(), entries.size(), [&fs](RemovedEntry& entry) {
+                const auto timer = ElapsedTimer::create_started();
+                remove_listed_entry(fs, entry);
+                entry.elapsed = timer.elapsed().as<ElapsedTime::duration>();
+            });
+
+            std::vector<ElapsedTime::duration> elapsed(removals.size());
+            std::vector<Path> dirs_touched;
+            for (auto&& entry : entries)
+            {
+                elapsed[entry.removal] += entry.elapsed;
+                if (!entry.error.empty())
                 {
-                    vcpkg::printf(Color::warning, "Warning: %s: cannot handle file type\n", target);
+                    print2(entry.error_color, entry.error);
                 }
-                else
+                else if (entry.kind == RemovedEntryKind::DIRECTORY)
                 {
-                    vcpkg::printf(Color::warning, "Warning: %s: file not found\n", target);
+                    dirs_touched.push_back(std::move(entry.target));
                 }
             }
 
-            auto b = dirs_touched.rbegin();
-            const auto e = dirs_touched.rend();
-            for (; b != e; ++b)
+            // Sorting in descending order places every directory before its parent.
+            std::sort(dirs_touched.begin(), dirs_touched.end(), [](const Path& lhs, const Path& rhs) {
+                return lhs.native() > rhs.native();
+            });
+            dirs_touched.erase(std::unique(dirs_touched.begin(), dirs_touched.end()), dirs_touched.end());
+            for (auto&& dir : dirs_touched)
             {
-                if (fs.is_empty(*b, IgnoreErrors{}))
+                if (fs.is_empty(dir, IgnoreErrors{}))
                 {
-                    fs.remove(*b, ec);
+                    std::error_code ec;
+                    fs.remove(dir, ec);
                     if (ec)
                     {
                         print2(Color::error, "failed: ", ec.message(), "\n");
@@ -98,16 +167,52 @@ namespace vcpkg::Remove
                 }
             }
 
-            fs.remove(installed.listfile_path(ipv.core->package), VCPKG_LINE_INFO);
+            for (auto&& removal : removals)
+            {
+                fs.remove(removal.listfile, IgnoreErrors{});
+            }
+
+            return Util::fmap(elapsed, [](ElapsedTime::duration d) { return ElapsedTime(d); });
+        }
+    }
+
+    std::vector<ElapsedTime> remove_installed_packages(Filesystem& fs,
+                                                       const InstalledPaths& installed,
+                                                       View<PackageSpec> specs,
+                                                       StatusParagraphs* status_db)
+    {
+        if (specs.size() == 0)
+        {
+            return {};
+        }
+
+        auto removals = Util::fmap(specs, [&](const PackageSpec& spec) {
+            return begin_package_removal(installed, spec, status_db);
+        });
+
+        // All status changes are committed as a single update: first every package is marked half-installed, then
+        // after the files are gone every package is marked not-installed.
+        std::vector<StatusParagraph> all_spghs;
+        for (auto&& removal : removals)
+        {
+            Util::Vectors::append(&all_spghs, removal.spghs);
         }
 
-        for (auto&& spgh : spghs)
+        write_update(fs, installed, all_spghs);
+        auto timings = remove_installed_files(fs, installed, removals);
+
+        for (auto&& spgh : all_spghs)
         {
             spgh.state = InstallState::NOT_INSTALLED;
-            write_update(fs, installed, spgh);
+        }
 
+        write_update(fs, installed, all_spghs);
+        for (auto&& spgh : all_spghs)
+        {
             status_db->insert(std::make_unique<StatusParagraph>(std::move(spgh)));
         }
+
+        return timings;
     }
 
     static void print_plan(const std::map<RemovePlanType, std::vector<const RemovePlanAction*>>& group_by_plan_type)
@@ -141,32 +246,62 @@ namespace vcpkg::Remove
         }
     }
 
-    void perform_remove_plan_action(const VcpkgPaths& paths,
-                                    const RemovePlanAction& action,
-                                    const Purge purge,
-                                    StatusParagraphs* status_db)
+    std::vector<ElapsedTime> perform_remove_plan(const VcpkgPaths& paths,
+                                                 View<RemovePlanAction> actions,
+                                                 const Purge purge,
+                                                 StatusParagraphs* status_db)
     {
         Filesystem& fs = paths.get_filesystem();
 
-        const std::string display_name = action.spec.to_string();
+        std::vector<size_t> removed_actions;
+        for (size_t idx = 0; idx < actions.size(); ++idx)
+        {
+            auto& action = actions[idx];
+            switch (action.plan_type)
+            {
+                case RemovePlanType::NOT_INSTALLED:
+                    vcpkg::printf(Color::success, "Package %s is not installed\n", action.spec.to_string());
+                    break;
+                case RemovePlanType::REMOVE:
+                    vcpkg::printf("Removing package %s...\n", action.spec.to_string());
+                    removed_actions.push_back(idx);
+                    break;
+                case RemovePlanType::UNKNOWN:
+                default: Checks::unreachable(VCPKG_LINE_INFO);
+            }
+        }
 
-        switch (action.plan_type)
+        std::vector<ElapsedTime::duration> elapsed(actions.size());
+        const auto removed_timings = remove_installed_packages(
+            fs,
+            paths.installed(),
+            Util::fmap(removed_actions, [&](size_t idx) { return actions[idx].spec; }),
+            status_db);
+        for (size_t i = 0; i < removed_actions.size(); ++i)
         {
-            case RemovePlanType::NOT_INSTALLED:
-                vcpkg::printf(Color::success, "Package %s is not installed\n", display_name);
-                break;
-            case RemovePlanType::REMOVE:
-                vcpkg::printf("Removing package %s...\n", display_name);
-                remove_package(fs, paths.installed(), action.spec, status_db);
-                break;
-            case RemovePlanType::UNKNOWN:
-            default: Checks::unreachable(VCPKG_LINE_INFO);
+            elapsed[removed_actions[i]] += removed_timings[i].as<ElapsedTime::duration>();
         }
 
         if (purge == Purge::YES)
         {
-            fs.remove_all(paths.packages() / action.spec.dir(), VCPKG_LINE_INFO);
+            std::vector<size_t> purged(actions.size());
+            std::iota(purged.begin(), purged.end(), size_t(0));
+            parallel_for_each_n(purged.begin(), purged.size(), [&](size_t idx) {
+                const auto timer = ElapsedTimer::create_started();
+                fs.remove_all(paths.packages() / actions[idx].spec.dir(), VCPKG_LINE_INFO);
+                elapsed[idx] += timer.elapsed().as<ElapsedTime::duration>();
+            });
         }
+
+        return Util::fmap(elapsed, [](ElapsedTime::duration d) { return ElapsedTime(d); });
+    }
+
+    void perform_remove_plan_action(const VcpkgPaths& paths,
+                                    const RemovePlanAction& action,
+                                    const Purge purge,
+                                    StatusParagraphs* status_db)
+    {
+        (void)perform_remove_plan(paths, {&action, 1}, purge, status_db);
     }
 
     static constexpr StringLiteral OPTION_PURGE = "purge";
@@ -308,10 +443,7 @@ namespace vcpkg::Remove
             Checks::exit_success(VCPKG_LINE_INFO);
         }
 
-        for (const RemovePlanAction& action : remove_plan)
-        {
-            perform_remove_plan_action(paths, action, purge, &status_db);
-        }
+        (void)perform_remove_plan(paths, remove_plan, purge, &status_db);
 
         Checks::exit_success(VCPKG_LINE_INFO);
     }
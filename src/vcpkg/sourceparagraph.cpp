@@ -483,6 +483,60 @@ namespace vcpkg
         return control_file;
     }
 
+    ParseExpected<PortIdentity> PortIdentity::parse_control_file(StringView origin,
+                                                                 std::vector<Parse::Paragraph>&& control_paragraphs)
+    {
+        if (control_paragraphs.size() == 0)
+        {
+            auto ret = std::make_unique<Parse::ParseControlErrorInfo>();
+            ret->name = origin.to_string();
+            return ret;
+        }
+
+        // only the identity fields are handed to the parser, so the others aren't reported as unexpected
+        auto& source_fields = control_paragraphs.front();
+        Paragraph identity_fields;
+        for (auto&& field : {SourceParagraphFields::NAME,
+                             SourceParagraphFields::VERSION,
+                             SourceParagraphFields::PORT_VERSION})
+        {
+            auto it = source_fields.find(field);
+            if (it != source_fields.end())
+            {
+                identity_fields.insert(std::move(*it));
+            }
+        }
+
+        ParagraphParser parser(std::move(identity_fields));
+        auto identity = std::make_unique<PortIdentity>();
+        parser.required_field(SourceParagraphFields::NAME, identity->name);
+        std::string raw_version;
+        parser.required_field(SourceParagraphFields::VERSION, raw_version);
+        int port_version = 0;
+        auto pv_str = parser.optional_field(SourceParagraphFields::PORT_VERSION);
+        if (!pv_str.empty())
+        {
+            auto pv_opt = Strings::strto<int>(pv_str);
+            if (auto pv = pv_opt.get())
+            {
+                port_version = *pv;
+            }
+            else
+            {
+                parser.add_type_error(SourceParagraphFields::PORT_VERSION, "a non-negative integer");
+            }
+        }
+
+        if (auto err = parser.error_info(identity->name.empty() ? origin : identity->name))
+        {
+            return err;
+        }
+
+        identity->schemed_version =
+            SchemedVersion{VersionScheme::String, Version{std::move(raw_version), port_version}};
+        return identity;
+    }
+
     struct PlatformExprDeserializer : Json::IDeserializer<PlatformExpression::Expr>
     {
         virtual StringView type_name() const override { return "a platform expression"; }
@@ -788,6 +842,41 @@ namespace vcpkg
     };
     ContactsDeserializer ContactsDeserializer::instance;
 
+    static constexpr char ascii_tolower(char ch)
+    {
+        return ch >= 'A' && ch <= 'Z' ? static_cast<char>(ch - 'A' + 'a') : ch;
+    }
+
+    static constexpr bool case_insensitive_ascii_less(StringView lhs, StringView rhs)
+    {
+        const size_t common = lhs.size() < rhs.size() ? lhs.size() : rhs.size();
+        for (size_t i = 0; i < common; ++i)
+        {
+            const char l = ascii_tolower(lhs.byte_at_index(i));
+            const char r = ascii_tolower(rhs.byte_at_index(i));
+            if (l != r)
+            {
+                return l < r;
+            }
+        }
+
+        return lhs.size() < rhs.size();
+    }
+
+    template<size_t N>
+    static constexpr bool is_case_insensitive_ascii_sorted(const StringLiteral (&lst)[N])
+    {
+        for (size_t i = 1; i < N; ++i)
+        {
+            if (!case_insensitive_ascii_less(lst[i - 1], lst[i]))
+            {
+                return false;
+            }
+        }
+
+        return true;
+    }
+
     static constexpr StringLiteral VALID_LICENSES[] = {
 #include "spdx-licenses.inc"
     };
@@ -795,6 +884,10 @@ namespace vcpkg
 #include "spdx-exceptions.inc"
     };
 
+    // Generate-SpdxLicenseList.ps1 sorts the lists so that identifiers can be binary searched
+    static_assert(is_case_insensitive_ascii_sorted(VALID_LICENSES), "spdx-licenses.inc must be sorted");
+    static_assert(is_case_insensitive_ascii_sorted(VALID_EXCEPTIONS), "spdx-exceptions.inc must be sorted");
+
     // The "license" field; either:
     // * a string, which must be an SPDX license expression.
     //   EBNF located at: https://github.com/microsoft/vcpkg/blob/master/docs/maintainers/manifest-files.md#license
@@ -803,10 +896,16 @@ namespace vcpkg
     {
         SpdxLicenseExpressionParser(StringView sv, StringView origin) : Parse::ParserBase(sv, origin) { }
 
-        static const StringLiteral* case_insensitive_find(View<StringLiteral> lst, StringView id)
+        template<size_t N>
+        static const StringLiteral* case_insensitive_find(const StringLiteral (&lst)[N], StringView id)
         {
-            return Util::find_if(lst,
-                                 [id](StringLiteral el) { return Strings::case_insensitive_ascii_equals(id, el); });
+            auto it = std::lower_bound(std::begin(lst), std::end(lst), id, case_insensitive_ascii_less);
+            if (it != std::end(lst) && !case_insensitive_ascii_less(id, *it))
+            {
+                return it;
+            }
+
+            return std::end(lst);
         }
         static constexpr bool is_idstring_element(char32_t ch) { return is_alphanumdash(ch) || ch == '.'; }
 
@@ -923,6 +1022,8 @@ namespace vcpkg
 
             Expecting expecting = Expecting::License;
             std::string result;
+            // tokens are views into the expression; the normalized result is about as long as the expression
+            result.reserve(text().size());
 
             size_t open_parens = 0;
             while (!at_eof())
@@ -1232,6 +1333,25 @@ namespace vcpkg
     };
     ManifestConfigurationDeserializer ManifestConfigurationDeserializer::instance;
 
+    // Extracts just the name and version from a manifest object
+    struct ManifestIdentityDeserializer final : Json::IDeserializer<PortIdentity>
+    {
+        virtual StringView type_name() const override { return "a manifest"; }
+
+        virtual Optional<PortIdentity> visit_object(Json::Reader& r, const Json::Object& obj) override
+        {
+            Optional<PortIdentity> x;
+            PortIdentity& ret = x.emplace();
+            r.required_object_field(
+                type_name(), obj, ManifestDeserializer::NAME, ret.name, Json::IdentifierDeserializer::instance);
+            ret.schemed_version = visit_required_schemed_deserializer(type_name(), r, obj, false);
+            return x;
+        }
+
+        static ManifestIdentityDeserializer instance;
+    };
+    ManifestIdentityDeserializer ManifestIdentityDeserializer::instance;
+
     ExpectedS<struct ManifestConfiguration> parse_manifest_configuration(StringView origin,
                                                                          const Json::Object& manifest)
     {
@@ -1292,6 +1412,30 @@ namespace vcpkg
         }
     }
 
+    Parse::ParseExpected<PortIdentity> PortIdentity::parse_manifest_object(StringView origin,
+                                                                           const Json::Object& manifest)
+    {
+        Json::Reader reader;
+
+        auto res = reader.visit(manifest, ManifestIdentityDeserializer::instance);
+
+        if (!reader.errors().empty())
+        {
+            auto err = std::make_unique<ParseControlErrorInfo>();
+            err->name = origin.to_string();
+            err->other_errors = std::move(reader.errors());
+            return err;
+        }
+        else if (auto p = res.get())
+        {
+            return std::make_unique<PortIdentity>(std::move(*p));
+        }
+        else
+        {
+            Checks::unreachable(VCPKG_LINE_INFO);
+        }
+    }
+
     Optional<std::string> SourceControlFile::check_against_feature_flags(const Path& origin,
                                                                          const FeatureFlagSettings& flags,
                                                                          bool is_default_builtin_registry) const
@@ -1510,9 +1654,10 @@ namespace vcpkg
                                                      ImplicitDefault id)
     {
         std::vector<FullPackageSpec> ret;
+        const auto context = PlatformExpression::EvaluationContext::from_cmake_vars(cmake_vars);
         for (auto&& dep : deps)
         {
-            if (dep.platform.evaluate(cmake_vars))
+            if (dep.platform.evaluate(context))
             {
                 ret.emplace_back(dep.to_full_spec(target, host, compile_triplet, id));
             }
@@ -23,16 +23,21 @@ namespace vcpkg
             .push_back('\n');
     }
 
-    StatusParagraph::StatusParagraph(Parse::Paragraph&& fields)
+    StatusParagraph::StatusParagraph(Parse::Paragraph&& fields) : StatusParagraph(Parse::to_field_views(fields)) { }
+
+    StatusParagraph::StatusParagraph(View<Parse::ParagraphFieldView> fields)
         : want(Want::ERROR_STATE), state(InstallState::ERROR_STATE)
     {
-        auto status_it = fields.find(BinaryParagraphRequiredField::STATUS);
+        auto status_it = Util::find_if(fields, [](const Parse::ParagraphFieldView& field) {
+            return field.name == BinaryParagraphRequiredField::STATUS;
+        });
         Checks::check_maybe_upgrade(
             VCPKG_LINE_INFO, status_it != fields.end(), "Expected 'Status' field in status paragraph");
-        std::string status_field = std::move(status_it->second.first);
-        fields.erase(status_it);
+        std::string status_field = status_it->value();
 
-        this->package = BinaryParagraph(std::move(fields));
+        std::vector<Parse::ParagraphFieldView> package_fields(fields.begin(), status_it);
+        package_fields.insert(package_fields.end(), status_it + 1, fields.end());
+        this->package = BinaryParagraph(package_fields);
 
         auto b = status_field.begin();
         const auto mark = b;
@@ -12,6 +12,8 @@
 #include <vcpkg/tools.h>
 #include <vcpkg/vcpkgpaths.h>
 
+#include <mutex>
+
 namespace vcpkg
 {
     struct ToolData
@@ -674,11 +676,14 @@ aws-cli/2.4.4 Python/3.8.8 Windows/10 exe/AMD64 prompt/off
         vcpkg::Cache<std::string, Path> system_cache;
         vcpkg::Cache<std::string, Path> path_only_cache;
         vcpkg::Cache<std::string, PathAndVersion> path_version_cache;
+        // the caches are filled on first use, possibly from several threads; get_tool_path is reentrant
+        mutable std::recursive_mutex cache_mutex;
 
         ToolCacheImpl(RequireExactVersions abiToolVersionHandling) : abiToolVersionHandling(abiToolVersionHandling) { }
 
         virtual const Path& get_tool_path_from_system(const Filesystem& fs, const std::string& tool) const override
         {
+            std::lock_guard<std::recursive_mutex> lock(cache_mutex);
             return system_cache.get_lazy(tool, [&] {
                 if (tool == Tools::TAR)
                 {
@@ -706,6 +711,7 @@ aws-cli/2.4.4 Python/3.8.8 Windows/10 exe/AMD64 prompt/off
 
         virtual const Path& get_tool_path(const VcpkgPaths& paths, const std::string& tool) const override
         {
+            std::lock_guard<std::recursive_mutex> lock(cache_mutex);
             return path_only_cache.get_lazy(tool, [&]() {
                 if (tool == Tools::IFW_BINARYCREATOR)
                 {
@@ -727,6 +733,7 @@ aws-cli/2.4.4 Python/3.8.8 Windows/10 exe/AMD64 prompt/off
 
         const PathAndVersion& get_tool_pathversion(const VcpkgPaths& paths, const std::string& tool) const
         {
+            std::lock_guard<std::recursive_mutex> lock(cache_mutex);
             return path_version_cache.get_lazy(tool, [&]() -> PathAndVersion {
                 // First deal with specially handled tools.
                 // For these we may look in locations like Program Files, the PATH etc as well as the auto-downloaded
@@ -25,11 +25,10 @@ namespace vcpkg::Update
         for (auto&& ipv : installed_packages)
         {
             const auto& pgh = ipv.core;
-            auto maybe_scfl = provider.get_control_file(pgh->package.spec.name());
-            if (auto p_scfl = maybe_scfl.get())
+            auto maybe_latest_version = provider.get_port_version(pgh->package.spec.name());
+            if (auto p_latest_version = maybe_latest_version.get())
             {
-                const auto& latest_pgh = *p_scfl->source_control_file->core_paragraph;
-                auto latest_version = Version(latest_pgh.raw_version, latest_pgh.port_version);
+                auto& latest_version = *p_latest_version;
                 auto installed_version = Version(pgh->package.version, pgh->package.port_version);
                 if (latest_version != installed_version)
                 {
@@ -295,6 +295,7 @@ namespace vcpkg
                     {BUILTIN_REGISTRY_VERSIONS_DIR_ARG, &VcpkgCmdArguments::builtin_registry_versions_dir},
                     {ASSET_SOURCES_ARG, &VcpkgCmdArguments::asset_sources_template_arg},
                     {BIN2STH_COMPILE_TRIPLET_ARG, &VcpkgCmdArguments::bin2sth_compile_triplet},
+                    {TRACE_FILE_ARG, &VcpkgCmdArguments::trace_file},
                 };
 
             constexpr static std::pair<StringView, std::vector<std::string> VcpkgCmdArguments::*>
@@ -663,6 +664,8 @@ namespace vcpkg
         table.format(opt(INSTALL_ROOT_DIR_ARG, "=", "<path>"), "(Experimental) Specify the install root directory");
         table.format(opt(PACKAGES_ROOT_DIR_ARG, "=", "<path>"), "(Experimental) Specify the packages root directory");
         table.format(opt(JSON_SWITCH, "", ""), "(Experimental) Request JSON output");
+        table.format(opt(TRACE_FILE_ARG, "=", "<path>"),
+                     "(Experimental) Write a Chrome trace event file describing where time was spent");
     }
 
     static void from_env(const std::function<Optional<std::string>(ZStringView)>& f,
@@ -1073,6 +1076,7 @@ namespace vcpkg
     constexpr StringLiteral VcpkgCmdArguments::IGNORE_LOCK_FAILURES_ENV;
 
     constexpr StringLiteral VcpkgCmdArguments::JSON_SWITCH;
+    constexpr StringLiteral VcpkgCmdArguments::TRACE_FILE_ARG;
 
     constexpr StringLiteral VcpkgCmdArguments::ASSET_SOURCES_ENV;
     constexpr StringLiteral VcpkgCmdArguments::ASSET_SOURCES_ARG;
@@ -10,6 +10,24 @@
 
 namespace vcpkg
 {
+    // Reads each paragraph of the status file `path` straight into a StatusParagraph
+    template<class F>
+    static void load_status_paragraphs(const Filesystem& fs, const Path& path, F on_status_paragraph)
+    {
+        const std::string contents = fs.read_contents(path, VCPKG_LINE_INFO);
+        Paragraphs::ParagraphTokenizer tokenizer(contents, path);
+        std::vector<Parse::ParagraphFieldView> fields;
+        while (tokenizer.next(fields))
+        {
+            on_status_paragraph(std::make_unique<StatusParagraph>(fields));
+        }
+
+        if (auto error = tokenizer.error())
+        {
+            Checks::exit_with_message(VCPKG_LINE_INFO, *error);
+        }
+    }
+
     static StatusParagraphs load_current_database(Filesystem& fs,
                                                   const Path& vcpkg_dir_status_file,
                                                   const Path& vcpkg_dir_status_file_old)
@@ -25,13 +43,10 @@ namespace vcpkg
             fs.rename(vcpkg_dir_status_file_old, vcpkg_dir_status_file, VCPKG_LINE_INFO);
         }
 
-        auto pghs = Paragraphs::get_paragraphs(fs, vcpkg_dir_status_file).value_or_exit(VCPKG_LINE_INFO);
-
         std::vector<std::unique_ptr<StatusParagraph>> status_pghs;
-        for (auto&& p : pghs)
-        {
-            status_pghs.push_back(std::make_unique<StatusParagraph>(std::move(p)));
-        }
+        load_status_paragraphs(fs, vcpkg_dir_status_file, [&](std::unique_ptr<StatusParagraph>&& pgh) {
+            status_pghs.push_back(std::move(pgh));
+        });
 
         return StatusParagraphs(std::move(status_pghs));
     }
@@ -63,11 +78,9 @@ namespace vcpkg
         {
             if (file.filename() == "incomplete") continue;
 
-            auto pghs = Paragraphs::get_paragraphs(fs, file).value_or_exit(VCPKG_LINE_INFO);
-            for (auto&& p : pghs)
-            {
-                current_status_db.insert(std::make_unique<StatusParagraph>(std::move(p)));
-            }
+            load_status_paragraphs(fs, file, [&](std::unique_ptr<StatusParagraph>&& pgh) {
+                current_status_db.insert(std::move(pgh));
+            });
         }
 
         fs.write_contents(status_file_new, Strings::serialize(current_status_db), VCPKG_LINE_INFO);
@@ -82,14 +95,34 @@ namespace vcpkg
         return current_status_db;
     }
 
-    void write_update(Filesystem& fs, const InstalledPaths& installed, const StatusParagraph& p)
+    static Path next_update_path(const InstalledPaths& installed)
     {
         static std::atomic<int> update_id = 0;
 
         const auto my_update_id = update_id++;
-        const auto update_path = installed.vcpkg_dir_updates() / Strings::format("%010d", my_update_id);
+        return installed.vcpkg_dir_updates() / Strings::format("%010d", my_update_id);
+    }
+
+    void write_update(Filesystem& fs, const InstalledPaths& installed, const StatusParagraph& p)
+    {
+        fs.write_rename_contents(next_update_path(installed), "incomplete", Strings::serialize(p), VCPKG_LINE_INFO);
+    }
+
+    void write_update(Filesystem& fs, const InstalledPaths& installed, View<StatusParagraph> pghs)
+    {
+        if (pghs.size() == 0)
+        {
+            return;
+        }
+
+        std::string contents;
+        for (auto&& p : pghs)
+        {
+            serialize(p, contents);
+            contents.push_back('\n');
+        }
 
-        fs.write_rename_contents(update_path, "incomplete", Strings::serialize(p), VCPKG_LINE_INFO);
+        fs.write_rename_contents(next_update_path(installed), "incomplete", contents, VCPKG_LINE_INFO);
     }
 
     static void upgrade_to_slash_terminated_sorted_format(Filesystem& fs,
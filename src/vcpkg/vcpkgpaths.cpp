@@ -1,3 +1,4 @@
+#include <vcpkg/base/delayed_init.h>
 #include <vcpkg/base/downloads.h>
 #include <vcpkg/base/expected.h>
 #include <vcpkg/base/files.h>
@@ -14,6 +15,7 @@
 #include <vcpkg/build.h>
 #include <vcpkg/commands.h>
 #include <vcpkg/commands.version.h>
+#include <vcpkg/compiledversiondb.h>
 #include <vcpkg/compilation-flags-factory.h>
 #include <vcpkg/compile-triplet.h>
 #include <vcpkg/compiler-info.h>
@@ -365,6 +367,7 @@ namespace vcpkg
             Lazy<std::string> ports_cmake_hash;
             Cache<Triplet, Path> m_triplets_cache;
             Optional<LockFile> m_installed_lock;
+            DelayedInit<Optional<CompiledVersionDb>> m_compiled_versions_db;
         };
 
         // This structure holds members that
@@ -695,11 +698,35 @@ namespace vcpkg
         }
 
         vcpkg_bin2sth_compiler_config_dir = root / "bin2sth" / "compilers";
+        vcpkg_bin2sth_compiler_index = root / "bin2sth" / "compilers.json";
     }
 
     Path VcpkgPaths::package_dir(const PackageSpec& spec) const { return this->packages() / spec.dir(); }
-    Path VcpkgPaths::build_dir(const PackageSpec& spec) const { return this->buildtrees() / spec.name(); }
-    Path VcpkgPaths::build_dir(const std::string& package_name) const { return this->buildtrees() / package_name; }
+    Path VcpkgPaths::buildtrees_root(const PackageSpec& spec) const
+    {
+        if (auto compile_triplet = spec.compile_triplet().get())
+        {
+            return this->buildtrees() / "bin2sth_" / compile_triplet->canonical_name();
+        }
+
+        return this->buildtrees();
+    }
+    Path VcpkgPaths::build_dir(const PackageSpec& spec) const { return this->buildtrees_root(spec) / spec.name(); }
+    std::vector<Path> VcpkgPaths::build_dirs(const std::string& package_name) const
+    {
+        std::vector<Path> result{this->buildtrees() / package_name};
+        std::error_code ec;
+        for (auto&& variant_root : get_filesystem().get_directories_non_recursive(this->buildtrees() / "bin2sth_", ec))
+        {
+            auto variant_dir = variant_root / package_name;
+            if (get_filesystem().is_directory(variant_dir))
+            {
+                result.push_back(std::move(variant_dir));
+            }
+        }
+
+        return result;
+    }
 
     Path VcpkgPaths::build_info_file_path(const PackageSpec& spec) const
     {
@@ -708,6 +735,30 @@ namespace vcpkg
 
     Path VcpkgPaths::baselines_output() const { return buildtrees() / "versioning_" / "baselines"; }
     Path VcpkgPaths::versions_output() const { return buildtrees() / "versioning_" / "versions"; }
+    Path VcpkgPaths::compiled_versions_db() const { return buildtrees() / "versioning_" / "versions.db"; }
+
+    const CompiledVersionDb* VcpkgPaths::get_compiled_versions_db() const
+    {
+        const auto& maybe_db = m_pimpl->m_compiled_versions_db.get([this]() -> Optional<CompiledVersionDb> {
+            // without a database to load, don't spend a git invocation on its key
+            if (!this->maybe_buildtrees().has_value() ||
+                !get_filesystem().exists(this->compiled_versions_db(), IgnoreErrors{}))
+            {
+                return nullopt;
+            }
+
+            // the tree id is a key for everything in versions/, so a database compiled from the same tree is fresh
+            auto maybe_tree = this->git_builtin_registry_versions_tree();
+            if (auto tree = maybe_tree.get())
+            {
+                return try_load_compiled_versions_db(get_filesystem(), this->compiled_versions_db(), *tree);
+            }
+
+            Debug::print("Not using the compiled versions database: ", maybe_tree.error(), '\n');
+            return nullopt;
+        });
+        return maybe_db.get();
+    }
 
     Path InstalledPaths::listfile_path(const BinaryParagraph& pgh) const
     {
@@ -904,14 +955,19 @@ namespace vcpkg
     const std::map<std::string, CompilerInfo>& VcpkgPaths::get_available_compilers() const
     {
         return m_pimpl->available_compilers.get_lazy([this]() -> std::map<std::string, CompilerInfo> {
-            std::map<std::string, CompilerInfo> compilers;
             const Filesystem& fs = this->get_filesystem();
-            for (auto const& compiler_config_path :
-                 fs.get_regular_files_recursive(vcpkg_bin2sth_compiler_config_dir, VCPKG_LINE_INFO))
+            auto compilers = CompilerIndex::load(fs, vcpkg_bin2sth_compiler_index);
+            // compilers registered before the index existed have a config file each, and no fingerprint
+            if (fs.exists(vcpkg_bin2sth_compiler_config_dir, IgnoreErrors{}))
             {
-                auto compiler_info = CompilerInfo::load(fs, compiler_config_path);
-                compilers.emplace(compiler_info.nickname(), std::move(compiler_info));
+                for (auto const& compiler_config_path :
+                     fs.get_regular_files_recursive(vcpkg_bin2sth_compiler_config_dir, VCPKG_LINE_INFO))
+                {
+                    auto compiler_info = CompilerInfo::load(fs, compiler_config_path);
+                    compilers.emplace(compiler_info.nickname(), std::move(compiler_info));
+                }
             }
+
             return compilers;
         });
     }
@@ -1021,6 +1077,41 @@ namespace vcpkg
         }
     }
 
+    ExpectedS<std::string> VcpkgPaths::git_builtin_registry_versions_tree() const
+    {
+        const auto status_cmd = git_cmd_builder({}, {})
+                                    .string_arg("-C")
+                                    .path_arg(this->builtin_registry_versions)
+                                    .string_arg("status")
+                                    .string_arg("--porcelain")
+                                    .string_arg("--untracked-files=all")
+                                    .string_arg("--")
+                                    .string_arg(".");
+        auto status = cmd_execute_and_capture_output(status_cmd);
+        if (status.exit_code != 0)
+        {
+            return {std::move(status.output), expected_right_tag};
+        }
+
+        if (!Strings::trim(status.output).empty())
+        {
+            return {Strings::concat(this->builtin_registry_versions, " has uncommitted changes"), expected_right_tag};
+        }
+
+        const auto rev_parse_cmd = git_cmd_builder({}, {})
+                                       .string_arg("-C")
+                                       .path_arg(this->builtin_registry_versions)
+                                       .string_arg("rev-parse")
+                                       .string_arg("HEAD:./");
+        auto tree = cmd_execute_and_capture_output(rev_parse_cmd);
+        if (tree.exit_code != 0)
+        {
+            return {std::move(tree.output), expected_right_tag};
+        }
+
+        return {Strings::trim(std::move(tree.output)), expected_left_tag};
+    }
+
     ExpectedS<std::map<std::string, std::string, std::less<>>> VcpkgPaths::git_get_local_port_treeish_map() const
     {
         const auto local_repo = this->root / ".git";